@@ -0,0 +1,66 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Cancellation of asynchronous inference
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include "src/Layers/ILayer.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+/*
+ * @brief Stored in future of cancelled inference
+ */
+class CancelledException : public CNNException
+{
+	using CNNException::CNNException;
+};
+
+/*
+ * @brief Shared flag, caller keeps one copy and passes other to ConvolutionalNeuralNetwork::runAsync
+ */
+class CancellationToken
+{
+
+public:
+
+	CancellationToken()
+		: cancelled(std::make_shared<std::atomic<bool>>(false))
+	{
+	}
+
+
+	/*
+	 * @brief Requests cancellation of all runs using this token
+	 */
+	void cancel()
+	{
+		*cancelled = true;
+	}
+
+
+	/*
+	 * @brief Returns true if cancellation was requested
+	 */
+	bool isCancelled() const
+	{
+		return *cancelled;
+	}
+
+private:
+
+	/// Flag shared by all copies
+	std::shared_ptr<std::atomic<bool>> cancelled;
+
+};
+
+#endif
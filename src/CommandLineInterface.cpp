@@ -14,11 +14,29 @@
 #include "src/ConvolutionalNeuralNetwork.h"
 #include <src/Utils/Limits.h>
 #include "src/Utils/PersistenceMapper.h"
+#include "src/Utils/MemoryAllocator.h"
+#include "src/Utils/Profiler.h"
+#include "src/Utils/ThreadAffinity.h"
+#include "src/Utils/ThreadPool.h"
+#include "src/Server/InferenceServer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
 #include <iomanip>
 #include <regex>
 #include <sstream>
+#include <thread>
+
+/// Set by signal handler when server should stop
+static std::atomic<bool> stopRequested(false);
+
+static void requestStop(int)
+{
+	stopRequested = true;
+}
 
 /*
  * @brief Command line interfasce sets up argument parser
@@ -33,11 +51,19 @@ CommandLineInterface::CommandLineInterface()
 		("g,grayscale", "Specifies that we are working with grayscale PNG images.")
 		("type-info", "Shows info about types used.");
 	options.add_options("Inference")
-		("i,input", "Input PNG image for inference.", cxxopts::value<std::string>(), "FILE");
+		("i,input", "Input PNG image for inference.", cxxopts::value<std::string>(), "FILE")
+		("batch", "Dataset files for batch inference separated with space (labels are not needed).", cxxopts::value<std::vector<std::string>>(), "FILE(s)")
+		("predictions", "Output file for batch inference (default predictions.txt).", cxxopts::value<std::string>(), "FILE")
+		("serve", "Serves inference requests on given Unix domain socket until interrupted.", cxxopts::value<std::string>(), "SOCKET")
+		("workers", "Number of connections served concurrently (default number of cores).", cxxopts::value<unsigned>(), "UINT")
+		("max-batch", "Runs up to given number of concurrent requests together when serving.", cxxopts::value<unsigned>(), "UINT")
+		("max-delay", "Longest time request waits for others to form batch (default 500).", cxxopts::value<unsigned>(), "US");
 	options.add_options("Validation")
 		("v,validate", "Validation data files separated with space.", cxxopts::value<std::vector<std::string>>(), "FILE(s)")
 		("validate-offset", "Offset into validation data (how much to skip).", cxxopts::value<unsigned>(), "UINT")
-		("validate-num", "How much validation data to use, 0 == all.", cxxopts::value<unsigned>(), "UINT");
+		("validate-num", "How much validation data to use, 0 == all.", cxxopts::value<unsigned>(), "UINT")
+		("top-k", "Also reports how often expected class is among K highest outputs.", cxxopts::value<unsigned>(), "K")
+		("confusion-matrix", "Also prints confusion matrix of classification.");
 	options.add_options("Training")
 		("t,train", "Training data files separated with space.", cxxopts::value<std::vector<std::string>>(), "FILE(s)")
 		("train-offset", "Offset into training data (how much to skip).", cxxopts::value<unsigned>(), "UINT")
@@ -54,7 +80,17 @@ CommandLineInterface::CommandLineInterface()
 		("periodic-validation", "Runs validation before and after each epoch.")
 		("periodic-output", "Outputs average error of each X samples.", cxxopts::value<unsigned>(), "UINT")
 		("shuffle", "Shuffle training data before each epoch begins.")
-		("keep-best", "Saves trained network with highest validation accuracy during training.");	
+		("keep-best", "Saves trained network with highest validation accuracy during training.")
+		("checkpointing", "Keeps outputs only of some layers and recomputes the rest (xml|sqrt|KB of memory).", cxxopts::value<std::string>(), "TYPE")
+		("sampled-softmax", "Trains softmax with cross entropy only on expected class and given number of sampled classes.", cxxopts::value<unsigned>(), "UINT");
+	options.add_options("Performance")
+		("threads", "Number of worker threads of parallel runtime (default number of cores).", cxxopts::value<unsigned>(), "UINT")
+		("parallel-threshold", "Smallest work of layer (operations) split among threads (default 65536).", cxxopts::value<unsigned>(), "UINT")
+		("checked", "Runs layers with all input checks instead of compiled execution plan (debugging).")
+		("huge-pages", "Backs buffers of at least given size (at least 2 MB) with transparent huge pages.", cxxopts::value<unsigned>(), "KB")
+		("affinity", "Pins threads to given cores (e.g. 0,2,4-7).", cxxopts::value<std::string>(), "LIST")
+		("math", "Accuracy of exponential in sigmoid, tanh and softmax (exact|fast|fastest).", cxxopts::value<std::string>(), "TYPE")
+		("profile", "Reports run time, dTLB misses and huge page usage.");
 }
 
 
@@ -76,10 +112,24 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 	auto inference = false;
 	auto inputInferencePath = std::string();
 
+	auto batchInference = false;
+	auto batchFiles = std::vector<std::string>();
+	auto predictionsPath = std::string("predictions.txt");
+
+	auto serving = false;
+	auto socketPath = std::string();
+	auto workerNum = std::max(1u, std::thread::hardware_concurrency());
+	auto maxBatchSize = 1u;
+	auto maxDelay = 500u;
+
 	auto validation = false;
 	auto validationFiles = std::vector<std::string>();
 	auto validationOffset = 0u;
 	auto validationNum = 0u;
+	auto validationTopK = 0u;
+	auto validationConfusionMatrix = false;
+
+	auto checkedExecution = false;
 
 	auto training = false;
 	auto randomSeed = static_cast<unsigned>(time(nullptr));
@@ -99,7 +149,7 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 
 		if (args.count("help"))
 		{
-			std::cout << options.help({ "Common", "Inference", "Validation", "Training" }) << std::endl;
+			std::cout << options.help({ "Common", "Inference", "Validation", "Training", "Performance" }) << std::endl;
 			return EXIT_SUCCESS;
 		}
 
@@ -115,6 +165,49 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 			grayscale = true;
 		}
 
+		if (args.count("huge-pages"))
+		{
+			MemoryAllocator::enableHugePages(static_cast<size_t>(args["huge-pages"].as<unsigned>()) * 1024);
+			argcBackup -= 2; // do not include in checks later
+		}
+
+		if (args.count("threads"))
+		{
+			ThreadPool::setSharedThreadNum(args["threads"].as<unsigned>());
+			argcBackup -= 2;
+		}
+
+		if (args.count("parallel-threshold"))
+		{
+			ThreadPool::setParallelThreshold(args["parallel-threshold"].as<unsigned>());
+			argcBackup -= 2;
+		}
+
+		if (args.count("checked"))
+		{
+			checkedExecution = true;
+			argcBackup--;
+		}
+
+		if (args.count("affinity"))
+		{
+			ThreadAffinity::setAffinityMap(ThreadAffinity::parseAffinityMap(args["affinity"].as<std::string>()));
+			ThreadAffinity::pinCurrentThread(0);
+			argcBackup -= 2;
+		}
+
+		if (args.count("math"))
+		{
+			FastMath::setAccuracy(PersistenceMapper::getMathAccuracy(args["math"].as<std::string>()));
+			argcBackup -= 2;
+		}
+
+		if (args.count("profile"))
+		{
+			profile = true;
+			argcBackup--;
+		}
+
 		if (args.count("cnn"))
 		{
 			cnnPath = args["cnn"].as<std::string>();
@@ -137,6 +230,30 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 			}
 		}
 
+		if (args.count("batch"))
+		{
+			batchInference = true;
+			batchFiles = args["batch"].as<std::vector<std::string>>();
+
+			if (args.count("predictions"))
+				predictionsPath = args["predictions"].as<std::string>();
+		}
+
+		if (args.count("serve"))
+		{
+			serving = true;
+			socketPath = args["serve"].as<std::string>();
+
+			if (args.count("workers"))
+				workerNum = args["workers"].as<unsigned>();
+
+			if (args.count("max-batch"))
+				maxBatchSize = args["max-batch"].as<unsigned>();
+
+			if (args.count("max-delay"))
+				maxDelay = args["max-delay"].as<unsigned>();
+		}
+
 		if (args.count("train"))
 		{
 			training = true;
@@ -193,6 +310,23 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 				lossFunction = PersistenceMapper::getLossFunctionType(lossFunctionStr);
 			}
 
+			if (args.count("checkpointing"))
+			{
+				auto checkpointingStr = args["checkpointing"].as<std::string>();
+				if (std::regex_match(checkpointingStr, std::regex("[0-9]+")))
+				{
+					trainingSettings.checkpointing = CheckpointingStrategy::MemoryBudget;
+					trainingSettings.checkpointingMemoryBudget = static_cast<size_t>(std::stoull(checkpointingStr)) * 1024;
+				}
+				else
+				{
+					trainingSettings.checkpointing = PersistenceMapper::getCheckpointingStrategy(checkpointingStr);
+				}
+			}
+
+			if (args.count("sampled-softmax"))
+				trainingSettings.sampledClasses = args["sampled-softmax"].as<unsigned>();
+
 			if (!args.count("validate") && (args.count("validation-offset") || args.count("validation-num")))
 			{
 				errorWhenParsingArguments("Cannot set validation num/offset without setting validation files.");
@@ -221,14 +355,21 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 			if (args.count("validate-num"))
 				validationNum = args["validate-num"].as<unsigned>();
 
-			if (!training && (2 * args.count("validate-offset") + 2 * args.count("validate-num") + validationFiles.size() + 4) != argcBackup)
+			if (args.count("top-k"))
+				validationTopK = args["top-k"].as<unsigned>();
+
+			if (args.count("confusion-matrix"))
+				validationConfusionMatrix = true;
+
+			if (!training && (2 * args.count("validate-offset") + 2 * args.count("validate-num") + 2 * args.count("top-k") + args.count("confusion-matrix") 
+				+ validationFiles.size() + 4) != argcBackup)
 			{
 				errorWhenParsingArguments("Invalid combination of parameters for Validation mode.");
 				return EXIT_FAILURE;
 			}
 		}
 
-		if (!inference && !training && !validation) {
+		if (!inference && !batchInference && !serving && !training && !validation) {
 			errorWhenParsingArguments("No mode chosen. Choose either inference, training and/or validation.");
 			return EXIT_FAILURE;
 		}
@@ -237,6 +378,16 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 			errorWhenParsingArguments("Cannot run input mode along validation/training.");
 			return EXIT_FAILURE;
 		}
+		else if (batchInference && (inference || training || validation))
+		{
+			errorWhenParsingArguments("Cannot run batch inference along other modes.");
+			return EXIT_FAILURE;
+		}
+		else if (serving && (inference || batchInference || training || validation))
+		{
+			errorWhenParsingArguments("Cannot serve along other modes.");
+			return EXIT_FAILURE;
+		}
 	}
 	catch (const std::exception & e)
 	{
@@ -251,8 +402,13 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 	auto persistence = Persistence();
 	try
 	{
-		cnn = persistence.loadNetwork(cnnPath, loadWeights);
+		cnn = persistence.loadNetwork(cnnPath, loadWeights, !training);
 		cnn.enableOutput();
+		cnn.setValidationMetrics(validationTopK, validationConfusionMatrix);
+		for (const auto & rewrite : persistence.getAppliedRewrites())
+		{
+			std::cout << "Graph optimization: " << rewrite << std::endl;
+		}
 	}
 	catch (const PersistenceException & e)
 	{
@@ -261,18 +417,38 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 	}
 
 	// Run selected modes
+	Profiler profiler;
 	try
 	{
+		if (!checkedExecution)
+		{
+			cnn.compile();
+		}
+
+		auto exitCode = EXIT_SUCCESS;
 		if (inference)
 		{
-			return infere(inputInferencePath);
+			profiler.start();
+			exitCode = infere(inputInferencePath);
+		}
+		else if (batchInference)
+		{
+			auto batchInputs = parseInputImages(batchFiles, cnn.getInputSize());
+
+			profiler.start();
+			exitCode = infereBatch(batchInputs, predictionsPath);
+		}
+		else if (serving)
+		{
+			profiler.start();
+			exitCode = serve(socketPath, workerNum, maxBatchSize, maxDelay);
 		}
 		else
 		{
 			auto validationDataset = parseInputDataset(validationFiles, cnn.getInputSize(), cnn.getOutputSize(), validationOffset, validationNum);
 			auto trainingDataset = parseInputDataset(trainingFiles, cnn.getInputSize(), cnn.getOutputSize(), trainingOffset, trainingNum);
 			
-			auto exitCode = EXIT_SUCCESS;
+			profiler.start();
 			if (training)
 			{
 				exitCode = train(trainingDataset, trainingSettings, optimizer, lossFunction, validationDataset);
@@ -289,9 +465,15 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 					std::cerr << "Problems occured during training, skipping validation." << std::endl;
 				}
 			}
+		}
 
-			return exitCode;
+		if (profile)
+		{
+			profiler.stop();
+			profiler.printReport(std::cout);
 		}
+
+		return exitCode;
 	}
 	catch (const CNNException & e)
 	{
@@ -303,6 +485,11 @@ int CommandLineInterface::runWithGivenArguments(int argc, char ** argv)
 		std::cerr << "I/O exception: " << e.what() << std::endl;
 		return EXIT_FAILURE;
 	}
+	catch (const ServerException & e)
+	{
+		std::cerr << "Server exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
 	catch (const std::exception & e)
 	{
 		std::cerr << "Unknown exception: " << e.what() << std::endl;
@@ -326,6 +513,88 @@ int CommandLineInterface::infere(const std::string & inputPath)
 }
 
 
+/*
+ * @brief Inferes outputs of whole dataset and writes them into file (one line per input, 
+ *            predicted class is written first for classification)
+ */
+int CommandLineInterface::infereBatch(const std::vector<Image<ForwardType>> & inputs, const std::string & outputPath)
+{
+	if (inputs.empty())
+	{
+		std::cout << "No data to infere on, dataset empty." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	auto outputs = cnn.runBatch(inputs);
+	std::chrono::duration<float> diff = std::chrono::steady_clock::now() - start;
+
+	std::ofstream file(outputPath);
+	if (!file.is_open())
+	{
+		std::cerr << "Could not open file for predictions." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto rowSize = outputs.getWidth();
+	for (auto row = 0u; row < outputs.getHeight(); row++)
+	{
+		if (cnn.getTaskType() == TaskType::Classification)
+		{
+			file << std::max_element(&outputs(0, row), &outputs(0, row) + rowSize) - &outputs(0, row);
+		}
+
+		for (auto i = 0u; i < rowSize; i++)
+		{
+			file << ((i == 0 && cnn.getTaskType() != TaskType::Classification) ? "" : " ") << outputs(i, row);
+		}
+		file << "\n";
+	}
+
+	std::cout << "Inferred " << outputs.getHeight() << " inputs in " << diff.count() << " s (" 
+		<< outputs.getHeight() / diff.count() << " inputs/s)" << std::endl;
+
+	return EXIT_SUCCESS;
+}
+
+
+/*
+ * @brief Serves inference requests on Unix domain socket until SIGINT or SIGTERM is received
+ *            (requests are batched if maxBatchSize is greater than 1)
+ */
+int CommandLineInterface::serve(const std::string & socketPath, const unsigned workerNum, const unsigned maxBatchSize, const unsigned maxDelay)
+{
+	InferenceServer server(cnn, socketPath, workerNum, grayscale);
+	if (maxBatchSize > 1)
+	{
+		server.enableBatching(maxBatchSize, maxDelay);
+	}
+	server.start();
+
+	stopRequested = false;
+	std::signal(SIGINT, requestStop);
+	std::signal(SIGTERM, requestStop);
+
+	std::cout << "Serving on " << socketPath << " with " << workerNum << " workers, interrupt to stop." << std::endl;
+	while (!stopRequested)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	server.stop();
+	std::cout << "Served " << server.getServedRequestNum() << " requests." << std::endl;
+
+	if (server.getScheduler())
+	{
+		auto statistics = server.getScheduler()->getStatistics();
+		std::cout << "Ran " << statistics.completedRequestNum << " requests in " << statistics.batchNum << " batches, latency p50 "
+			<< statistics.p50Latency << " us, p99 " << statistics.p99Latency << " us." << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
 /*
  * @brief Trains Convolutional Neural Network on given set of training data
  */
@@ -413,6 +682,43 @@ DatasetType CommandLineInterface::parseInputDataset(const std::vector<std::strin
 }
 
 
+/*
+ * @brief Parses inputs for batch inference, labels are not needed (IDX labels file is not read, labels of TXT descriptor are optional
+ *            and label byte of each BIN record is ignored), images of all files are appended
+ */
+std::vector<Image<ForwardType>> CommandLineInterface::parseInputImages(const std::vector<std::string> & files, const Dimensions inputSize)
+{
+	auto inputs = std::vector<Image<ForwardType>>();
+
+	for (const auto & file : files)
+	{
+		auto images = std::vector<Image<ForwardType>>();
+
+		// Load data based on their format
+		if (std::regex_match(file.begin(), file.end(), std::regex(".+\\.[^\\.]*idx[^\\.]*$")))
+		{
+			images = IdxParser::parseImages(file);
+		}
+		else if (std::regex_match(file.begin(), file.end(), std::regex(".+\\.[^\\.]*bin[^\\.]*$")))
+		{
+			images = BinaryParser::parseImages(file, inputSize.width, inputSize.height, inputSize.depth);
+		}
+		else if (std::regex_match(file.begin(), file.end(), std::regex("^.+\\.txt$")))
+		{
+			images = PngParser::parseImages(file, grayscale);
+		}
+		else
+		{
+			std::cerr << "Input data file not detected as either BIN, IDX or TXT file (based on extension)." << std::endl;
+		}
+
+		inputs.insert(inputs.end(), images.begin(), images.end());
+	}
+
+	return inputs;
+}
+
+
 /*
  * @brief Dumps network to disk
  */
@@ -30,6 +30,10 @@ private:
 
 	int infere(const std::string & inputPath);
 
+	int infereBatch(const std::vector<Image<ForwardType>> & inputs, const std::string & outputPath);
+
+	int serve(const std::string & socketPath, const unsigned workerNum, const unsigned maxBatchSize, const unsigned maxDelay);
+
 
 	int train(DatasetType trainingData, TrainingSettings & trainingSettings, std::shared_ptr<IOptimizer> optimizer, 
 		const LossFunctionType & lossFunctionType, const DatasetType validationData = {});
@@ -39,6 +43,8 @@ private:
 	DatasetType parseInputDataset(const std::vector<std::string> & files, 
 		const Dimensions inputSize, const Dimensions outputSize, const unsigned offset, const  unsigned toLoad);
 
+	std::vector<Image<ForwardType>> parseInputImages(const std::vector<std::string> & files, const Dimensions inputSize);
+
 	int dumpNetworkToDisk();
 
 	void keepBestCallback(float epochAccuracy);
@@ -64,6 +70,9 @@ private:
 	/// Grayscale? (for when loading PNG files)
 	bool grayscale = false;
 
+	/// Report profile of selected modes?
+	bool profile = false;
+
 	/// Argument parser
 	cxxopts::Options options;
 
@@ -1,490 +1,1690 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Convolutional neural network instance
- */
-
-#include "src/ConvolutionalNeuralNetwork.h"
-
-#include <algorithm>
-#include <iostream>
-#include <iomanip>
-#include <chrono>
-
-/*
- * @brief Constructor, initializes task type
- *
- * @param taskType    Type of task to perform (classification|regression)
- */
-ConvolutionalNeuralNetwork::ConvolutionalNeuralNetwork(const TaskType & taskType /*= TaskType::Classification*/)
-	: taskType(taskType)
-{
-}
-
-
-/*
- * @brief Adds layer with ILayer interface
- *
- * @param layer   Pointer to layer to be added
- */
-void ConvolutionalNeuralNetwork::addLayer(const std::shared_ptr<ILayer<ForwardType, WeightType>> layer)
-{
-	if (allLayers.empty())
-	{
-		inputSize = layer->getInputSize();
-	}
-
-	if (!layer->useOnlyWhenLearning)
-	{
-		forwardOnlyLayers.push_back(layer);
-		forwardOnlyLayerNum++;
-	}
-
-	allLayers.push_back(layer);
-	allLayerNum++;
-
-	outputSize = layer->getOutputSize();
-}
-
-
-/*
- * @brief Runs the Convolutional Neural Network on single image
- *
- * @param  input    Input matrix with data
- *
- * @return output   Matrix with output
- * @throws CNNException if no layers were added
- */
-Image<ForwardType> ConvolutionalNeuralNetwork::run(const Image<ForwardType> & input)
-{
-	if (forwardOnlyLayers.empty())
-	{
-		throw CNNException("No layers to perform inference on.");
-	}
-
-	// Run image through all layers, emits layers used only for training (e.g. dropout layer)
-	for (auto i = 0u; i < forwardOnlyLayerNum; i++)
-	{
-		if (i == 0)
-		{
-			forwardOnlyLayers[i]->forwardPropagation(input, forwardOnlyLayers[i]->getOutput());
-		}
-		else
-		{
-			forwardOnlyLayers[i]->forwardPropagation(forwardOnlyLayers[i - 1]->getOutput(), forwardOnlyLayers[i]->getOutput());
-		}
-	}
-
-	// Output class if user wishes it
-	if (outputEnabled && !suppressOutput)
-	{
-		printResults(forwardOnlyLayers.back()->getOutput());
-	}
-
-	return forwardOnlyLayers.back()->getOutput();
-}
-
-
-/*
- * @brief Trains the Convolutional Neural Network with given settings on given dataset
- *
- * @param  settings       Training settings (batch size, number of epochs etc.)
- * @param  trainingData   Vector of pairs (input, expected output)
- * @param  lossFunction   Loss function to be used
- * @param  optimizer      Optimizer to be used
- * @param  validationData Validation data for periodic validation
- *
- * @return lastError      Error in last epoch
- * @throws CNNException if no data were passed or if no layers were added or if training produces NaN weights
- */
-float ConvolutionalNeuralNetwork::train(TrainingSettings & settings, std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & trainingData, 
-	const LossFunctionType & lossFunction, const std::shared_ptr<IOptimizer> optimizer, const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & validationData /*={}*/)
-{
-	if (trainingData.empty())
-	{
-		throw CNNException("No data to perform training on.");
-	}
-	else if (allLayers.empty())
-	{
-		throw CNNException("No layers to perform training on.");
-	}
-	
-	suppressOutput = true;
-	training = true;
-
-	// Initialize optimizers in layers
-	for (auto & layer : allLayers)
-	{
-		layer->setOptimizer(optimizer);
-		layer->initializeOptimizer();
-	}
-
-	auto start = std::chrono::system_clock::now();
-
-	// Validate before training if flag set
-	if (settings.periodicValidation && outputEnabled)
-	{
-		validate(validationData);
-		std::cout << std::endl;
-	}
-
-	auto trainingDataSize = trainingData.size();
-
-	// For each epoch iterate through all the data
-	auto epochError = 0.0f;
-	auto batchError = 0.0f;
-	for (auto epoch = 0u; epoch < settings.epochs; epoch++)
-	{
-		// Shuffle training dataset if chosen
-		if (settings.shuffle)
-		{
-			std::random_shuffle(trainingData.begin(), trainingData.end());
-		}
-		
-		epochError = 0.0f;
-		auto epochStart = std::chrono::system_clock::now();
-
-		// For each training case in each epoch compute error and update weights/filters
-		for (auto s = 0u; s < trainingDataSize; s++)
-		{
-			// Forward propagation
-			for (auto i = 0u; i < allLayerNum; i++)
-			{
-				if (i == 0)
-				{
-					allLayers[i]->forwardPropagation(trainingData[s].first, allLayers[i]->getOutput());
-				}
-				else
-				{
-					allLayers[i]->forwardPropagation(allLayers[i - 1]->getOutput(), allLayers[i]->getOutput());
-				}
-			}
-
-			// Compute error
-			auto errorResult = computeError(allLayers.back()->getOutput(), trainingData[s].second, lossFunction);
-
-			epochError += errorResult.first;
-			batchError += errorResult.first;
-			if (isnan(errorResult.first) || isinf(errorResult.first))
-			{
-				throw CNNException("Output error is NaN/INF, this may be caused by invalid choice of hyperparameters.");
-			}
-
-			// Periodically output average error if set
-			if (outputEnabled && settings.errorOutputRate > 0 && ((((s + 1) % settings.errorOutputRate) == 0) || (s + 1 == trainingDataSize)))
-			{
-				std::cout << "(" << s + 1 << "/" << trainingDataSize << "): " << batchError / settings.errorOutputRate << std::endl;
-				batchError = 0.0f;
-			}
-
-			// Backward propagation (learning)
-			for (auto i = static_cast<int>(allLayerNum - 1); i >= 0; i--)
-			{
-				if (i == static_cast<int>(allLayerNum - 1))
-				{
-					allLayers[i]->backwardPropagation(allLayers[i-1]->getOutput(), allLayers[i]->getOutput(), errorResult.second, allLayers[i]->getGradientOutput(), settings);
-				}
-				else if (i == 0)
-				{
-					allLayers[i]->backwardPropagation(trainingData[s].first, allLayers[i]->getOutput(), allLayers[i+1]->getGradientOutput(), allLayers[i]->getGradientOutput(), settings);
-				}
-				else
-				{
-					allLayers[i]->backwardPropagation(allLayers[i-1]->getOutput(), allLayers[i]->getOutput(), allLayers[i+1]->getGradientOutput(), allLayers[i]->getGradientOutput(), settings);
-				}
-			}
-		}
-
-		if (outputEnabled || onEpochFinishedCallback)
-		{
-			// Epoch length in seconds
-			auto epochEnd = std::chrono::system_clock::now();
-			std::chrono::duration<float> diff = epochEnd - epochStart;
-			auto epochLength = diff.count();
-
-			// Average error per training sample (with output if set)
-			auto epochAverageError = epochError / trainingDataSize;
-			if (outputEnabled && (((epoch + 1) % settings.epochOutputRate) == 0 || (epoch + 1) == settings.epochs))
-			{
-				std::cout << "Error in epoch " << epoch + 1 << ": " << epochAverageError << " (" << epochLength << " s)" << std::endl;
-			}
-			
-			// Validation accuracy if set (with output if set)
-			auto validationAccuracy = NAN;
-			if (settings.periodicValidation)
-			{
-				validationAccuracy = validate(validationData);
-				if (outputEnabled)
-				{
-					std::cout << std::endl;
-				}
-			}
-
-			// If callback set, call it (logging, lerning rate scheduling etc.)
-			if (onEpochFinishedCallback)
-			{
-				onEpochFinishedCallback(epoch + 1, settings, epochAverageError, validationAccuracy, epochLength);
-			}
-		}
-	}
-
-	// Output total training time if user wishes to see it
-	if (outputEnabled)
-	{
-		auto end = std::chrono::system_clock::now();
-		std::chrono::duration<float> diff = end - start;
-		std::cout << "Total training time: " << diff.count() << " s" << std::endl;
-	}
-
-	training = false;
-	suppressOutput = false;
-
-	return epochError;
-}
-
-
-/*
- * @brief Validates network on set of test data, returns accuracy in percents
- * 
- * @param  data        Data for validation
- *
- * @retrun accuracy    Accuracy (% for classification, average error for regression)
- * @throws CNNException if no validation data were passed
- */
-float ConvolutionalNeuralNetwork::validate(const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & data)
-{
-	suppressOutput = true;
-
-	if (data.empty())
-	{
-		throw CNNException("No data to perform validation on.");
-	}
-
-	auto totalCnt = data.size();
-	float outVal;
-	switch (taskType)
-	{
-		// Computes average absolute and relative error per sample
-		case TaskType::Regression:
-		{
-			auto avgAbsError = 0.0f;
-			auto avgRelError = 0.0f;
-
-			for (const auto & input : data)
-			{
-				auto output = run(input.first);
-				auto expected = input.second;
-				auto flattenedSize = output.getFlattenedSize();
-				
-				auto tmpAbsError = 0.0f;
-				auto tmpRelError = 0.0f;
-				for (auto i = 0u; i < flattenedSize; i++)
-				{
-					tmpAbsError += static_cast<float>(fabs(expected(i) - output(i)));
-					tmpRelError += static_cast<float>(fabs(expected(i) - output(i)) / std::max(fabs(expected(i)), fabs(output(i))));
-				}
-				avgAbsError += tmpAbsError / flattenedSize;
-				avgRelError += tmpRelError / flattenedSize;
-			}
-
-			if (outputEnabled)
-			{
-				std::cout << "Average absolute error per sample: " << avgAbsError / totalCnt << std::endl;
-				std::cout << "Average relative difference per sample: " << avgRelError / totalCnt << " %" << std::endl;
-			}
-
-			outVal = avgRelError / totalCnt;
-			break;
-		}
-		// Computes how many inputs were classified correctly
-		case TaskType::Classification: default:
-		{
-			auto correctCnt = 0u;
-
-			for (const auto & input : data)
-			{
-				auto output = run(input.first).getImageAsVector();
-				auto expected = input.second.getImageAsVector();
-
-				auto outClass = std::max_element(output.begin(), output.end());
-				auto expClass = std::max_element(expected.begin(), expected.end());
-
-				if ((outClass - output.begin()) == (expClass - expected.begin()))
-				{
-					correctCnt++;
-				}
-			}
-
-			auto successRate = static_cast<float>(correctCnt) / totalCnt * 100.0f;
-
-			if (outputEnabled)
-			{
-				std::cout << "Succesfully classified " << correctCnt << " out of " << totalCnt << std::endl;
-				std::cout << "\tSuccess rate: " << successRate << " %" << std::endl;
-				std::cout << "\tError   rate: " << (static_cast<float>(totalCnt - correctCnt) / totalCnt * 100.0f)  << " %" << std::endl;
-			}
-
-			outVal = successRate;
-			break;
-		}
-	}
-
-	suppressOutput = false;
-	return outVal;
-}
-
-
-/*
- * @brief Print results of run
- */
-void ConvolutionalNeuralNetwork::printResults(const Image<ForwardType> & output) const
-{
-	switch (taskType)
-	{
-		// Predicting values of continous functions
-		case TaskType::Regression:
-		{
-			auto vectorOutput = output.getImageAsVector();
-			for (const auto & val : vectorOutput)
-			{
-				std::cout << std::fixed << std::setprecision(5) << val << " ";
-			}
-			break;
-		}
-		// Predicting class of input (does not support multiclass classification)
-		case TaskType::Classification: default:
-		{
-			auto vectorOutput = output.getImageAsVector();
-
-			auto outClass = std::max_element(vectorOutput.begin(), vectorOutput.end());
-			for (const auto & val : vectorOutput)
-			{
-				std::cout << std::fixed << std::setprecision(3) << val << " ";
-			}
-
-			std::cout << "\nOutput class is " << outClass - vectorOutput.begin() << "\n" << std::endl;
-			break;
-		}
-	}
-}
-
-
-/*
- * @brief Computes total error and elso error vector for output layer
- */
-std::pair<BackwardType, Image<BackwardType>> ConvolutionalNeuralNetwork::computeError(const Image<ForwardType> & actualOutput, 
-	const Image<ForwardType> & expectedOutput, const LossFunctionType & lossFunctionType) const
-{
-	static auto epsilon = Limits::getEpsilonValue<BackwardType>(); // to avoid zero division or log(0)
-	static auto ONE = static_cast<BackwardType>(1.0f); // shortcut
-
-	auto flattenedSize = actualOutput.getFlattenedSize();
-	Image<BackwardType> errorVector(actualOutput.getDimensions());
-	auto error = static_cast<BackwardType>(0.0f);
-	switch (lossFunctionType)
-	{
-		// For regression tasks and outputs different than <0,1>
-		// Virtually any activation function may be used in last layer (depends on your task, you dont want SoftMax for Regression as it wont work etc.)
-		case LossFunctionType::MeanSquaredError: default:
-		{
-			for (auto i = 0u; i < flattenedSize; i++)
-			{
-				auto actual = static_cast<BackwardType>(actualOutput(i));
-				auto expected = static_cast<BackwardType>(expectedOutput(i));
-
-				auto diff = (actual - expected);
-				errorVector(i) = static_cast<BackwardType>(2) * diff / static_cast<BackwardType>(static_cast<float>(flattenedSize));
-
-				error += diff * diff / static_cast<BackwardType>(static_cast<float>(flattenedSize));
-			}
-			break;
-		}
-		// For classification tasks with more than two classes, requires output in range <0, +INF> - use SoftMax, Sigmoid or ReLU in last layer
-		// However only SoftMax is recommended as it is suited for this loss function
-		// Sigmoid is not an ideal fit and will diverge soon, ReLU will not throw NaN, but will just not converge (it is not in <0,1> range)
-		case LossFunctionType::CrossEntropy:
-		{
-			for (auto i = 0u; i < flattenedSize; i++)
-			{
-				auto actual = static_cast<BackwardType>(actualOutput(i));
-				auto expected = static_cast<BackwardType>(expectedOutput(i));
-
-				errorVector(i) = -expected / (actual + epsilon);
-
-				error += -expected * static_cast<BackwardType>(log(actual + epsilon));
-			}
-			break;
-		}
-		// For classification tasks with two classes, requires output in range <0, 1> - use SoftMax or Sigmoid in last layer
-		// However only Sigmoid is recommended here (as SoftMax computes probabilities and does not expect multiple independent classifications)
-		case LossFunctionType::BinaryCrossEntropy:
-		{
-			for (auto i = 0u; i < flattenedSize; i++)
-			{
-				auto actual = static_cast<BackwardType>(actualOutput(i));
-				auto expected = static_cast<BackwardType>(expectedOutput(i));
-
-				errorVector(i) = (actual - expected) / (actual * (ONE - actual) + epsilon);
-
-				error += (-expected) * static_cast<BackwardType>(log(actual + epsilon)) - ((ONE - expected) * static_cast<BackwardType>(log(ONE - actual + epsilon)));
-			}
-			break;
-		}
-	}
-
-	return std::make_pair(error, errorVector);
-}
-
-
-/*
- * @brief Set on epoch finished callback
- */
-void ConvolutionalNeuralNetwork::setOnEpochFinishedCallback(OnEpochFinishedCallbackType callback)
-{
-	onEpochFinishedCallback = std::move(callback);
-}
-
-
-/*
- * @brief Enables output to std::cout
- */
-void ConvolutionalNeuralNetwork::enableOutput()
-{
-	outputEnabled = true;
-}
-
-
-/*
- * @brief Disables output
- */
-void ConvolutionalNeuralNetwork::disableOutput()
-{
-	outputEnabled = false;
-}
-
-
-/*
- * @brief Returns type of task this CNN is intended for
- */
-TaskType ConvolutionalNeuralNetwork::getTaskType() const
-{
-	return taskType;
-}
-
-
-/*
- * @brief Returns expected input dimensions
- */
-Dimensions ConvolutionalNeuralNetwork::getInputSize() const
-{
-	return inputSize;
-}
-
-
-/*
- * @brief Returns output dimensions
- */
-Dimensions ConvolutionalNeuralNetwork::getOutputSize() const
-{
-	return outputSize;
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Convolutional neural network instance
+ */
+
+#include "src/ConvolutionalNeuralNetwork.h"
+
+#include "src/Layers/FusedLayer.h"
+#include "src/Utils/GraphOptimizer.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/*
+ * @brief Returns generation never returned before (shared by all networks, so that contexts of other networks are recognized)
+ */
+static uint64_t createGeneration()
+{
+	static std::atomic<uint64_t> lastGeneration{ 0 };
+	return ++lastGeneration;
+}
+
+
+/*
+ * @brief Constructor, initializes task type
+ *
+ * @param taskType    Type of task to perform (classification|regression)
+ */
+ConvolutionalNeuralNetwork::ConvolutionalNeuralNetwork(const TaskType & taskType /*= TaskType::Classification*/)
+	: taskType(taskType)
+	, asyncState(std::make_shared<AsyncState>())
+{
+}
+
+
+/*
+ * @brief Waits for asynchronous runs, they use layers of this network
+ */
+ConvolutionalNeuralNetwork::~ConvolutionalNeuralNetwork()
+{
+	if (asyncState)
+	{
+		std::unique_lock<std::mutex> lock(asyncState->mutex);
+		asyncState->finished.wait(lock, [this]() { return asyncState->inFlight == 0; });
+	}
+}
+
+
+/*
+ * @brief Adds layer with ILayer interface
+ *
+ * @param layer   Pointer to layer to be added
+ */
+void ConvolutionalNeuralNetwork::addLayer(const std::shared_ptr<ILayer<ForwardType, WeightType>> layer)
+{
+	if (allLayers.empty())
+	{
+		inputSize = layer->getInputSize();
+	}
+	else
+	{
+		enableInPlaceExecution(layer);
+	}
+
+	if (!layer->useOnlyWhenLearning)
+	{
+		forwardOnlyLayers.push_back(layer);
+		forwardOnlyLayerNum++;
+	}
+
+	if (inferenceOnly)
+	{
+		layer->releaseTrainingState();
+	}
+
+	allLayers.push_back(layer);
+	allLayerNum++;
+
+	// Plan has to be compiled again, existing contexts are not valid anymore
+	compiledPlan.clear();
+	layersGeneration = createGeneration();
+	planGeneration = layersGeneration;
+
+	outputSize = layer->getOutputSize();
+
+	// Layers running in place write their gradients directly into gradients of the following layer
+	for (auto i = static_cast<int>(allLayerNum) - 2; i >= 0 && allLayers[i]->runsInPlace; i--)
+	{
+		allLayers[i]->getGradientOutput().shareWith(allLayers[i + 1]->getGradientOutput());
+	}
+}
+
+
+/*
+ * @brief Validates shapes of all layers used during inference once and lets each layer select its kernel,
+ *            execution contexts created afterwards run flat plan of kernels without further checks
+ *            (contexts of network that was not compiled run checked propagation of layers, useful for debugging)
+ *
+ * Convolutional and fully connected layers may be fused with following activation and pooling, fused layers
+ * write only final result. Training still runs separate layers, so gradients are not affected.
+ *
+ * Layers of network used only for inference are rewritten by GraphOptimizer first (batch normalization is folded
+ * into previous layer etc.). Execution contexts holding previous plan or created for replaced layers are rejected by run.
+ *
+ * @param fuseLayers   Fuses layers where possible
+ *
+ * @throws CNNException if no layers were added or if input of some layer does not match output of previous layer
+ */
+void ConvolutionalNeuralNetwork::compile(const bool fuseLayers /*= true*/)
+{
+	if (forwardOnlyLayers.empty())
+	{
+		throw CNNException("No layers to compile.");
+	}
+
+	compiledPlan.clear();
+	planGeneration = createGeneration();
+	for (auto i = 1u; i < forwardOnlyLayerNum; i++)
+	{
+		if (forwardOnlyLayers[i]->getInputSize() != forwardOnlyLayers[i - 1]->getOutputSize())
+		{
+			throw CNNException("Input of layer " + std::to_string(i + 1) + " does not match output of previous layer.");
+		}
+	}
+
+	if (inferenceOnly)
+	{
+		GraphOptimizer optimizer;
+		auto layers = optimizer.optimize(allLayers);
+		if (!optimizer.getAppliedRewrites().empty())
+		{
+			replaceLayers(layers);
+		}
+	}
+
+	for (auto i = 0u; i < forwardOnlyLayerNum; i++)
+	{
+		auto fused = (fuseLayers) ? FusedLayer<ForwardType, WeightType>::tryFusing(forwardOnlyLayers, i) : nullptr;
+		if (fused)
+		{
+			compiledPlan.push_back({ fused->compileKernel(), fused, i + fused->getFusedLayerNum() - 1 });
+			i = compiledPlan.back().lastLayer;
+		}
+		else
+		{
+			compiledPlan.push_back({ forwardOnlyLayers[i]->compileKernel(), forwardOnlyLayers[i], i });
+		}
+	}
+
+	// Contexts holding previous plan refer to its layers, contexts still in use are dropped when they are released
+	std::lock_guard<std::mutex> lock(asyncState->mutex);
+	planGeneration = createGeneration();
+	asyncState->freeContexts.clear();
+}
+
+
+/*
+ * @brief Replaces all layers with given ones (layers that ran in place get own output, in place execution is chosen again)
+ */
+void ConvolutionalNeuralNetwork::replaceLayers(const std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> & layers)
+{
+	allLayers.clear();
+	forwardOnlyLayers.clear();
+	allLayerNum = 0;
+	forwardOnlyLayerNum = 0;
+
+	for (const auto & layer : layers)
+	{
+		if (layer->runsInPlace)
+		{
+			layer->getOutput() = Image<ForwardType>(layer->getOutputSize());
+			layer->runsInPlace = false;
+		}
+
+		addLayer(layer);
+	}
+}
+
+
+/*
+ * @brief Returns true if network was compiled into execution plan
+ */
+bool ConvolutionalNeuralNetwork::isCompiled() const
+{
+	return !compiledPlan.empty();
+}
+
+
+/*
+ * @brief Lets elementwise layer overwrite output of previous layer if nothing else needs it
+ *
+ * @param layer   Layer that is being added
+ */
+void ConvolutionalNeuralNetwork::enableInPlaceExecution(const std::shared_ptr<ILayer<ForwardType, WeightType>> & layer)
+{
+	const auto & producer = allLayers.back();
+
+	if (!layer->supportsInPlace() || producer->needsOutputForBackward() || producer->getOutputSize() != layer->getInputSize())
+	{
+		return;
+	}
+
+	layer->getOutput().shareWith(producer->getOutput());
+	layer->runsInPlace = true;
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on single image
+ *
+ * @param  input    Input matrix with data
+ *
+ * @return output   Matrix with output
+ * @throws CNNException if no layers were added
+ */
+Image<ForwardType> ConvolutionalNeuralNetwork::run(const Image<ForwardType> & input)
+{
+	if (forwardOnlyLayers.empty())
+	{
+		throw CNNException("No layers to perform inference on.");
+	}
+
+	// Run image through all layers, emits layers used only for training (e.g. dropout layer)
+	for (auto i = 0u; i < forwardOnlyLayerNum; i++)
+	{
+		if (i == 0)
+		{
+			forwardOnlyLayers[i]->forwardPropagation(input, forwardOnlyLayers[i]->getOutput());
+		}
+		else
+		{
+			forwardOnlyLayers[i]->forwardPropagation(forwardOnlyLayers[i - 1]->getOutput(), forwardOnlyLayers[i]->getOutput());
+		}
+	}
+
+	// Output class if user wishes it
+	if (outputEnabled && !suppressOutput)
+	{
+		printResults(forwardOnlyLayers.back()->getOutput());
+	}
+
+	return forwardOnlyLayers.back()->getOutput();
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on single image using buffers of given context,
+ *            network is not modified, so it may be called concurrently with different contexts
+ *
+ * @param  context  Execution context created by this network (owned by calling thread)
+ * @param  input    Input matrix with data
+ *
+ * @return output   Matrix with output (valid until context is used again)
+ * @throws CNNException if no layers were added or if context was not created for current layers and plan of this network
+ */
+const Image<ForwardType> & ConvolutionalNeuralNetwork::run(ExecutionContext & context, const Image<ForwardType> & input) const
+{
+	if (forwardOnlyLayers.empty())
+	{
+		throw CNNException("No layers to perform inference on.");
+	}
+	else if (!isCurrent(context))
+	{
+		throw CNNException("Execution context was not created for this network or network was changed since.");
+	}
+
+	// Shapes of layers were validated by compilation, only input of the first one is checked
+	if (!context.plan.empty())
+	{
+		if (input.getDimensions() != inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input of network has different dimensions than its first layer.");
+		}
+
+		const auto & first = context.plan.front();
+		first.kernel(*first.layer, input, *first.output);
+		for (auto step = context.plan.begin() + 1; step != context.plan.end(); ++step)
+		{
+			step->kernel(*step->layer, *step->input, *step->output);
+		}
+
+		return context.outputs.back();
+	}
+
+	for (auto i = 0u; i < forwardOnlyLayerNum; i++)
+	{
+		const auto & in = (i == 0) ? input : context.outputs[i - 1];
+		forwardOnlyLayers[i]->inferencePropagation(in, context.outputs[i]);
+	}
+
+	return context.outputs.back();
+}
+
+
+/*
+ * @brief Creates buffers for inference in separate thread, elementwise layers write into output of previous layer
+ *            and layers fused with following ones get no buffer
+ *
+ * @return context  Execution context to be used with this network
+ */
+ExecutionContext ConvolutionalNeuralNetwork::createExecutionContext() const
+{
+	ExecutionContext context;
+	context.outputs.resize(forwardOnlyLayerNum);
+	context.generation = compiledPlan.empty() ? layersGeneration : planGeneration;
+
+	// Outputs of layers fused with following ones are never written
+	std::vector<bool> fused(forwardOnlyLayerNum, false);
+	for (auto step = 0u, first = 0u; step < compiledPlan.size(); first = compiledPlan[step++].lastLayer + 1)
+	{
+		for (auto i = first; i < compiledPlan[step].lastLayer; i++)
+		{
+			fused[i] = true;
+		}
+	}
+
+	for (auto i = 0u; i < forwardOnlyLayerNum; i++)
+	{
+		const auto & layer = forwardOnlyLayers[i];
+		if (fused[i])
+		{
+			continue;
+		}
+		else if (i > 0 && !fused[i - 1] && layer->supportsInPlace() && layer->getInputSize() == forwardOnlyLayers[i - 1]->getOutputSize())
+		{
+			context.outputs[i].shareWith(context.outputs[i - 1]);
+		}
+		else
+		{
+			context.outputs[i].shareWith(Image<ForwardType>(layer->getOutputSize()));
+			context.byteSize += context.outputs[i].getFlattenedSize() * sizeof(ForwardType);
+		}
+	}
+
+	// Bind buffers to steps of compiled plan
+	for (auto step = 0u, first = 0u; step < compiledPlan.size(); first = compiledPlan[step++].lastLayer + 1)
+	{
+		const auto & compiled = compiledPlan[step];
+		context.plan.push_back({ compiled.kernel, compiled.layer.get(), (first == 0) ? nullptr : &context.outputs[first - 1], &context.outputs[compiled.lastLayer] });
+	}
+
+	return context;
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on all given inputs, inputs are split among workers of shared thread pool
+ *
+ * @param  inputs   Input matrices
+ *
+ * @return outputs  Matrix with flattened output of each input in one row (width == output size, height == input count)
+ * @throws CNNException if no layers were added
+ */
+Image<ForwardType> ConvolutionalNeuralNetwork::runBatch(const std::vector<Image<ForwardType>> & inputs) const
+{
+	auto rowSize = outputSize.width * outputSize.height * outputSize.depth;
+	Image<ForwardType> outputs(Dimensions{ rowSize, static_cast<unsigned>(inputs.size()), 1 });
+
+	ThreadPool::getShared().parallelFor(0, inputs.size(), 1, [this, &inputs, &outputs, rowSize](size_t first, size_t last)
+	{
+		auto context = acquireContext();
+		for (auto row = first; row < last; row++)
+		{
+			const auto & output = run(context, inputs[row]);
+			std::copy(&output(0), &output(0) + rowSize, &outputs(0, static_cast<unsigned>(row)));
+		}
+		releaseContext(std::move(context));
+	});
+
+	return outputs;
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on all given inputs using buffers of given context
+ *            (callers running many batches reuse the same buffers)
+ *
+ * @param  context  Execution context created by this network (owned by calling thread)
+ * @param  inputs   Input matrices
+ *
+ * @return outputs  Matrix with flattened output of each input in one row (width == output size, height == input count)
+ * @throws CNNException if no layers were added or if context was not created for this network
+ */
+Image<ForwardType> ConvolutionalNeuralNetwork::runBatch(ExecutionContext & context, const std::vector<Image<ForwardType>> & inputs) const
+{
+	auto rowSize = outputSize.width * outputSize.height * outputSize.depth;
+	Image<ForwardType> outputs(Dimensions{ rowSize, static_cast<unsigned>(inputs.size()), 1 });
+
+	for (auto row = 0u; row < inputs.size(); row++)
+	{
+		const auto & output = run(context, inputs[row]);
+		std::copy(&output(0), &output(0) + rowSize, &outputs(0, row));
+	}
+
+	return outputs;
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on stream of inputs
+ *
+ * @param  nextInput  Fills next input and returns true, returns false when there are no more inputs
+ *
+ * @return outputs    Matrix with flattened output of each input in one row (width == output size, height == input count)
+ * @throws CNNException if no layers were added
+ */
+Image<ForwardType> ConvolutionalNeuralNetwork::runBatch(const std::function<bool(Image<ForwardType> &)> & nextInput) const
+{
+	auto context = createExecutionContext();
+	auto rowSize = outputSize.width * outputSize.height * outputSize.depth;
+	std::vector<ForwardType> rows;
+
+	Image<ForwardType> input;
+	while (nextInput(input))
+	{
+		const auto & output = run(context, input);
+		rows.insert(rows.end(), &output(0), &output(0) + rowSize);
+	}
+
+	Image<ForwardType> outputs(Dimensions{ rowSize, static_cast<unsigned>(rows.size() / rowSize), 1 });
+	std::copy(rows.begin(), rows.end(), &outputs(0));
+
+	return outputs;
+}
+
+
+/*
+ * @brief Runs the Convolutional Neural Network on single image in shared thread pool
+ *
+ * Waits if maximum number of runs is already in flight (must not be called from tasks of shared pool then).
+ * Runs cancelled before they start or before they finish store CancelledException into future.
+ *
+ * @param  input    Input matrix with data (copied)
+ * @param  token    Token that may be used to cancel the run
+ *
+ * @return future   Output of network or exception thrown by the run
+ * @throws CNNException if no layers were added
+ */
+std::future<Image<ForwardType>> ConvolutionalNeuralNetwork::runAsync(const Image<ForwardType> & input, const CancellationToken & token /*= CancellationToken()*/) const
+{
+	if (forwardOnlyLayers.empty())
+	{
+		throw CNNException("No layers to perform inference on.");
+	}
+
+	auto & pool = ThreadPool::getShared();
+	auto state = asyncState;
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(lock, [&state, &pool]()
+		{
+			return state->inFlight < ((state->maxInFlight != 0) ? state->maxInFlight : 4 * pool.getThreadNum());
+		});
+		state->inFlight++;
+	}
+
+	auto result = std::make_shared<std::promise<Image<ForwardType>>>();
+	auto future = result->get_future();
+
+	Image<ForwardType> inputCopy;
+	inputCopy = input;
+
+	pool.enqueue([this, state, result, inputCopy, token]()
+	{
+		try
+		{
+			if (token.isCancelled())
+			{
+				throw CancelledException("Run was cancelled before it started.");
+			}
+
+			auto context = acquireContext();
+			Image<ForwardType> output;
+			output = run(context, inputCopy);
+			releaseContext(std::move(context));
+
+			if (token.isCancelled())
+			{
+				throw CancelledException("Run was cancelled.");
+			}
+
+			result->set_value(output);
+		}
+		catch (...)
+		{
+			result->set_exception(std::current_exception());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->inFlight--;
+		}
+		state->finished.notify_all();
+	});
+
+	return future;
+}
+
+
+/*
+ * @brief Sets largest number of asynchronous runs in flight (bounds memory held by queued inputs),
+ *            0 == four runs per worker of shared pool
+ */
+void ConvolutionalNeuralNetwork::setMaxInFlight(const unsigned maxInFlight)
+{
+	{
+		std::lock_guard<std::mutex> lock(asyncState->mutex);
+		asyncState->maxInFlight = maxInFlight;
+	}
+	asyncState->finished.notify_all();
+}
+
+
+/*
+ * @brief Returns number of asynchronous runs submitted and not yet finished
+ */
+unsigned ConvolutionalNeuralNetwork::getInFlight() const
+{
+	std::lock_guard<std::mutex> lock(asyncState->mutex);
+	return asyncState->inFlight;
+}
+
+
+/*
+ * @brief Returns true if context was created for current layers of this network and holds its current plan (if any),
+ *            contexts without plan remain valid when network is compiled without changing its layers
+ */
+bool ConvolutionalNeuralNetwork::isCurrent(const ExecutionContext & context) const
+{
+	return context.generation == (context.plan.empty() ? layersGeneration : planGeneration);
+}
+
+
+/*
+ * @brief Takes unused execution context of this network or creates new one
+ */
+ExecutionContext ConvolutionalNeuralNetwork::acquireContext() const
+{
+	{
+		std::lock_guard<std::mutex> lock(asyncState->mutex);
+		if (!asyncState->freeContexts.empty())
+		{
+			auto context = std::move(asyncState->freeContexts.back());
+			asyncState->freeContexts.pop_back();
+			return context;
+		}
+	}
+
+	return createExecutionContext();
+}
+
+
+/*
+ * @brief Returns execution context taken by acquireContext, so that it can be reused
+ *            (context created before network was changed or compiled again is dropped)
+ */
+void ConvolutionalNeuralNetwork::releaseContext(ExecutionContext && context) const
+{
+	std::lock_guard<std::mutex> lock(asyncState->mutex);
+	if (isCurrent(context))
+	{
+		asyncState->freeContexts.push_back(std::move(context));
+	}
+}
+
+
+/*
+ * @brief Trains the Convolutional Neural Network with given settings on given dataset
+ *
+ * @param  settings       Training settings (batch size, number of epochs etc.)
+ * @param  trainingData   Vector of pairs (input, expected output)
+ * @param  lossFunction   Loss function to be used
+ * @param  optimizer      Optimizer to be used
+ * @param  validationData Validation data for periodic validation
+ *
+ * @return lastError      Error in last epoch
+ * @throws CNNException if no data were passed or if no layers were added or if training produces NaN weights
+ *                      or if network (or some of its layers) was set up for inference only
+ */
+float ConvolutionalNeuralNetwork::train(TrainingSettings & settings, std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & trainingData, 
+	const LossFunctionType & lossFunction, const std::shared_ptr<IOptimizer> optimizer, const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & validationData /*={}*/)
+{
+	if (trainingData.empty())
+	{
+		throw CNNException("No data to perform training on.");
+	}
+	else if (allLayers.empty())
+	{
+		throw CNNException("No layers to perform training on.");
+	}
+	else if (inferenceOnly)
+	{
+		throw CNNException("Network was set up for inference only and cannot be trained.");
+	}
+
+	for (auto i = 0u; i < allLayerNum; i++)
+	{
+		if (!allLayers[i]->hasTrainingState())
+		{
+			throw CNNException("Layer " + std::to_string(i + 1) + " was created for inference only and cannot be trained.");
+		}
+	}
+	
+	suppressOutput = true;
+	training = true;
+
+	// Initialize optimizers in layers
+	for (auto & layer : allLayers)
+	{
+		layer->setOptimizer(optimizer);
+		layer->initializeOptimizer();
+	}
+
+	// Choose layers whose outputs are kept, the rest is recomputed during backward propagation
+	planCheckpoints(settings);
+
+	// Softmax followed by cross entropy (or sigmoid followed by binary cross entropy) is differentiated as a whole
+	outputFusedWithLoss = fusesOutputLayerWithLoss(lossFunction);
+	prepareSampledSoftmax(settings, lossFunction);
+
+	auto start = std::chrono::system_clock::now();
+
+	// Validate before training if flag set
+	if (settings.periodicValidation && outputEnabled)
+	{
+		validate(validationData);
+		std::cout << std::endl;
+	}
+
+	auto trainingDataSize = trainingData.size();
+
+	// For each epoch iterate through all the data
+	auto epochError = 0.0f;
+	auto batchError = 0.0f;
+	for (auto epoch = 0u; epoch < settings.epochs; epoch++)
+	{
+		// Shuffle training dataset if chosen
+		if (settings.shuffle)
+		{
+			std::random_shuffle(trainingData.begin(), trainingData.end());
+		}
+		
+		epochError = 0.0f;
+		auto epochStart = std::chrono::system_clock::now();
+
+		// For each training case in each epoch compute error and update weights/filters
+		for (auto s = 0u; s < trainingDataSize; s++)
+		{
+			// Forward propagation
+			forwardPass(trainingData[s].first);
+
+			// Compute error
+			auto errorResult = sampledLayer
+				? computeSampledError(trainingData[s].first, trainingData[s].second, settings)
+				: outputFusedWithLoss 
+					? computeFusedError(allLayers.back()->getOutput(), trainingData[s].second, lossFunction)
+					: computeError(allLayers.back()->getOutput(), trainingData[s].second, lossFunction);
+
+			epochError += errorResult.first;
+			batchError += errorResult.first;
+			if (std::isnan(errorResult.first) || std::isinf(errorResult.first))
+			{
+				throw CNNException("Output error is NaN/INF, this may be caused by invalid choice of hyperparameters.");
+			}
+
+			// Periodically output average error if set
+			if (outputEnabled && settings.errorOutputRate > 0 && ((((s + 1) % settings.errorOutputRate) == 0) || (s + 1 == trainingDataSize)))
+			{
+				std::cout << "(" << s + 1 << "/" << trainingDataSize << "): " << batchError / settings.errorOutputRate << std::endl;
+				batchError = 0.0f;
+			}
+
+			// Backward propagation (learning)
+			backwardPass(trainingData[s].first, errorResult.second, settings);
+		}
+
+		// Outputs released by gradient checkpointing are needed for validation and inference
+		materializeOutputs();
+
+		if (outputEnabled || onEpochFinishedCallback)
+		{
+			// Epoch length in seconds
+			auto epochEnd = std::chrono::system_clock::now();
+			std::chrono::duration<float> diff = epochEnd - epochStart;
+			auto epochLength = diff.count();
+
+			// Average error per training sample (with output if set)
+			auto epochAverageError = epochError / trainingDataSize;
+			if (outputEnabled && (((epoch + 1) % settings.epochOutputRate) == 0 || (epoch + 1) == settings.epochs))
+			{
+				std::cout << "Error in epoch " << epoch + 1 << ": " << epochAverageError << " (" << epochLength << " s)" << std::endl;
+			}
+			
+			// Validation accuracy if set (with output if set)
+			auto validationAccuracy = NAN;
+			if (settings.periodicValidation)
+			{
+				validationAccuracy = validate(validationData);
+				if (outputEnabled)
+				{
+					std::cout << std::endl;
+				}
+			}
+
+			// If callback set, call it (logging, lerning rate scheduling etc.)
+			if (onEpochFinishedCallback)
+			{
+				onEpochFinishedCallback(epoch + 1, settings, epochAverageError, validationAccuracy, epochLength);
+			}
+		}
+	}
+
+	// Output total training time if user wishes to see it
+	if (outputEnabled)
+	{
+		if (!checkpoints.empty())
+		{
+			const auto & stats = checkpointingStatistics;
+			std::cout << "Gradient checkpointing kept outputs of " << stats.checkpointNum << " out of " << stats.layerNum << " layers" << std::endl;
+			std::cout << "\tPeak memory of layer outputs: " << stats.peakActivationBytes / 1024 << " kB (" 
+				<< stats.fullActivationBytes / 1024 << " kB without checkpointing)" << std::endl;
+			std::cout << "\tRecomputed layers per sample: " << stats.recomputedLayerNum << " (+" 
+				<< std::setprecision(1) << std::fixed << 100.0f * stats.recomputedLayerNum / stats.layerNum << " % forward propagations, " 
+				<< std::setprecision(3) << stats.recomputationTime << " s)" << std::defaultfloat << std::endl;
+		}
+
+		auto end = std::chrono::system_clock::now();
+		std::chrono::duration<float> diff = end - start;
+		std::cout << "Total training time: " << diff.count() << " s" << std::endl;
+	}
+
+	training = false;
+	outputFusedWithLoss = false;
+	sampledLayer = nullptr;
+	suppressOutput = false;
+
+	return epochError;
+}
+
+
+/*
+ * @brief Forward propagates output of previous layer (or input) through layer with given index
+ */
+void ConvolutionalNeuralNetwork::forwardLayer(const unsigned index, const Image<ForwardType> & input)
+{
+	const auto & in = (index == 0) ? input : allLayers[index - 1]->getOutput();
+
+	allLayers[index]->trainingPropagation(in, allLayers[index]->getOutput());
+}
+
+
+/*
+ * @brief Backward propagates gradients of next layer (or error) through layer with given index
+ */
+void ConvolutionalNeuralNetwork::backwardLayer(const unsigned index, const Image<ForwardType> & input, 
+	const Image<BackwardType> & errorGradients, const TrainingSettings & settings)
+{
+	const auto & in = (index == 0) ? input : allLayers[index - 1]->getOutput();
+	const auto & gradients = (static_cast<int>(index) == getLastBackwardLayer()) ? errorGradients : allLayers[index + 1]->getGradientOutput();
+
+	// With sampled softmax only outputs of sampled classes were computed and have gradients
+	if (sampledLayer && index == allLayerNum - 2)
+	{
+		sampledLayer->backwardPropagationOfNeurons(in, sampledClasses, gradients, sampledLayer->getGradientOutput(), settings);
+		return;
+	}
+
+	allLayers[index]->backwardPropagation(in, allLayers[index]->getOutput(), gradients, allLayers[index]->getGradientOutput(), settings);
+}
+
+
+/*
+ * @brief Forward propagates training sample through all layers, with gradient checkpointing only outputs
+ *            of checkpoints and of last segment are kept afterwards
+ */
+void ConvolutionalNeuralNetwork::forwardPass(const Image<ForwardType> & input)
+{
+	// With sampled softmax fully connected layer and softmax compute only sampled classes later
+	const auto layerNum = sampledLayer ? allLayerNum - 2 : allLayerNum;
+	for (auto i = 0u; i < layerNum; i++)
+	{
+		if (checkpoints.empty())
+		{
+			forwardLayer(i, input);
+			continue;
+		}
+
+		materializeOutput(i);
+		forwardLayer(i, input);
+
+		// Output of previous layer was consumed, it will be recomputed when its segment is back propagated
+		if (i > 0 && !checkpoints[i - 1] && i - 1 < lastSegmentStart)
+		{
+			allLayers[i - 1]->getOutput().release();
+		}
+	}
+}
+
+
+/*
+ * @brief Backward propagates error through all layers, with gradient checkpointing each segment
+ *            (layers after a checkpoint up to next checkpoint) is forward propagated again first
+ */
+void ConvolutionalNeuralNetwork::backwardPass(const Image<ForwardType> & input, const Image<BackwardType> & errorGradients, const TrainingSettings & settings)
+{
+	if (checkpoints.empty())
+	{
+		for (auto i = getLastBackwardLayer(); i >= 0; i--)
+		{
+			backwardLayer(i, input, errorGradients, settings);
+		}
+		return;
+	}
+
+	auto segmentEnd = static_cast<int>(allLayerNum - 1);
+	while (segmentEnd >= 0)
+	{
+		// Segment starts after previous checkpoint, all layers before its end were released
+		auto segmentStart = segmentEnd;
+		while (segmentStart > 0 && !checkpoints[segmentStart - 1])
+		{
+			segmentStart--;
+		}
+
+		auto recompute = segmentEnd != static_cast<int>(allLayerNum - 1);
+		if (recompute)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (auto i = segmentStart; i < segmentEnd; i++)
+			{
+				materializeOutput(i);
+				forwardLayer(i, input);
+			}
+			std::chrono::duration<float> diff = std::chrono::steady_clock::now() - start;
+			checkpointingStatistics.recomputationTime += diff.count();
+		}
+
+		for (auto i = std::min(segmentEnd, getLastBackwardLayer()); i >= segmentStart; i--)
+		{
+			backwardLayer(i, input, errorGradients, settings);
+		}
+
+		if (recompute)
+		{
+			for (auto i = segmentStart; i < segmentEnd; i++)
+			{
+				allLayers[i]->getOutput().release();
+			}
+		}
+
+		segmentEnd = segmentStart - 1;
+	}
+}
+
+
+/*
+ * @brief Chooses checkpoints according to training settings and estimates memory and compute trade-off
+ *
+ *        Layer followed by layers running in place over its output forms a chain sharing one buffer,
+ *        chains are kept or recomputed as a whole. Last chain and chains with layers that cannot be
+ *        recomputed (dropout) are always kept. Outputs of a segment between two checkpoints are alive
+ *        only while the segment is back propagated, so peak memory is given by kept outputs and the
+ *        largest segment.
+ */
+void ConvolutionalNeuralNetwork::planCheckpoints(const TrainingSettings & settings)
+{
+	checkpoints.clear();
+	checkpointingStatistics = CheckpointingStatistics{};
+	checkpointingStatistics.layerNum = allLayerNum;
+
+	// Split layers into chains sharing output buffer
+	std::vector<unsigned> chainStarts;
+	std::vector<size_t> chainBytes;
+	std::vector<bool> forced;
+	std::vector<bool> marked;
+	for (auto i = 0u; i < allLayerNum; i++)
+	{
+		const auto & layer = allLayers[i];
+		if (i == 0 || !layer->runsInPlace)
+		{
+			auto size = layer->getOutputSize();
+			chainStarts.push_back(i);
+			chainBytes.push_back(static_cast<size_t>(size.width) * size.height * size.depth * sizeof(ForwardType));
+			forced.push_back(false);
+			marked.push_back(false);
+		}
+
+		forced.back() = forced.back() || !layer->supportsRecomputation();
+		marked.back() = marked.back() || layer->isCheckpoint;
+	}
+	forced.back() = true;
+
+	auto chainNum = static_cast<unsigned>(chainStarts.size());
+	for (const auto & bytes : chainBytes)
+	{
+		checkpointingStatistics.fullActivationBytes += bytes;
+	}
+
+	// Peak memory and number of recomputed layers of given placement
+	auto chainLayerNum = [&](unsigned chain)
+	{
+		return ((chain + 1 < chainNum) ? chainStarts[chain + 1] : allLayerNum) - chainStarts[chain];
+	};
+	auto evaluate = [&](const std::vector<bool> & kept, size_t & peak, unsigned & recomputed)
+	{
+		size_t keptBytes = 0;
+		size_t segmentBytes = 0;
+		size_t largestSegment = 0;
+		auto segmentLayers = 0u;
+		recomputed = 0;
+		for (auto chain = 0u; chain < chainNum; chain++)
+		{
+			if (kept[chain])
+			{
+				keptBytes += chainBytes[chain];
+				largestSegment = std::max(largestSegment, segmentBytes);
+				segmentBytes = 0;
+
+				// Last segment is not recomputed as its outputs are still available after forward propagation
+				if (chain + 1 < chainNum)
+				{
+					recomputed += segmentLayers;
+				}
+				segmentLayers = 0;
+			}
+			else
+			{
+				segmentBytes += chainBytes[chain];
+				segmentLayers += chainLayerNum(chain);
+			}
+		}
+		peak = keptBytes + largestSegment;
+	};
+
+	std::vector<bool> kept(forced);
+	switch (settings.checkpointing)
+	{
+		case CheckpointingStrategy::Explicit: default:
+		{
+			if (std::find(marked.begin(), marked.end(), true) == marked.end())
+			{
+				return;
+			}
+			for (auto chain = 0u; chain < chainNum; chain++)
+			{
+				kept[chain] = kept[chain] || marked[chain];
+			}
+			break;
+		}
+		case CheckpointingStrategy::SquareRoot:
+		{
+			auto step = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(chainNum))));
+			for (auto chain = 0u; chain < chainNum; chain++)
+			{
+				kept[chain] = kept[chain] || ((chain + 1) % step == 0);
+			}
+			break;
+		}
+		case CheckpointingStrategy::MemoryBudget:
+		{
+			// Greedily close segments that would exceed limit, try limits given by all possible segments
+			std::vector<size_t> limits;
+			for (auto first = 0u; first < chainNum; first++)
+			{
+				size_t bytes = 0;
+				for (auto last = first; last < chainNum; last++)
+				{
+					bytes += chainBytes[last];
+					limits.push_back(bytes);
+				}
+			}
+
+			// Keeping everything is used if nothing better is found
+			kept.assign(chainNum, true);
+			size_t bestPeak;
+			unsigned bestRecomputed;
+			evaluate(kept, bestPeak, bestRecomputed);
+			auto bestFits = bestPeak <= settings.checkpointingMemoryBudget;
+			for (const auto & limit : limits)
+			{
+				std::vector<bool> candidate(forced);
+				size_t segmentBytes = 0;
+				for (auto chain = 0u; chain < chainNum; chain++)
+				{
+					if (!candidate[chain] && segmentBytes + chainBytes[chain] > limit)
+					{
+						candidate[chain] = true;
+					}
+					segmentBytes = candidate[chain] ? 0 : segmentBytes + chainBytes[chain];
+				}
+
+				size_t peak;
+				unsigned recomputed;
+				evaluate(candidate, peak, recomputed);
+
+				// Prefer least recomputation within budget, otherwise the lowest peak
+				auto fits = peak <= settings.checkpointingMemoryBudget;
+				auto better = (fits && !bestFits)
+					|| (fits && (recomputed < bestRecomputed || (recomputed == bestRecomputed && peak < bestPeak)))
+					|| (!fits && !bestFits && peak < bestPeak);
+				if (better)
+				{
+					kept = candidate;
+					bestFits = fits;
+					bestPeak = peak;
+					bestRecomputed = recomputed;
+				}
+			}
+			break;
+		}
+	}
+
+	// Nothing to recompute, all outputs are kept
+	if (std::find(kept.begin(), kept.end(), false) == kept.end())
+	{
+		return;
+	}
+
+	evaluate(kept, checkpointingStatistics.peakActivationBytes, checkpointingStatistics.recomputedLayerNum);
+
+	checkpoints.assign(allLayerNum, true);
+	for (auto chain = 0u; chain < chainNum; chain++)
+	{
+		if (kept[chain])
+		{
+			checkpointingStatistics.checkpointNum += chainLayerNum(chain);
+		}
+		else
+		{
+			for (auto i = chainStarts[chain]; i < chainStarts[chain] + chainLayerNum(chain); i++)
+			{
+				checkpoints[i] = false;
+			}
+		}
+	}
+
+	// Layers after last checkpoint preceding last layer are kept after forward propagation
+	lastSegmentStart = allLayerNum - 1;
+	while (lastSegmentStart > 0 && !checkpoints[lastSegmentStart - 1])
+	{
+		lastSegmentStart--;
+	}
+}
+
+
+/*
+ * @brief Allocates output of layer released by gradient checkpointing (layer running in place shares output of previous layer)
+ */
+void ConvolutionalNeuralNetwork::materializeOutput(const unsigned index)
+{
+	auto & output = allLayers[index]->getOutput();
+	if (output.getFlattenedSize() != 0)
+	{
+		return;
+	}
+
+	if (allLayers[index]->runsInPlace)
+	{
+		output.shareWith(allLayers[index - 1]->getOutput());
+	}
+	else
+	{
+		output.shareWith(Image<ForwardType>(allLayers[index]->getOutputSize()));
+	}
+}
+
+
+/*
+ * @brief Allocates all outputs released by gradient checkpointing
+ */
+void ConvolutionalNeuralNetwork::materializeOutputs()
+{
+	if (checkpoints.empty())
+	{
+		return;
+	}
+
+	for (auto i = 0u; i < allLayerNum; i++)
+	{
+		materializeOutput(i);
+	}
+}
+
+
+/*
+ * @brief Validates network on set of test data, returns accuracy in percents
+ *
+ * Samples are split among workers of shared thread pool, each sample stores its result into preallocated slot
+ * and results are summed in order of samples, so accuracy does not depend on number of threads.
+ * 
+ * @param  data        Data for validation
+ *
+ * @retrun accuracy    Accuracy (% for classification, average error for regression)
+ * @throws CNNException if no validation data were passed
+ */
+float ConvolutionalNeuralNetwork::validate(const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & data)
+{
+	if (data.empty())
+	{
+		throw CNNException("No data to perform validation on.");
+	}
+
+	auto totalCnt = data.size();
+	float outVal;
+	switch (taskType)
+	{
+		// Computes average absolute and relative error per sample
+		case TaskType::Regression:
+		{
+			std::vector<float> absErrors(totalCnt);
+			std::vector<float> relErrors(totalCnt);
+
+			ThreadPool::getShared().parallelFor(0, totalCnt, 1, [this, &data, &absErrors, &relErrors](size_t first, size_t last)
+			{
+				auto context = acquireContext();
+				for (auto s = first; s < last; s++)
+				{
+					const auto & output = run(context, data[s].first);
+					const auto & expected = data[s].second;
+					auto flattenedSize = output.getFlattenedSize();
+
+					auto tmpAbsError = 0.0f;
+					auto tmpRelError = 0.0f;
+					for (auto i = 0u; i < flattenedSize; i++)
+					{
+						tmpAbsError += static_cast<float>(fabs(expected(i) - output(i)));
+						tmpRelError += static_cast<float>(fabs(expected(i) - output(i)) / std::max(fabs(expected(i)), fabs(output(i))));
+					}
+					absErrors[s] = tmpAbsError / flattenedSize;
+					relErrors[s] = tmpRelError / flattenedSize;
+				}
+				releaseContext(std::move(context));
+			});
+
+			auto avgAbsError = 0.0f;
+			auto avgRelError = 0.0f;
+			for (auto s = 0u; s < totalCnt; s++)
+			{
+				avgAbsError += absErrors[s];
+				avgRelError += relErrors[s];
+			}
+
+			if (outputEnabled)
+			{
+				std::cout << "Average absolute error per sample: " << avgAbsError / totalCnt << std::endl;
+				std::cout << "Average relative difference per sample: " << avgRelError / totalCnt << " %" << std::endl;
+			}
+
+			outVal = avgRelError / totalCnt;
+			break;
+		}
+		// Computes how many inputs were classified correctly
+		case TaskType::Classification: default:
+		{
+			// Expected and predicted class and rank of expected class among outputs of each sample
+			std::vector<unsigned> expectedClasses(totalCnt);
+			std::vector<unsigned> predictedClasses(totalCnt);
+			std::vector<unsigned> expectedRanks(totalCnt);
+
+			ThreadPool::getShared().parallelFor(0, totalCnt, 1, [this, &data, &expectedClasses, &predictedClasses, &expectedRanks](size_t first, size_t last)
+			{
+				auto context = acquireContext();
+				for (auto s = first; s < last; s++)
+				{
+					const auto & output = run(context, data[s].first);
+					const auto & expected = data[s].second;
+					auto flattenedSize = output.getFlattenedSize();
+
+					// First maximum wins, same as std::max_element
+					auto outClass = 0u;
+					auto expClass = 0u;
+					for (auto i = 1u; i < flattenedSize; i++)
+					{
+						if (output(outClass) < output(i))
+						{
+							outClass = i;
+						}
+						if (expected(expClass) < expected(i))
+						{
+							expClass = i;
+						}
+					}
+
+					// Outputs ordered before expected class (ties are broken by index like above)
+					auto rank = 0u;
+					for (auto i = 0u; i < flattenedSize; i++)
+					{
+						if (output(expClass) < output(i) || (i < expClass && !(output(i) < output(expClass))))
+						{
+							rank++;
+						}
+					}
+
+					expectedClasses[s] = expClass;
+					predictedClasses[s] = outClass;
+					expectedRanks[s] = rank;
+				}
+				releaseContext(std::move(context));
+			});
+
+			validationStatistics = {};
+			validationStatistics.sampleNum = static_cast<unsigned>(totalCnt);
+			validationStatistics.topK = validationTopK;
+			validationStatistics.classNum = outputSize.width * outputSize.height * outputSize.depth;
+			if (validationConfusionMatrix)
+			{
+				validationStatistics.confusionMatrix.assign(validationStatistics.classNum * validationStatistics.classNum, 0);
+			}
+
+			for (auto s = 0u; s < totalCnt; s++)
+			{
+				if (predictedClasses[s] == expectedClasses[s])
+				{
+					validationStatistics.correctNum++;
+				}
+				if (expectedRanks[s] < validationTopK)
+				{
+					validationStatistics.topKCorrectNum++;
+				}
+				if (validationConfusionMatrix)
+				{
+					validationStatistics.confusionMatrix[expectedClasses[s] * validationStatistics.classNum + predictedClasses[s]]++;
+				}
+			}
+
+			auto correctCnt = validationStatistics.correctNum;
+			auto successRate = static_cast<float>(correctCnt) / totalCnt * 100.0f;
+
+			if (outputEnabled)
+			{
+				std::cout << "Succesfully classified " << correctCnt << " out of " << totalCnt << std::endl;
+				std::cout << "\tSuccess rate: " << successRate << " %" << std::endl;
+				std::cout << "\tError   rate: " << (static_cast<float>(totalCnt - correctCnt) / totalCnt * 100.0f)  << " %" << std::endl;
+
+				if (validationTopK > 0)
+				{
+					std::cout << "\tTop-" << validationTopK << " rate: " << (static_cast<float>(validationStatistics.topKCorrectNum) / totalCnt * 100.0f) << " %" << std::endl;
+				}
+				if (validationConfusionMatrix)
+				{
+					printConfusionMatrix();
+				}
+			}
+
+			outVal = successRate;
+			break;
+		}
+	}
+
+	return outVal;
+}
+
+
+/*
+ * @brief Sets which metrics are computed by validation of classification network besides accuracy
+ *
+ * @param topK             Also counts samples whose expected class is among topK highest outputs (0 == disabled)
+ * @param confusionMatrix  Also computes confusion matrix
+ */
+void ConvolutionalNeuralNetwork::setValidationMetrics(const unsigned topK, const bool confusionMatrix)
+{
+	validationTopK = topK;
+	validationConfusionMatrix = confusionMatrix;
+}
+
+
+/*
+ * @brief Returns results of last validation of classification network
+ */
+ValidationStatistics ConvolutionalNeuralNetwork::getValidationStatistics() const
+{
+	return validationStatistics;
+}
+
+
+/*
+ * @brief Prints confusion matrix of last validation (rows are expected classes, columns predicted classes)
+ */
+void ConvolutionalNeuralNetwork::printConfusionMatrix() const
+{
+	const auto & matrix = validationStatistics.confusionMatrix;
+	auto classNum = validationStatistics.classNum;
+	auto width = static_cast<int>(std::to_string(std::max(classNum, *std::max_element(matrix.begin(), matrix.end()))).size()) + 1;
+
+	std::cout << "Confusion matrix (rows expected, columns predicted):" << std::endl;
+	std::cout << std::setw(width) << "";
+	for (auto column = 0u; column < classNum; column++)
+	{
+		std::cout << std::setw(width) << column;
+	}
+	std::cout << std::endl;
+
+	for (auto row = 0u; row < classNum; row++)
+	{
+		std::cout << std::setw(width) << row;
+		for (auto column = 0u; column < classNum; column++)
+		{
+			std::cout << std::setw(width) << matrix[row * classNum + column];
+		}
+		std::cout << std::endl;
+	}
+}
+
+
+/*
+ * @brief Print results of run
+ */
+void ConvolutionalNeuralNetwork::printResults(const Image<ForwardType> & output) const
+{
+	switch (taskType)
+	{
+		// Predicting values of continous functions
+		case TaskType::Regression:
+		{
+			auto vectorOutput = output.getImageAsVector();
+			for (const auto & val : vectorOutput)
+			{
+				std::cout << std::fixed << std::setprecision(5) << val << " ";
+			}
+			break;
+		}
+		// Predicting class of input (does not support multiclass classification)
+		case TaskType::Classification: default:
+		{
+			auto vectorOutput = output.getImageAsVector();
+
+			auto outClass = std::max_element(vectorOutput.begin(), vectorOutput.end());
+			for (const auto & val : vectorOutput)
+			{
+				std::cout << std::fixed << std::setprecision(3) << val << " ";
+			}
+
+			std::cout << "\nOutput class is " << outClass - vectorOutput.begin() << "\n" << std::endl;
+			break;
+		}
+	}
+}
+
+
+/*
+ * @brief Computes total error and elso error vector for output layer
+ */
+std::pair<BackwardType, Image<BackwardType>> ConvolutionalNeuralNetwork::computeError(const Image<ForwardType> & actualOutput, 
+	const Image<ForwardType> & expectedOutput, const LossFunctionType & lossFunctionType) const
+{
+	static auto epsilon = Limits::getEpsilonValue<BackwardType>(); // to avoid zero division or log(0)
+	static auto ONE = static_cast<BackwardType>(1.0f); // shortcut
+
+	auto flattenedSize = actualOutput.getFlattenedSize();
+	Image<BackwardType> errorVector(actualOutput.getDimensions());
+	auto error = static_cast<BackwardType>(0.0f);
+	switch (lossFunctionType)
+	{
+		// For regression tasks and outputs different than <0,1>
+		// Virtually any activation function may be used in last layer (depends on your task, you dont want SoftMax for Regression as it wont work etc.)
+		case LossFunctionType::MeanSquaredError: default:
+		{
+			for (auto i = 0u; i < flattenedSize; i++)
+			{
+				auto actual = static_cast<BackwardType>(actualOutput(i));
+				auto expected = static_cast<BackwardType>(expectedOutput(i));
+
+				auto diff = (actual - expected);
+				errorVector(i) = static_cast<BackwardType>(2) * diff / static_cast<BackwardType>(static_cast<float>(flattenedSize));
+
+				error += diff * diff / static_cast<BackwardType>(static_cast<float>(flattenedSize));
+			}
+			break;
+		}
+		// For classification tasks with more than two classes, requires output in range <0, +INF> - use SoftMax, Sigmoid or ReLU in last layer
+		// However only SoftMax is recommended as it is suited for this loss function
+		// Sigmoid is not an ideal fit and will diverge soon, ReLU will not throw NaN, but will just not converge (it is not in <0,1> range)
+		case LossFunctionType::CrossEntropy:
+		{
+			for (auto i = 0u; i < flattenedSize; i++)
+			{
+				auto actual = static_cast<BackwardType>(actualOutput(i));
+				auto expected = static_cast<BackwardType>(expectedOutput(i));
+
+				errorVector(i) = -expected / (actual + epsilon);
+
+				error += -expected * static_cast<BackwardType>(log(actual + epsilon));
+			}
+			break;
+		}
+		// For classification tasks with two classes, requires output in range <0, 1> - use SoftMax or Sigmoid in last layer
+		// However only Sigmoid is recommended here (as SoftMax computes probabilities and does not expect multiple independent classifications)
+		case LossFunctionType::BinaryCrossEntropy:
+		{
+			for (auto i = 0u; i < flattenedSize; i++)
+			{
+				auto actual = static_cast<BackwardType>(actualOutput(i));
+				auto expected = static_cast<BackwardType>(expectedOutput(i));
+
+				errorVector(i) = (actual - expected) / (actual * (ONE - actual) + epsilon);
+
+				error += (-expected) * static_cast<BackwardType>(log(actual + epsilon)) - ((ONE - expected) * static_cast<BackwardType>(log(ONE - actual + epsilon)));
+			}
+			break;
+		}
+	}
+
+	return std::make_pair(error, errorVector);
+}
+
+
+/*
+ * @brief Returns true if output layer and loss function have joint gradient (softmax with cross entropy,
+ *        sigmoid with binary cross entropy)
+ */
+bool ConvolutionalNeuralNetwork::fusesOutputLayerWithLoss(const LossFunctionType & lossFunctionType) const
+{
+	if (allLayers.empty())
+	{
+		return false;
+	}
+
+	switch (lossFunctionType)
+	{
+		case LossFunctionType::CrossEntropy:
+			return dynamic_cast<SoftMax *>(allLayers.back().get()) != nullptr;
+		case LossFunctionType::BinaryCrossEntropy:
+			return dynamic_cast<Sigmoid *>(allLayers.back().get()) != nullptr;
+		case LossFunctionType::MeanSquaredError: default:
+			return false;
+	}
+}
+
+
+/*
+ * @brief Computes total error (same as computeError) and error vector for input of output layer fused with loss function
+ *
+ *        Jacobian of output layer is not needed, gradient is softmax * sum(expected) - expected for cross entropy
+ *        (softmax - expected for one-hot expected output) and sigmoid - expected for binary cross entropy.
+ */
+std::pair<BackwardType, Image<BackwardType>> ConvolutionalNeuralNetwork::computeFusedError(const Image<ForwardType> & actualOutput, 
+	const Image<ForwardType> & expectedOutput, const LossFunctionType & lossFunctionType) const
+{
+	static auto epsilon = Limits::getEpsilonValue<BackwardType>(); // to avoid log(0)
+	static auto ONE = static_cast<BackwardType>(1.0f); // shortcut
+
+	auto flattenedSize = actualOutput.getFlattenedSize();
+	Image<BackwardType> errorVector(actualOutput.getDimensions());
+	auto error = static_cast<BackwardType>(0.0f);
+	if (lossFunctionType == LossFunctionType::CrossEntropy)
+	{
+		auto expectedSum = static_cast<BackwardType>(0.0f);
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			expectedSum += static_cast<BackwardType>(expectedOutput(i));
+		}
+
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			auto actual = static_cast<BackwardType>(actualOutput(i));
+			auto expected = static_cast<BackwardType>(expectedOutput(i));
+
+			errorVector(i) = actual * expectedSum - expected;
+
+			error += -expected * static_cast<BackwardType>(log(actual + epsilon));
+		}
+	}
+	else
+	{
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			auto actual = static_cast<BackwardType>(actualOutput(i));
+			auto expected = static_cast<BackwardType>(expectedOutput(i));
+
+			errorVector(i) = actual - expected;
+
+			error += (-expected) * static_cast<BackwardType>(log(actual + epsilon)) - ((ONE - expected) * static_cast<BackwardType>(log(ONE - actual + epsilon)));
+		}
+	}
+
+	return std::make_pair(error, errorVector);
+}
+
+
+/*
+ * @brief Chooses fully connected layer computing sampled classes if sampled softmax is requested
+ *
+ * @throws CNNException if network does not end with fully connected layer and softmax trained with cross entropy
+ */
+void ConvolutionalNeuralNetwork::prepareSampledSoftmax(const TrainingSettings & settings, const LossFunctionType & lossFunctionType)
+{
+	sampledLayer = nullptr;
+	if (settings.sampledClasses == 0)
+	{
+		return;
+	}
+
+	auto fullyConnected = (allLayerNum >= 2) ? dynamic_cast<FullyConnected *>(allLayers[allLayerNum - 2].get()) : nullptr;
+	if (!fullyConnected || !outputFusedWithLoss || lossFunctionType != LossFunctionType::CrossEntropy)
+	{
+		throw CNNException("Sampled softmax requires network ending with fully connected layer and softmax trained with cross entropy.");
+	}
+
+	// Full softmax is cheaper if (almost) all classes would be sampled
+	const auto classes = fullyConnected->getOutputSize();
+	const auto classNum = classes.width * classes.height * classes.depth;
+	if (settings.sampledClasses + 1 >= classNum)
+	{
+		return;
+	}
+
+	sampledLayer = fullyConnected;
+	sampledClasses.reserve(settings.sampledClasses + 1);
+	classSampled.assign(classNum, false);
+	sampleGenerator.seed(static_cast<unsigned>(rand()));
+}
+
+
+/*
+ * @brief Computes error of softmax over expected class and sampled classes and gradients for their outputs
+ *            of fully connected layer (sampled softmax)
+ *
+ *        Other classes are sampled uniformly without replacement. K sampled classes stand for all N - 1 other
+ *        classes, so log((N - 1) / K) (logarithm of inverse probability of being sampled) is added to their outputs
+ *        and softmax over corrected outputs estimates full softmax of expected class. The expected class is
+ *        the one with highest expected output.
+ */
+std::pair<BackwardType, Image<BackwardType>> ConvolutionalNeuralNetwork::computeSampledError(const Image<ForwardType> & input, 
+	const Image<ForwardType> & expectedOutput, const TrainingSettings & settings)
+{
+	static auto epsilon = Limits::getEpsilonValue<BackwardType>(); // to avoid log(0)
+
+	const auto classNum = expectedOutput.getFlattenedSize();
+	auto expectedClass = 0u;
+	for (auto i = 1u; i < classNum; i++)
+	{
+		if (expectedOutput(i) > expectedOutput(expectedClass))
+		{
+			expectedClass = i;
+		}
+	}
+
+	// Sample distinct classes other than expected one
+	sampledClasses.clear();
+	sampledClasses.push_back(expectedClass);
+	classSampled[expectedClass] = true;
+	std::uniform_int_distribution<unsigned> distribution(0, classNum - 1);
+	while (sampledClasses.size() <= settings.sampledClasses)
+	{
+		auto sampledClass = distribution(sampleGenerator);
+		if (!classSampled[sampledClass])
+		{
+			classSampled[sampledClass] = true;
+			sampledClasses.push_back(sampledClass);
+		}
+	}
+	for (auto sampledClass : sampledClasses)
+	{
+		classSampled[sampledClass] = false;
+	}
+
+	// Outputs of sampled classes
+	const auto sampledNum = static_cast<unsigned>(sampledClasses.size());
+	const auto & in = (allLayerNum == 2) ? input : allLayers[allLayerNum - 3]->getOutput();
+	Image<BackwardType> errorVector(Dimensions{ sampledNum, 1, 1 });
+	sampledLayer->multiplyNeurons(in, sampledClasses, errorVector);
+
+	const auto correction = static_cast<BackwardType>(std::log(static_cast<float>(classNum - 1) / static_cast<float>(settings.sampledClasses)));
+	auto maximum = errorVector(0);
+	for (auto i = 1u; i < sampledNum; i++)
+	{
+		errorVector(i) += correction;
+		maximum = std::max(maximum, errorVector(i));
+	}
+
+	// Softmax over corrected outputs, gradient of cross entropy is softmax - expected (expected class is first)
+	auto sum = static_cast<BackwardType>(0.0f);
+	for (auto i = 0u; i < sampledNum; i++)
+	{
+		errorVector(i) = static_cast<BackwardType>(std::exp(errorVector(i) - maximum));
+		sum += errorVector(i);
+	}
+	for (auto i = 0u; i < sampledNum; i++)
+	{
+		errorVector(i) /= sum;
+	}
+
+	auto error = -static_cast<BackwardType>(log(errorVector(0) + epsilon));
+	errorVector(0) -= static_cast<BackwardType>(1.0f);
+
+	return std::make_pair(error, errorVector);
+}
+
+
+/*
+ * @brief Returns index of last back propagated layer (output layer fused with loss function is skipped)
+ */
+int ConvolutionalNeuralNetwork::getLastBackwardLayer() const
+{
+	return static_cast<int>(allLayerNum) - (outputFusedWithLoss ? 2 : 1);
+}
+
+
+/*
+ * @brief Set on epoch finished callback
+ */
+void ConvolutionalNeuralNetwork::setOnEpochFinishedCallback(OnEpochFinishedCallbackType callback)
+{
+	onEpochFinishedCallback = std::move(callback);
+}
+
+
+/*
+ * @brief Switches network to inference only mode, layers free gradients, deltas and master copies of weights
+ */
+void ConvolutionalNeuralNetwork::releaseTrainingState()
+{
+	inferenceOnly = true;
+
+	for (auto & layer : allLayers)
+	{
+		layer->releaseTrainingState();
+	}
+}
+
+
+/*
+ * @brief Returns true if network can be used only for inference
+ */
+bool ConvolutionalNeuralNetwork::isInferenceOnly() const
+{
+	return inferenceOnly;
+}
+
+
+/*
+ * @brief Returns memory and compute trade-off of gradient checkpointing used in last training
+ */
+CheckpointingStatistics ConvolutionalNeuralNetwork::getCheckpointingStatistics() const
+{
+	return checkpointingStatistics;
+}
+
+
+/*
+ * @brief Enables output to std::cout
+ */
+void ConvolutionalNeuralNetwork::enableOutput()
+{
+	outputEnabled = true;
+}
+
+
+/*
+ * @brief Disables output
+ */
+void ConvolutionalNeuralNetwork::disableOutput()
+{
+	outputEnabled = false;
+}
+
+
+/*
+ * @brief Returns type of task this CNN is intended for
+ */
+TaskType ConvolutionalNeuralNetwork::getTaskType() const
+{
+	return taskType;
+}
+
+
+/*
+ * @brief Returns expected input dimensions
+ */
+Dimensions ConvolutionalNeuralNetwork::getInputSize() const
+{
+	return inputSize;
+}
+
+
+/*
+ * @brief Returns output dimensions
+ */
+Dimensions ConvolutionalNeuralNetwork::getOutputSize() const
+{
+	return outputSize;
 }
\ No newline at end of file
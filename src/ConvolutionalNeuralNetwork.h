@@ -1,116 +1,335 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Convolutional neural network instance
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef CONVOLUTIONAL_NEURAL_NETWORK_H
-#define CONVOLUTIONAL_NEURAL_NETWORK_H
-
-#include "src/Layers/ILayer.h"
-#include "src/CompileSettings.h"
-#include "src/TrainingSettings.h"
-#include "src/Image.h"
-#include "src/LayerAliases.h"
-
-#include <functional>
-#include <utility>
-
-// epoch num, training settings, epoch error, validation accuracy, epoch length
-using OnEpochFinishedCallbackType = std::function<void(unsigned, TrainingSettings &, float, float, float)>;
-
-/*
- * @brief An instance of Convolutional Neural Network, both for usage and training
- */
-class ConvolutionalNeuralNetwork
-{
-
-public:
-
-	ConvolutionalNeuralNetwork(const TaskType & taskType = TaskType::Classification);
-
-	void addLayer(const std::shared_ptr<ILayer<ForwardType, WeightType>> layer);
-
-	Image<ForwardType> run(const Image<ForwardType> & input);
-
-	float train(TrainingSettings & settings, std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & trainingData, 
-		const LossFunctionType & lossFunction, const std::shared_ptr<IOptimizer> optimizer,
-		const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & validationData = {});
-
-	float validate(const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & data);
-
-	void setOnEpochFinishedCallback(OnEpochFinishedCallbackType callback);
-
-	void enableOutput();
-
-	void disableOutput();
-
-	TaskType getTaskType() const;
-
-	Dimensions getInputSize() const;
-
-	Dimensions getOutputSize() const;
-
-public:
-
-	/// Layer iterator
-	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>>::const_iterator begin() const 
-	{ 
-		return allLayers.begin(); 
-	}
-
-	/// Layer iterator
-	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>>::const_iterator end() const 
-	{ 
-		return allLayers.end(); 
-	}
-
-private:
-
-	void printResults(const Image<ForwardType> & output) const;
-
-	std::pair<BackwardType, Image<BackwardType>> computeError(const Image<ForwardType> & actual, 
-		const Image<ForwardType> & expected, const LossFunctionType & lossFunctionType) const;
-
-private:
-
-	/// Layers not used during training
-	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> forwardOnlyLayers;
-
-	/// Layers used both in training and inference
-	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> allLayers;
-
-	/// Number of layers used only during inference
-	unsigned forwardOnlyLayerNum = 0;
-
-	/// Number of layers used both when training and during inference
-	unsigned allLayerNum = 0;
-
-	/// Task type
-	TaskType taskType = TaskType::Classification;
-
-	/// Accepted input size
-	Dimensions inputSize = { 0, 0, 0 };
-
-	/// Output size
-	Dimensions outputSize = { 0, 0, 0 };
-
-	/// Output to std::cout is enabled
-	bool outputEnabled = false;
-
-	/// Suppresses output during training
-	bool suppressOutput = false;
-
-	/// Specifies that training is in progress
-	bool training = false;
-
-	/// Function to call when epoch finishes
-	OnEpochFinishedCallbackType onEpochFinishedCallback = nullptr;
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Convolutional neural network instance
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef CONVOLUTIONAL_NEURAL_NETWORK_H
+#define CONVOLUTIONAL_NEURAL_NETWORK_H
+
+#include "src/Layers/ILayer.h"
+#include "src/CompileSettings.h"
+#include "src/TrainingSettings.h"
+#include "src/Image.h"
+#include "src/ExecutionContext.h"
+#include "src/CancellationToken.h"
+#include "src/LayerAliases.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+// epoch num, training settings, epoch error, validation accuracy, epoch length
+using OnEpochFinishedCallbackType = std::function<void(unsigned, TrainingSettings &, float, float, float)>;
+
+/*
+ * @brief Memory and compute trade-off of gradient checkpointing in last training
+ */
+struct CheckpointingStatistics
+{
+
+	/// Number of layers
+	unsigned layerNum;
+
+	/// Number of layers whose output was kept
+	unsigned checkpointNum;
+
+	/// Number of layers recomputed during backward propagation of each sample
+	unsigned recomputedLayerNum;
+
+	/// Memory needed by layer outputs without checkpointing (bytes)
+	size_t fullActivationBytes;
+
+	/// Peak memory needed by layer outputs with checkpointing (bytes)
+	size_t peakActivationBytes;
+
+	/// Time spent by recomputation (seconds)
+	float recomputationTime;
+
+};
+
+/*
+ * @brief Results of last validation of classification network
+ */
+struct ValidationStatistics
+{
+
+	/// Number of validated samples
+	unsigned sampleNum;
+
+	/// Number of samples classified correctly
+	unsigned correctNum;
+
+	/// Number of highest outputs searched for expected class (0 == top-k accuracy was not computed)
+	unsigned topK;
+
+	/// Number of samples whose expected class was among topK highest outputs
+	unsigned topKCorrectNum;
+
+	/// Number of classes
+	unsigned classNum;
+
+	/// Confusion matrix, row == expected class, column == predicted class (empty if not requested)
+	std::vector<unsigned> confusionMatrix;
+
+};
+
+/*
+ * @brief An instance of Convolutional Neural Network, both for usage and training
+ */
+class ConvolutionalNeuralNetwork
+{
+
+public:
+
+	ConvolutionalNeuralNetwork(const TaskType & taskType = TaskType::Classification);
+
+	~ConvolutionalNeuralNetwork();
+
+	ConvolutionalNeuralNetwork(const ConvolutionalNeuralNetwork &) = default;
+
+	ConvolutionalNeuralNetwork & operator=(const ConvolutionalNeuralNetwork &) = default;
+
+	void addLayer(const std::shared_ptr<ILayer<ForwardType, WeightType>> layer);
+
+	void compile(const bool fuseLayers = true);
+
+	bool isCompiled() const;
+
+	Image<ForwardType> run(const Image<ForwardType> & input);
+
+	const Image<ForwardType> & run(ExecutionContext & context, const Image<ForwardType> & input) const;
+
+	ExecutionContext createExecutionContext() const;
+
+	Image<ForwardType> runBatch(const std::vector<Image<ForwardType>> & inputs) const;
+
+	Image<ForwardType> runBatch(ExecutionContext & context, const std::vector<Image<ForwardType>> & inputs) const;
+
+	Image<ForwardType> runBatch(const std::function<bool(Image<ForwardType> &)> & nextInput) const;
+
+	std::future<Image<ForwardType>> runAsync(const Image<ForwardType> & input, const CancellationToken & token = CancellationToken()) const;
+
+	void setMaxInFlight(const unsigned maxInFlight);
+
+	unsigned getInFlight() const;
+
+	float train(TrainingSettings & settings, std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & trainingData, 
+		const LossFunctionType & lossFunction, const std::shared_ptr<IOptimizer> optimizer,
+		const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & validationData = {});
+
+	float validate(const std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> & data);
+
+	void setValidationMetrics(const unsigned topK, const bool confusionMatrix);
+
+	ValidationStatistics getValidationStatistics() const;
+
+	void setOnEpochFinishedCallback(OnEpochFinishedCallbackType callback);
+
+	void releaseTrainingState();
+
+	bool isInferenceOnly() const;
+
+	CheckpointingStatistics getCheckpointingStatistics() const;
+
+	void enableOutput();
+
+	void disableOutput();
+
+	TaskType getTaskType() const;
+
+	Dimensions getInputSize() const;
+
+	Dimensions getOutputSize() const;
+
+public:
+
+	/// Layer iterator
+	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>>::const_iterator begin() const 
+	{ 
+		return allLayers.begin(); 
+	}
+
+	/// Layer iterator
+	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>>::const_iterator end() const 
+	{ 
+		return allLayers.end(); 
+	}
+
+private:
+
+	/*
+	 * @brief State of asynchronous runs (shared, so that network stays copyable)
+	 */
+	struct AsyncState
+	{
+		/// Protects all members
+		std::mutex mutex;
+
+		/// Signals finished run
+		std::condition_variable finished;
+
+		/// Runs submitted and not yet finished
+		unsigned inFlight = 0;
+
+		/// Largest number of runs in flight, further submissions wait (0 == four per worker of shared pool)
+		unsigned maxInFlight = 0;
+
+		/// Contexts not used by any run (shared by asynchronous and batched runs)
+		std::vector<ExecutionContext> freeContexts;
+	};
+
+	/*
+	 * @brief Step of compiled execution plan, contexts bind their buffers to it
+	 */
+	struct CompiledStep
+	{
+		/// Kernel selected by layer
+		ILayer<ForwardType, WeightType>::Kernel kernel;
+
+		/// Layer run by kernel (fused layer if several layers were fused)
+		std::shared_ptr<ILayer<ForwardType, WeightType>> layer;
+
+		/// Index of last layer computed by this step
+		unsigned lastLayer;
+	};
+
+	void printResults(const Image<ForwardType> & output) const;
+
+	void printConfusionMatrix() const;
+
+	bool isCurrent(const ExecutionContext & context) const;
+
+	ExecutionContext acquireContext() const;
+
+	void releaseContext(ExecutionContext && context) const;
+
+	void enableInPlaceExecution(const std::shared_ptr<ILayer<ForwardType, WeightType>> & layer);
+
+	void replaceLayers(const std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> & layers);
+
+	void forwardLayer(const unsigned index, const Image<ForwardType> & input);
+
+	void backwardLayer(const unsigned index, const Image<ForwardType> & input, const Image<BackwardType> & errorGradients, const TrainingSettings & settings);
+
+	void forwardPass(const Image<ForwardType> & input);
+
+	void backwardPass(const Image<ForwardType> & input, const Image<BackwardType> & errorGradients, const TrainingSettings & settings);
+
+	void planCheckpoints(const TrainingSettings & settings);
+
+	void materializeOutput(const unsigned index);
+
+	void materializeOutputs();
+
+	std::pair<BackwardType, Image<BackwardType>> computeError(const Image<ForwardType> & actual, 
+		const Image<ForwardType> & expected, const LossFunctionType & lossFunctionType) const;
+
+	bool fusesOutputLayerWithLoss(const LossFunctionType & lossFunctionType) const;
+
+	std::pair<BackwardType, Image<BackwardType>> computeFusedError(const Image<ForwardType> & actual, 
+		const Image<ForwardType> & expected, const LossFunctionType & lossFunctionType) const;
+
+	void prepareSampledSoftmax(const TrainingSettings & settings, const LossFunctionType & lossFunctionType);
+
+	std::pair<BackwardType, Image<BackwardType>> computeSampledError(const Image<ForwardType> & input, 
+		const Image<ForwardType> & expected, const TrainingSettings & settings);
+
+	int getLastBackwardLayer() const;
+
+private:
+
+	/// Layers not used during training
+	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> forwardOnlyLayers;
+
+	/// Layers used both in training and inference
+	std::vector<std::shared_ptr<ILayer<ForwardType, WeightType>>> allLayers;
+
+	/// Number of layers used only during inference
+	unsigned forwardOnlyLayerNum = 0;
+
+	/// Number of layers used both when training and during inference
+	unsigned allLayerNum = 0;
+
+	/// Task type
+	TaskType taskType = TaskType::Classification;
+
+	/// Accepted input size
+	Dimensions inputSize = { 0, 0, 0 };
+
+	/// Output size
+	Dimensions outputSize = { 0, 0, 0 };
+
+	/// Steps of compiled execution plan (empty == network was not compiled)
+	std::vector<CompiledStep> compiledPlan;
+
+	/// Identifies current layers, changes whenever layer is added or replaced (unique among all networks)
+	uint64_t layersGeneration = 0;
+
+	/// Identifies current execution plan, changes whenever layers change or network is compiled (unique among all networks)
+	uint64_t planGeneration = 0;
+
+	/// Output to std::cout is enabled
+	bool outputEnabled = false;
+
+	/// Suppresses output during training
+	bool suppressOutput = false;
+
+	/// Specifies that training is in progress
+	bool training = false;
+
+	/// Last layer is differentiated together with loss function, error gradients are computed for its input
+	bool outputFusedWithLoss = false;
+
+	/// Fully connected layer before softmax computing only sampled classes during training (nullptr == full softmax)
+	FullyConnected * sampledLayer = nullptr;
+
+	/// Classes computed for current training sample (expected class first)
+	std::vector<unsigned> sampledClasses;
+
+	/// Marks classes sampled for current training sample
+	std::vector<bool> classSampled;
+
+	/// Generator of sampled classes
+	std::mt19937 sampleGenerator;
+
+	/// Training state was released, network can be used only for inference
+	bool inferenceOnly = false;
+
+	/// Layers whose outputs are kept during training (empty == all outputs are kept)
+	std::vector<bool> checkpoints;
+
+	/// Index of first layer of last segment (its outputs are not released after forward propagation)
+	unsigned lastSegmentStart = 0;
+
+	/// Statistics of gradient checkpointing
+	CheckpointingStatistics checkpointingStatistics = {};
+
+	/// Number of highest outputs searched for expected class during validation (0 == disabled)
+	unsigned validationTopK = 0;
+
+	/// Validation computes confusion matrix
+	bool validationConfusionMatrix = false;
+
+	/// Statistics of last validation
+	ValidationStatistics validationStatistics = {};
+
+	/// Function to call when epoch finishes
+	OnEpochFinishedCallbackType onEpochFinishedCallback = nullptr;
+
+	/// State of asynchronous and batched runs
+	std::shared_ptr<AsyncState> asyncState;
+
+};
+
 #endif
\ No newline at end of file
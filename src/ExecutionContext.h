@@ -0,0 +1,100 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Buffers used by a single inference thread
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef EXECUTION_CONTEXT_H
+#define EXECUTION_CONTEXT_H
+
+#include "src/CompileSettings.h"
+#include "src/Image.h"
+#include "src/Layers/ILayer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ConvolutionalNeuralNetwork;
+
+/*
+ * @brief Holds outputs of all layers for inference, so that network (weights) is not modified when running
+ *
+ * Each thread creates its own context with ConvolutionalNeuralNetwork::createExecutionContext and passes it
+ * to ConvolutionalNeuralNetwork::run, network may then be shared by any number of threads. Contexts created by compiled
+ * network also hold execution plan with buffers bound to layers, contexts may be moved but not copied because of that.
+ * Context is valid only until layers of network are changed or network is compiled again (plan with its layers is replaced).
+ */
+class ExecutionContext
+{
+
+	friend class ConvolutionalNeuralNetwork;
+
+public:
+
+	ExecutionContext() = default;
+
+	ExecutionContext(const ExecutionContext &) = delete;
+
+	ExecutionContext & operator=(const ExecutionContext &) = delete;
+
+	ExecutionContext(ExecutionContext &&) = default;
+
+	ExecutionContext & operator=(ExecutionContext &&) = default;
+
+	/*
+	 * @brief Returns output of last inference run with this context
+	 */
+	const Image<ForwardType> & getOutput() const
+	{
+		return outputs.back();
+	}
+
+
+	/*
+	 * @brief Returns memory occupied by buffers of this context (bytes)
+	 */
+	size_t getByteSize() const
+	{
+		return byteSize;
+	}
+
+private:
+
+	/*
+	 * @brief Step of compiled execution plan
+	 */
+	struct PlanStep
+	{
+		/// Kernel selected by layer when network was compiled
+		ILayer<ForwardType, WeightType>::Kernel kernel;
+
+		/// Layer run by kernel
+		ILayer<ForwardType, WeightType> * layer;
+
+		/// Output of previous step (null for first step, which reads input of run)
+		const Image<ForwardType> * input;
+
+		/// Output of this step
+		Image<ForwardType> * output;
+	};
+
+	/// Outputs of layers used during inference (elementwise layers share buffer with previous layer)
+	std::vector<Image<ForwardType>> outputs;
+
+	/// Steps of compiled execution plan (empty if network was not compiled)
+	std::vector<PlanStep> plan;
+
+	/// Memory occupied by buffers
+	size_t byteSize = 0;
+
+	/// Generation of layers (or of plan if context holds it) of network which created this context
+	uint64_t generation = 0;
+
+};
+
+#endif
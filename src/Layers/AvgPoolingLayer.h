@@ -1,139 +1,467 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Average pooling layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef AVG_POOLING_LAYER_H
-#define AVG_POOLING_LAYER_H
-
-#include "src/Layers/ILayer.h"
-#include "src/Layers/PoolingLayer.h"
-
-#include "src/Image.h"
-
-/*
- * @brief Average pooling layer that reduces width and height of input matrix
- */
-template <class _ForwardType, class _WeightType>
-class AvgPoolingLayer : public PoolingLayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Initialized average pooling layer
-	 *
-	 * @param input      Dimensions of input matrix
-	 * @param extent     Extent of 2D window used for pooling
-	 * @param stride     Step with which the window is slided
-	 */
-	AvgPoolingLayer(const Dimensions & input, const unsigned & extent, const unsigned & stride)
-		: PoolingLayer<_ForwardType, _WeightType>(input, extent, stride, PoolingOperation::Average)
-	{
-	}
-
-
-	/*
-	 * @brief Forward propagates a matrix in order to reduce dimension using given operation
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != this->inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to "
-				"declared input size in Pooling layer.");
-		}
-
-		auto flattenedSize = out.getFlattenedSize();
-
-		// Perform pooling
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			auto accum = static_cast<_ForwardType>(0);
-			for (auto k = 0u; k < this->windowSize; k++)
-			{
-				accum += in(this->edges[i][k]);
-			}
-			out(i) = accum / static_cast<_ForwardType>(static_cast<float>(this->windowSize));
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*for (auto z = 0u; z < outputSize.depth; z++)
-		{
-			unsigned currY = 0;
-			for (auto i = 0u; i < outputSize.height; i++)
-			{
-				unsigned currX = 0;
-				for (auto j = 0u; j < outputSize.width; j++)
-				{
-					auto accum = initAccumValue;
-					for (auto b = 0u; b < extent; b++)
-					{
-						for (auto a = 0u; a < extent; a++)
-						{
-							unsigned x = currX + a;
-							unsigned y = currY + b;
-							accum += in(x, y, z);
-						}
-					}
-					out(j, i, z) = accum / static_cast<_ForwardType>(static_cast<float>(extent * extent));
-					currX += stride;
-				}
-				currY += stride;
-			}
-		}*/
-	}
-
-
-	/*
-	 * @brief Computes gradients to be propagated to previous layer (depends on usder operation)
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> &, 
-		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
-	{
-		outGradients.clear();
-
-		auto flattenedSize = inGradients.getFlattenedSize();
-
-		// Reverse pooling (assign error to min/max element or split it if average was used)
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			for (auto k = 0u; k < this->windowSize; k++)
-			{
-				outGradients(this->edges[i][k]) += inGradients(i) / static_cast<BackwardType>(static_cast<float>(this->windowSize));
-			}
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*for (auto z = 0u; z < outputSize.depth; z++)
-		{
-			unsigned currY = 0;
-			for (auto i = 0u; i < outputSize.height; i++)
-			{
-				unsigned currX = 0;
-				for (auto j = 0u; j < outputSize.width; j++)
-				{
-					for (auto b = 0u; b < extent; b++)
-					{
-						for (auto a = 0u; a < extent; a++)
-						{
-							unsigned x = currX + a;
-							unsigned y = currY + b;
-							outGradients(x, y, z) += inGradients(j, i, z) / (extent * extent);
-						}
-					}
-					currX += stride;
-				}
-				currY += stride;
-			}
-		}*/
-	}
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Average pooling layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef AVG_POOLING_LAYER_H
+#define AVG_POOLING_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/PoolingLayer.h"
+
+#include "src/Image.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*
+ * @brief Average pooling layer that reduces width and height of input matrix
+ *
+ * Overlapping windows are summed separably, each column segment of window is summed first and these sums are summed by rows then.
+ * Sum of next window is obtained from previous one by adding entering cells and subtracting leaving ones, so cost
+ * does not depend on extent. Backward propagation scatters gradients the same way (each input cell sums gradients
+ * of range of windows covering it). Non-overlapping windows touch each input cell once and are summed directly,
+ * the most common 2x2 windows with stride 2 by pairs of rows without indirection through edges.
+ */
+template <class _ForwardType, class _WeightType>
+class AvgPoolingLayer : public PoolingLayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initialized average pooling layer
+	 *
+	 * @param input      Dimensions of input matrix
+	 * @param extent     Extent of 2D window used for pooling
+	 * @param stride     Step with which the window is slided
+	 */
+	AvgPoolingLayer(const Dimensions & input, const unsigned & extent, const unsigned & stride)
+		: PoolingLayer<_ForwardType, _WeightType>(input, extent, stride, PoolingOperation::Average)
+		, overlapping(stride < extent)
+		, windowColumns(createWindowRanges(this->outputSize.width))
+		, windowRows(createWindowRanges(this->outputSize.height))
+		, coveringColumns(createCoveringRanges(this->inputSize.width, this->outputSize.width))
+		, coveringRows(createCoveringRanges(this->inputSize.height, this->outputSize.height))
+	{
+	}
+
+
+	/*
+	 * @brief Forward propagates a matrix in order to reduce dimension using given operation
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to "
+				"declared input size in Pooling layer.");
+		}
+
+		average(in, out);
+
+		// Slower, but more descriptive implementation for future reference
+		/*for (auto z = 0u; z < outputSize.depth; z++)
+		{
+			unsigned currY = 0;
+			for (auto i = 0u; i < outputSize.height; i++)
+			{
+				unsigned currX = 0;
+				for (auto j = 0u; j < outputSize.width; j++)
+				{
+					auto accum = initAccumValue;
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							unsigned x = currX + a;
+							unsigned y = currY + b;
+							accum += in(x, y, z);
+						}
+					}
+					out(j, i, z) = accum / static_cast<_ForwardType>(static_cast<float>(extent * extent));
+					currX += stride;
+				}
+				currY += stride;
+			}
+		}*/
+	}
+
+
+	/*
+	 * @brief Compiled execution plan pools without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = AvgPoolingLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::average>;
+	}
+
+
+	/*
+	 * @brief Gradients are split evenly, output is not needed
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Computes gradients to be propagated to previous layer (depends on usder operation)
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> &, 
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		if (this->halving)
+		{
+			scatterHalving(inGradients, outGradients);
+			return;
+		}
+		else if (!overlapping)
+		{
+			scatterWindows(inGradients, outGradients);
+			return;
+		}
+
+		const auto inWidth = this->inputSize.width;
+		const auto inHeight = this->inputSize.height;
+		const auto outWidth = this->outputSize.width;
+		const auto outHeight = this->outputSize.height;
+
+		// Reverse pooling (split error evenly), windows of one channel touch only that channel, so channels are split among threads
+		ThreadPool::runParallel(this->outputSize.depth, inWidth * inHeight, [this, &inGradients, &outGradients, inWidth, inHeight, outWidth, outHeight](size_t first, size_t last)
+		{
+			// Buffers are reused by thread
+			auto & rowSums = this->template getScratch<BackwardType, 0>(outHeight * inWidth);
+			auto & accumulator = this->template getScratch<BackwardType, 1>(inWidth);
+			const auto scale = static_cast<BackwardType>(static_cast<float>(this->windowSize));
+
+			for (auto z = static_cast<unsigned>(first); z < last; z++)
+			{
+				// Gradients of windows covering each input column (in each row of windows), then of rows of windows covering each input row
+				const auto gradients = &inGradients(z * outWidth * outHeight);
+				for (auto y = 0u; y < outHeight; y++)
+				{
+					sumCellRanges(gradients + y * outWidth, coveringColumns, rowSums.data() + y * inWidth);
+				}
+
+				const auto plane = &outGradients(z * inWidth * inHeight);
+				sumLineRanges(rowSums.data(), inWidth, coveringRows, plane, accumulator);
+
+				for (auto i = 0u; i < inWidth * inHeight; i++)
+				{
+					plane[i] /= scale;
+				}
+			}
+		});
+
+		// Slower, but more descriptive implementation for future reference
+		/*for (auto z = 0u; z < outputSize.depth; z++)
+		{
+			unsigned currY = 0;
+			for (auto i = 0u; i < outputSize.height; i++)
+			{
+				unsigned currX = 0;
+				for (auto j = 0u; j < outputSize.width; j++)
+				{
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							unsigned x = currX + a;
+							unsigned y = currY + b;
+							outGradients(x, y, z) += inGradients(j, i, z) / (extent * extent);
+						}
+					}
+					currX += stride;
+				}
+				currY += stride;
+			}
+		}*/
+	}
+
+private:
+
+	/// Range of lines [first, second)
+	using Range = std::pair<unsigned, unsigned>;
+
+	/*
+	 * @brief Averages each window by summing columns of windows and then rows of column sums (channels are split among threads)
+	 */
+	void average(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		if (this->halving)
+		{
+			averageHalving(in, out);
+			return;
+		}
+		else if (!overlapping)
+		{
+			averageWindows(in, out);
+			return;
+		}
+
+		const auto inWidth = this->inputSize.width;
+		const auto inHeight = this->inputSize.height;
+		const auto outWidth = this->outputSize.width;
+		const auto outHeight = this->outputSize.height;
+
+		ThreadPool::runParallel(this->outputSize.depth, inWidth * inHeight, [this, &in, &out, inWidth, inHeight, outWidth, outHeight](size_t first, size_t last)
+		{
+			// Buffers are reused by thread
+			auto & columnSums = this->template getScratch<BackwardType, 0>(outHeight * inWidth);
+			auto & windowSums = this->template getScratch<BackwardType, 2>(outHeight * outWidth);
+			auto & accumulator = this->template getScratch<BackwardType, 1>(inWidth);
+			const auto scale = static_cast<BackwardType>(static_cast<float>(this->windowSize));
+
+			for (auto z = static_cast<unsigned>(first); z < last; z++)
+			{
+				sumLineRanges(&in(z * inWidth * inHeight), inWidth, windowRows, columnSums.data(), accumulator);
+				for (auto y = 0u; y < outHeight; y++)
+				{
+					sumCellRanges(columnSums.data() + y * inWidth, windowColumns, windowSums.data() + y * outWidth);
+				}
+
+				const auto outPlane = &out(z * outWidth * outHeight);
+				for (auto i = 0u; i < outWidth * outHeight; i++)
+				{
+					outPlane[i] = static_cast<_ForwardType>(static_cast<float>(windowSums[i] / scale));
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Averages 2x2 windows with stride 2, each output row is averaged from pair of input rows (rows are split among threads)
+	 *
+	 * Output row r is created from input rows 2r and 2r + 1 in all channels as height of input is even.
+	 */
+	void averageHalving(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto inWidth = this->inputSize.width;
+		const auto outWidth = this->outputSize.width;
+		const auto scale = static_cast<_ForwardType>(static_cast<float>(this->windowSize));
+
+		ThreadPool::runParallel(this->outputSize.height * this->outputSize.depth, inWidth * 2, [&in, &out, inWidth, outWidth, scale](size_t first, size_t last)
+		{
+			for (auto row = static_cast<unsigned>(first); row < last; row++)
+			{
+				const auto top = &in(row * 2 * inWidth);
+				const auto bottom = top + inWidth;
+				const auto result = &out(row * outWidth);
+
+				for (auto x = 0u; x < outWidth; x++)
+				{
+					result[x] = (top[2 * x] + top[2 * x + 1] + bottom[2 * x] + bottom[2 * x + 1]) / scale;
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Splits gradient of each 2x2 window evenly among its cells (rows are split among threads)
+	 */
+	void scatterHalving(const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients)
+	{
+		const auto inWidth = this->inputSize.width;
+		const auto outWidth = this->outputSize.width;
+		const auto scale = static_cast<BackwardType>(static_cast<float>(this->windowSize));
+
+		ThreadPool::runParallel(this->outputSize.height * this->outputSize.depth, inWidth * 2, [&inGradients, &outGradients, inWidth, outWidth, scale](size_t first, size_t last)
+		{
+			for (auto row = static_cast<unsigned>(first); row < last; row++)
+			{
+				const auto top = &outGradients(row * 2 * inWidth);
+				const auto bottom = top + inWidth;
+				const auto gradients = &inGradients(row * outWidth);
+
+				for (auto x = 0u; x < outWidth; x++)
+				{
+					const auto gradient = gradients[x] / scale;
+					top[2 * x] = gradient;
+					top[2 * x + 1] = gradient;
+					bottom[2 * x] = gradient;
+					bottom[2 * x + 1] = gradient;
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Averages each window by summing its cells (output cells are split among threads)
+	 */
+	void averageWindows(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		ThreadPool::runParallel(out.getFlattenedSize(), this->windowSize, [this, &in, &out](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				auto accum = static_cast<_ForwardType>(0);
+				for (auto k = 0u; k < this->windowSize; k++)
+				{
+					accum += in(this->edges[i][k]);
+				}
+				out(i) = accum / static_cast<_ForwardType>(static_cast<float>(this->windowSize));
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Splits gradient of each window evenly among its cells (channels are split among threads)
+	 */
+	void scatterWindows(const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients)
+	{
+		outGradients.clear();
+
+		const auto planeSize = this->outputSize.width * this->outputSize.height;
+		ThreadPool::runParallel(this->outputSize.depth, planeSize * this->windowSize, [this, &inGradients, &outGradients, planeSize](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first * planeSize); i < last * planeSize; i++)
+			{
+				for (auto k = 0u; k < this->windowSize; k++)
+				{
+					outGradients(this->edges[i][k]) += inGradients(i) / static_cast<BackwardType>(static_cast<float>(this->windowSize));
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Sums each range of lines (line holds lineWidth values), both ends of ranges
+	 *            do not decrease, so sum of next range is updated by lines entering and leaving it (all values of line at once)
+	 *
+	 * Sum starts from zero whenever range does not overlap previous one, non-overlapping windows are summed directly.
+	 */
+	template <class _Type>
+	static void sumLineRanges(_Type * lines, const unsigned & lineWidth,
+		const std::vector<Range> & ranges, BackwardType * sums, std::vector<BackwardType> & accumulator)
+	{
+		auto begin = 0u;
+		auto end = 0u;
+		for (auto k = 0u; k < ranges.size(); k++)
+		{
+			if (ranges[k].first >= end)
+			{
+				std::fill(accumulator.begin(), accumulator.begin() + lineWidth, static_cast<BackwardType>(0.0f));
+				begin = end = ranges[k].first;
+			}
+
+			for (; end < ranges[k].second; end++)
+			{
+				const auto line = lines + end * lineWidth;
+				for (auto c = 0u; c < lineWidth; c++)
+				{
+					accumulator[c] += static_cast<BackwardType>(static_cast<float>(line[c]));
+				}
+			}
+
+			for (; begin < ranges[k].first; begin++)
+			{
+				const auto line = lines + begin * lineWidth;
+				for (auto c = 0u; c < lineWidth; c++)
+				{
+					accumulator[c] -= static_cast<BackwardType>(static_cast<float>(line[c]));
+				}
+			}
+
+			std::copy(accumulator.begin(), accumulator.begin() + lineWidth, sums + k * lineWidth);
+		}
+	}
+
+
+	/*
+	 * @brief Sums each range of cells of single line the same way as ranges of lines are summed
+	 */
+	template <class _Type>
+	static void sumCellRanges(_Type * cells, const std::vector<Range> & ranges, BackwardType * sums)
+	{
+		auto sum = static_cast<BackwardType>(0.0f);
+		auto begin = 0u;
+		auto end = 0u;
+		for (auto k = 0u; k < ranges.size(); k++)
+		{
+			if (ranges[k].first >= end)
+			{
+				sum = static_cast<BackwardType>(0.0f);
+				begin = end = ranges[k].first;
+			}
+
+			for (; end < ranges[k].second; end++)
+			{
+				sum += static_cast<BackwardType>(static_cast<float>(cells[end]));
+			}
+
+			for (; begin < ranges[k].first; begin++)
+			{
+				sum -= static_cast<BackwardType>(static_cast<float>(cells[begin]));
+			}
+
+			sums[k] = sum;
+		}
+	}
+
+
+	/*
+	 * @brief Creates range of input lines covered by each window (along one dimension)
+	 */
+	std::vector<Range> createWindowRanges(const unsigned & windowNum) const
+	{
+		std::vector<Range> ranges(windowNum);
+		for (auto k = 0u; k < windowNum; k++)
+		{
+			ranges[k] = Range{ k * this->stride, k * this->stride + this->extent };
+		}
+
+		return ranges;
+	}
+
+
+	/*
+	 * @brief Creates range of windows covering each input line (along one dimension), range is empty if line is not covered
+	 */
+	std::vector<Range> createCoveringRanges(const unsigned & lineNum, const unsigned & windowNum) const
+	{
+		std::vector<Range> ranges(lineNum);
+		for (auto j = 0u; j < lineNum; j++)
+		{
+			const auto firstWindow = (j < this->extent) ? 0u : (j - this->extent) / this->stride + 1;
+			const auto lastWindow = std::min(j / this->stride + 1, windowNum);
+			ranges[j] = Range{ firstWindow, std::max(firstWindow, lastWindow) };
+		}
+
+		return ranges;
+	}
+
+private:
+
+	/// Whether windows overlap (they are summed separably then)
+	bool overlapping;
+
+	/// Input columns of windows in each output column
+	std::vector<Range> windowColumns;
+
+	/// Input rows of windows in each output row
+	std::vector<Range> windowRows;
+
+	/// Windows covering each input column
+	std::vector<Range> coveringColumns;
+
+	/// Windows covering each input row
+	std::vector<Range> coveringRows;
+
+};
+
 #endif
\ No newline at end of file
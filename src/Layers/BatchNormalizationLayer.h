@@ -0,0 +1,535 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Batch normalization layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef BATCH_NORMALIZATION_LAYER_H
+#define BATCH_NORMALIZATION_LAYER_H
+
+#include "src/Layers/ILayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+ * @brief Exception thrown if problems occur during layer initialization
+ */
+class BatchNormalizationLayerException : public CNNException
+{
+	using CNNException::CNNException;
+};
+
+/*
+ * @brief Batch normalization layer, normalizes each feature with its mean and variance and applies learnable scale and shift
+ *
+ * Each channel of input is one feature, input with single channel (e.g. output of fully connected layer) has one feature per cell.
+ *
+ * Samples are propagated one by one, so statistics of whole batch are known only after its last sample. Training therefore
+ * normalizes each sample with mean and variance of the batch accumulated so far (previous samples of batch and current sample,
+ * over all cells of feature), running statistics are used only for single cell features of first sample of batch. Backward
+ * propagation accumulates the batch and moves running statistics towards its statistics once batch size is met.
+ * Statistics are treated as constants by gradients. Inference normalizes with running statistics only,
+ * so the layer may be folded into previous convolutional or fully connected layer (see GraphOptimizer).
+ */
+template <class _ForwardType, class _WeightType>
+class BatchNormalizationLayer : public ILayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initializes layer to identity (scale 1, shift 0, mean 0, variance 1)
+	 *
+	 * @param  input      Dimensions of input matrix
+	 * @param  momentum   Weight of statistics of last batch when updating running statistics
+	 * @param  epsilon    Added to variance to avoid division by zero
+	 * @param  inferenceOnly   Layer is used only for forward propagation, gradients, deltas and batch statistics are not allocated
+	 */
+	BatchNormalizationLayer(const Dimensions & input, const float momentum = 0.1f, const float epsilon = 1e-5f, const bool inferenceOnly = false)
+		: inputSize(input)
+		, momentum(momentum)
+		, epsilon(epsilon)
+		, featureSize((input.depth > 1) ? std::max(1u, input.width * input.height) : 1)
+		, featureNum(input.width * input.height * input.depth / featureSize)
+		, parameters(2 * featureNum, static_cast<BackwardType>(0.0f))
+		, deltas(inferenceOnly ? 0 : 2 * featureNum, static_cast<BackwardType>(0.0f))
+		, runningMeans(featureNum, static_cast<BackwardType>(0.0f))
+		, runningVariances(featureNum, static_cast<BackwardType>(1.0f))
+		, batchSums(inferenceOnly ? 0 : featureNum, 0.0)
+		, batchSquaredSums(inferenceOnly ? 0 : featureNum, 0.0)
+		, trainingMeans(inferenceOnly ? 0 : featureNum, static_cast<BackwardType>(0.0f))
+		, trainingInvStds(inferenceOnly ? 0 : featureNum, static_cast<BackwardType>(1.0f / sqrt(1.0f + epsilon)))
+		, forwardScales(featureNum)
+		, forwardShifts(featureNum)
+		, output(input)
+		, gradientOutput(inferenceOnly ? Image<BackwardType>() : Image<BackwardType>(input))
+	{
+		if (featureNum == 0)
+		{
+			throw BatchNormalizationLayerException("Batch normalization needs at least one feature.");
+		}
+		else if (momentum <= 0.0f || momentum > 1.0f || epsilon <= 0.0f)
+		{
+			throw BatchNormalizationLayerException("Momentum of batch normalization must be in range (0,1> and epsilon must be positive.");
+		}
+
+		std::fill(parameters.begin(), parameters.begin() + featureNum, static_cast<BackwardType>(1.0f));
+
+		convertParameters();
+	}
+
+
+	/*
+	 * @brief Normalizes input with running statistics (inference)
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image had different dimensions than declared when initializing Batch normalization layer.");
+		}
+
+		normalize(in, out);
+	}
+
+
+	/*
+	 * @brief Normalizes input with statistics of sample (or of batch so far for single cell features), statistics are kept for backward propagation
+	 */
+	virtual void trainingPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image had different dimensions than declared when initializing Batch normalization layer.");
+		}
+
+		// Batch is accumulated by backward propagation, so repeated propagation of the same input (recomputation) gives the same result
+		ThreadPool::runParallel(featureNum, featureSize, [this, &in, &out](size_t first, size_t last)
+		{
+			const auto cellNum = (featureSize > 1) ? static_cast<double>(featureSize) : static_cast<double>(examplesSinceUpdate + 1);
+			for (auto feature = static_cast<unsigned>(first); feature < last; feature++)
+			{
+				auto sum = (featureSize > 1) ? 0.0 : batchSums[feature];
+				auto squaredSum = (featureSize > 1) ? 0.0 : batchSquaredSums[feature];
+				for (auto i = feature * featureSize; i < (feature + 1) * featureSize; i++)
+				{
+					const auto value = static_cast<double>(static_cast<float>(in(i)));
+					sum += value;
+					squaredSum += value * value;
+				}
+
+				const auto mean = sum / cellNum;
+				const auto variance = std::max(0.0, squaredSum / cellNum - mean * mean);
+				trainingMeans[feature] = static_cast<BackwardType>(static_cast<float>(mean));
+				trainingInvStds[feature] = static_cast<BackwardType>(static_cast<float>(1.0 / std::sqrt(variance + epsilon)));
+
+				const auto multiplier = static_cast<float>(parameters[feature]) * static_cast<float>(trainingInvStds[feature]);
+				const auto scale = static_cast<_ForwardType>(multiplier);
+				const auto shift = static_cast<_ForwardType>(static_cast<float>(parameters[featureNum + feature]) - static_cast<float>(trainingMeans[feature]) * multiplier);
+				for (auto i = feature * featureSize; i < (feature + 1) * featureSize; i++)
+				{
+					out(i) = in(i) * scale + shift;
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Compiled execution plan normalizes without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = BatchNormalizationLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::normalize>;
+	}
+
+
+	/*
+	 * @brief Computes gradients (including terms of mean and variance), accumulates statistics of batch and updates parameters
+	 *            and running statistics once batch size is met
+	 *
+	 * @throws BatchNormalizationLayerException if single cell features are trained with batches of one sample
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> &,
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings & trainingSettings) override
+	{
+		if (featureSize == 1 && trainingSettings.batchSize < 2)
+		{
+			throw BatchNormalizationLayerException("Batch normalization of single cell features needs batches of at least two samples.");
+		}
+
+		// Cells of one feature are touched only by one thread
+		ThreadPool::runParallel(featureNum, featureSize, [this, &in, &inGradients, &outGradients](size_t first, size_t last)
+		{
+			for (auto feature = static_cast<unsigned>(first); feature < last; feature++)
+			{
+				// Statistics used by training propagation of this input
+				const auto mean = static_cast<float>(trainingMeans[feature]);
+				const auto invStd = static_cast<float>(trainingInvStds[feature]);
+				const auto scaledInvStd = static_cast<float>(parameters[feature]) * invStd;
+
+				auto gradientSum = 0.0f;
+				auto normalizedGradientSum = 0.0f;
+				for (auto i = feature * featureSize; i < (feature + 1) * featureSize; i++)
+				{
+					const auto normalized = (static_cast<float>(in(i)) - mean) * invStd;
+					const auto gradient = static_cast<float>(inGradients(i));
+					gradientSum += gradient;
+					normalizedGradientSum += gradient * normalized;
+				}
+
+				deltas[feature] += static_cast<BackwardType>(normalizedGradientSum);
+				deltas[featureNum + feature] += static_cast<BackwardType>(gradientSum);
+
+				if (featureSize > 1)
+				{
+					// Mean and (biased) variance of sample depend on all its cells
+					const auto cellNum = static_cast<float>(featureSize);
+					auto varianceSum = 0.0;
+					for (auto i = feature * featureSize; i < (feature + 1) * featureSize; i++)
+					{
+						const auto value = static_cast<float>(in(i));
+						const auto normalized = (value - mean) * invStd;
+						outGradients(i) = static_cast<BackwardType>(scaledInvStd * (static_cast<float>(inGradients(i)) - (gradientSum + normalized * normalizedGradientSum) / cellNum));
+
+						batchSums[feature] += static_cast<double>(value);
+						varianceSum += static_cast<double>(value - mean) * static_cast<double>(value - mean);
+					}
+
+					// Running variance is mean of unbiased variances of samples (samples are normalized separately)
+					batchSquaredSums[feature] += varianceSum / (featureSize - 1);
+				}
+				else
+				{
+					// Current sample has weight 1 / n in mean and variance of n samples of batch propagated so far
+					const auto cellNum = static_cast<float>(examplesSinceUpdate + 1);
+					const auto i = feature;
+					const auto value = static_cast<float>(in(i));
+					const auto normalized = (value - mean) * invStd;
+					outGradients(i) = static_cast<BackwardType>(scaledInvStd * static_cast<float>(inGradients(i)) * (1.0f - (1.0f + normalized * normalized) / cellNum));
+
+					batchSums[feature] += static_cast<double>(value);
+					batchSquaredSums[feature] += static_cast<double>(value) * static_cast<double>(value);
+				}
+			}
+		});
+
+		// Update parameters and statistics once batch size is met
+		if (++examplesSinceUpdate == trainingSettings.batchSize)
+		{
+			this->optimizer->updateWeights(parameters, deltas, examplesSinceUpdate);
+			updateRunningStatistics();
+			examplesSinceUpdate = 0;
+			convertParameters();
+		}
+	}
+
+
+	/*
+	 * @brief Backward propagation uses only input of this layer
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Frees gradients, deltas and statistics of unfinished batch (parameters are kept for folding and dumping)
+	 */
+	virtual void releaseTrainingState() override
+	{
+		ILayer<_ForwardType, _WeightType>::releaseTrainingState();
+
+		std::vector<BackwardType>().swap(deltas);
+		std::vector<double>().swap(batchSums);
+		std::vector<double>().swap(batchSquaredSums);
+		std::vector<BackwardType>().swap(trainingMeans);
+		std::vector<BackwardType>().swap(trainingInvStds);
+	}
+
+
+	/*
+	 * @brief Initializes the optimizer (scales and shifts form one vector)
+	 */
+	virtual void initializeOptimizer() override
+	{
+		this->optimizer->initialize(2 * featureNum, 1, Dimensions{ 0, 0, 0 }, 0);
+	}
+
+
+	/*
+	 * @brief Returns expected input size
+	 */
+	virtual Dimensions getInputSize() const override
+	{
+		return inputSize;
+	}
+
+
+	/*
+	 * @brief Returns output size
+	 */
+	virtual Dimensions getOutputSize() const override
+	{
+		return inputSize;
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer output
+	 */
+	virtual Image<_ForwardType> & getOutput() override
+	{
+		return output;
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer gradient output
+	 */
+	virtual Image<BackwardType> & getGradientOutput() override
+	{
+		return gradientOutput;
+	}
+
+
+	/*
+	 * @brief Returns weight of last batch when updating running statistics
+	 */
+	float getMomentum() const
+	{
+		return momentum;
+	}
+
+
+	/*
+	 * @brief Returns value added to variance
+	 */
+	float getEpsilon() const
+	{
+		return epsilon;
+	}
+
+
+	/*
+	 * @brief Returns number of normalized features
+	 */
+	unsigned getFeatureNum() const
+	{
+		return featureNum;
+	}
+
+
+	/*
+	 * @brief Returns feature to which given cell of input belongs
+	 */
+	unsigned getFeature(const unsigned cell) const
+	{
+		return cell / featureSize;
+	}
+
+
+	/*
+	 * @brief Returns learnable scales of features
+	 */
+	std::vector<BackwardType> getScales() const
+	{
+		return std::vector<BackwardType>(parameters.begin(), parameters.begin() + featureNum);
+	}
+
+
+	/*
+	 * @brief Returns learnable shifts of features
+	 */
+	std::vector<BackwardType> getShifts() const
+	{
+		return std::vector<BackwardType>(parameters.begin() + featureNum, parameters.end());
+	}
+
+
+	/*
+	 * @brief Returns running means of features
+	 */
+	const std::vector<BackwardType> & getRunningMeans() const
+	{
+		return runningMeans;
+	}
+
+
+	/*
+	 * @brief Returns running variances of features
+	 */
+	const std::vector<BackwardType> & getRunningVariances() const
+	{
+		return runningVariances;
+	}
+
+
+	/*
+	 * @brief Returns factor by which normalization multiplies given feature (scale / sqrt(variance + epsilon))
+	 */
+	float getNormalizationMultiplier(const unsigned feature) const
+	{
+		return static_cast<float>(parameters[feature]) / sqrt(static_cast<float>(runningVariances[feature]) + epsilon);
+	}
+
+
+	/*
+	 * @brief Returns value normalization adds to given feature after multiplication (shift - mean * multiplier)
+	 */
+	float getNormalizationOffset(const unsigned feature) const
+	{
+		return static_cast<float>(parameters[featureNum + feature]) - static_cast<float>(runningMeans[feature]) * getNormalizationMultiplier(feature);
+	}
+
+
+	/*
+	 * @brief Loads learnable parameters and running statistics
+	 */
+	void loadParameters(const std::vector<BackwardType> & scales, const std::vector<BackwardType> & shifts,
+		const std::vector<BackwardType> & means, const std::vector<BackwardType> & variances)
+	{
+		if (scales.size() != featureNum || shifts.size() != featureNum || means.size() != featureNum || variances.size() != featureNum)
+		{
+			throw BatchNormalizationLayerException("Cannot load parameters of batch normalization due to inconsistent number of features.");
+		}
+
+		std::copy(scales.begin(), scales.end(), parameters.begin());
+		std::copy(shifts.begin(), shifts.end(), parameters.begin() + featureNum);
+		runningMeans = means;
+		runningVariances = variances;
+		hasStatistics = true;
+
+		convertParameters();
+	}
+
+private:
+
+	/*
+	 * @brief Applies precomputed multiplier and offset of feature on each cell (cells are split among threads)
+	 */
+	void normalize(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		ThreadPool::runParallel(in.getFlattenedSize(), 2, [this, &in, &out](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				const auto feature = i / featureSize;
+				out(i) = in(i) * static_cast<_ForwardType>(forwardScales[feature]) + static_cast<_ForwardType>(forwardShifts[feature]);
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Moves running statistics towards mean and unbiased variance of finished batch (for features normalized per sample
+	 *            towards mean of their variances), statistics of first batch are taken as they are unless statistics were loaded
+	 */
+	void updateRunningStatistics()
+	{
+		const auto cellNum = static_cast<double>(examplesSinceUpdate) * featureSize;
+		const auto weight = hasStatistics ? static_cast<double>(momentum) : 1.0;
+
+		for (auto feature = 0u; feature < featureNum; feature++)
+		{
+			const auto mean = batchSums[feature] / cellNum;
+			const auto variance = (featureSize > 1) ? batchSquaredSums[feature] / examplesSinceUpdate
+				: (cellNum > 1.0) ? std::max(0.0, (batchSquaredSums[feature] - cellNum * mean * mean) / (cellNum - 1.0)) : 0.0;
+
+			runningMeans[feature] = static_cast<BackwardType>(static_cast<float>((1.0 - weight) * static_cast<float>(runningMeans[feature]) + weight * mean));
+			runningVariances[feature] = static_cast<BackwardType>(static_cast<float>((1.0 - weight) * static_cast<float>(runningVariances[feature]) + weight * variance));
+
+			batchSums[feature] = 0.0;
+			batchSquaredSums[feature] = 0.0;
+		}
+
+		hasStatistics = true;
+	}
+
+
+	/*
+	 * @brief Converts scales, shifts and statistics to multiplier and offset of each feature in weight type
+	 */
+	void convertParameters()
+	{
+		for (auto feature = 0u; feature < featureNum; feature++)
+		{
+			forwardScales[feature] = static_cast<_WeightType>(getNormalizationMultiplier(feature));
+			forwardShifts[feature] = static_cast<_WeightType>(getNormalizationOffset(feature));
+		}
+	}
+
+private:
+
+	/// Accepted input size (same as output size)
+	Dimensions inputSize;
+
+	/// Weight of statistics of last batch when updating running statistics
+	float momentum;
+
+	/// Added to variance to avoid division by zero
+	float epsilon;
+
+	/// Number of cells of each feature
+	unsigned featureSize;
+
+	/// Number of features
+	unsigned featureNum;
+
+	/// Learnable scales followed by learnable shifts of features (one vector for optimizer)
+	std::vector<BackwardType> parameters;
+
+	/// Deltas for updating parameters (needed for batches)
+	std::vector<BackwardType> deltas;
+
+	/// Running means of features
+	std::vector<BackwardType> runningMeans;
+
+	/// Running variances of features
+	std::vector<BackwardType> runningVariances;
+
+	/// Sums of input values of each feature in unfinished batch
+	std::vector<double> batchSums;
+
+	/// Sums of squared input values of each single cell feature in unfinished batch (sums of unbiased variances of samples for other features)
+	std::vector<double> batchSquaredSums;
+
+	/// Means of features used by last training propagation
+	std::vector<BackwardType> trainingMeans;
+
+	/// Inverse standard deviations of features used by last training propagation
+	std::vector<BackwardType> trainingInvStds;
+
+	/// Running statistics were loaded or computed from at least one batch
+	bool hasStatistics = false;
+
+	/// Number of training examples since updating parameters
+	unsigned examplesSinceUpdate = 0;
+
+	/// Multiplier of each feature converted to weight type (used during forward propagation)
+	std::vector<_WeightType> forwardScales;
+
+	/// Offset of each feature converted to weight type (used during forward propagation)
+	std::vector<_WeightType> forwardShifts;
+
+	/// Output to be forward propagated to next layer
+	Image<_ForwardType> output;
+
+	/// Gradients to be backward propagated to previous layer
+	Image<BackwardType> gradientOutput;
+
+};
+
+#endif
@@ -1,585 +1,810 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Universal convolutional layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef CONVOLUTIONAL_LAYER_H
-#define CONVOLUTIONAL_LAYER_H
-
-#include "src/Layers/ILayer.h"
-
-#include "src/Image.h"
-#include "src/Utils/Limits.h"
-
-#include <algorithm>
-
-/*
- * @brief Exception thrown if problems occur during initialization
- */
-class ConvolutionalLayerException : public CNNException 
-{ 
-	using CNNException::CNNException;
-};
-
-/*
- * @brief Convolutional layer
- */
-template <class _ForwardType, class _WeightType>
-class ConvolutionalLayer : public ILayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Creates Convolutional Layer with given parameters and initializes it for use
-	 *
-	 * @param input          Dimensions of input matrix
-	 * @param stride         Stride with which filter is slided across input
-	 * @param filterNum      Number of 3D filters
-	 * @param filterExtent   Height and width of filters
-	 * @param zeroPadding    Zero padding to be put around input
-	 * @param useBias        Whether to use biases for each filter
-	 */
-	ConvolutionalLayer(
-		const Dimensions & input
-		, const unsigned stride
-		, const unsigned filterNum
-		, const unsigned filterExtent
-		, const unsigned zeroPadding = 0
-		, const bool useBias = true)
-		: inputSize(input)
-		, useBias(useBias)
-		, filterNum(filterNum)
-		, filterExtent(filterExtent)
-		, stride(stride)
-		, zeroPadding(zeroPadding)
-		, gradientOutput(input)
-	{
-		// Check stride
-		if (stride == 0 || filterNum == 0 || filterExtent == 0)
-		{
-			throw ConvolutionalLayerException("Stride, filter extent or filter number were set to zero.");
-		}
-
-		auto multiplier = computeWeightMultiplier();
-
-		// Create empty filters and biases
-		for (auto i = 0u; i < filterNum; i++)
-		{
-			filters.push_back(Image<BackwardType>(Dimensions{ filterExtent, filterExtent, input.depth }));
-			filterDeltas.push_back(Image<BackwardType>(Dimensions{ filterExtent, filterExtent, input.depth }));
-			filterDeltas.back().clear();
-
-			biases.push_back(generateRandomWeight(multiplier));
-			biasDeltas.push_back(0);
-		}
-
-		// Calculate output dimension and check if all parameters work together
-		auto newHeight = (static_cast<int>(inputSize.height) - filterExtent + 2 * zeroPadding) / static_cast<float>(stride) + 1;
-		auto newWidth = (static_cast<int>(inputSize.width) - filterExtent + 2 * zeroPadding) / static_cast<float>(stride) + 1;
-
-		outputSize.width = static_cast<unsigned>(newWidth);
-		outputSize.height = static_cast<unsigned>(newHeight);
-		outputSize.depth = filterNum;
-		windowSize = filterExtent * filterExtent * inputSize.depth;
-
-		// Check that convolution can be applied
-		if ((fabs(newWidth - outputSize.width) > 0.0001f)
-			|| (fabs(newHeight - outputSize.height) > 0.0001f)
-			|| ((inputSize.width + 2 * zeroPadding) < filterExtent)
-			|| ((inputSize.height + 2 * zeroPadding) < filterExtent))
-		{
-			throw ConvolutionalLayerException("Convolutions settings cannot be applied on given input dimensions.");
-		}
-
-		// Initialize output matrix
-		output = Image<_ForwardType>(outputSize);
-		inputEdges.resize(outputSize.width * outputSize.height);
-		filterEdges.resize(outputSize.width * outputSize.height);
-
-		// Initialize filters with random values
-		for (auto f = 0u; f < filterNum; f++)
-		{
-			for (auto i = 0u; i < input.depth; i++)
-			{
-				for (auto j = 0u; j < filterExtent; j++)
-				{
-					for (auto k = 0u; k < filterExtent; k++)
-					{
-						filters[f](k, j, i) = generateRandomWeight(multiplier);
-					}
-				}
-			}
-		}
-
-		createEdges();
-	}
-
-
-	/*
-	 * @brief Propagates the image through convolutional layer obtainign features on output
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input to convolutional layer has different dimensions than declared.");
-		}
-
-		// Slides 3D filter accross matrix and computes output values
-		auto flattenedSize = outputSize.width * outputSize.height;
-
-		// If there is no padding, we may optimize the code
-		if (zeroPadding == 0)
-		{
-			for (auto filter = 0u; filter < filterNum; filter++)
-			{
-				const auto offset = filter * flattenedSize;
-				const auto initAccumValue = (useBias)
-												? (static_cast<_ForwardType>(static_cast<_WeightType>(biases[filter])))
-												: (static_cast<_ForwardType>(0.0f));
-
-				for (auto i = 0u; i < flattenedSize; i++)
-				{
-					auto accum = initAccumValue;
-
-					for (auto k = 0u; k < windowSize; k++)
-					{
-						accum += in(inputEdges[i][k]) * static_cast<_ForwardType>(static_cast<_WeightType>(filters[filter](filterEdges[i][k])));
-					}
-
-					out(i + offset) = accum;
-				}
-			}
-		}
-		else
-		{
-			for (auto filter = 0u; filter < filterNum; filter++)
-			{
-				const auto offset = filter * flattenedSize;
-				const auto initAccumValue = (useBias)
-												? (static_cast<_ForwardType>(static_cast<_WeightType>(biases[filter])))
-												: (static_cast<_ForwardType>(0.0f));
-
-				for (auto i = 0u; i < flattenedSize; i++)
-				{
-					auto accum = initAccumValue;
-
-					for (auto k = 0u; k < windowSize; k++)
-					{
-						if (inputEdges[i][k] >= 0)
-						{
-							accum += in(inputEdges[i][k]) * static_cast<_ForwardType>(static_cast<_WeightType>(filters[filter](filterEdges[i][k])));
-						}
-					}
-
-					out(i + offset) = accum;
-				}
-			}
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*auto currentWidth = static_cast<int>(inputSize.width);
-		auto currentHeight = static_cast<int>(inputSize.height);
-		for (auto filter = 0u; filter < filterNum; filter++)
-		{
-			int filterY = -static_cast<int>(zeroPadding);
-
-			for (auto j = 0u; j < outputSize.height; j++)
-			{
-				int filterX = -static_cast<int>(zeroPadding);
-
-				for (auto k = 0u; k < outputSize.width; k++)
-				{
-					auto accum = static_cast<_ForwardType>(biases[filter]);
-
-					for (auto i = 0u; i < in.getDepth(); i++)
-					{
-						for (auto b = 0u; b < filterExtent; b++)
-						{
-							for (auto a = 0u; a < filterExtent; a++)
-							{
-								int x = filterX + a;
-								int y = filterY + b;
-
-								if (x >= 0 && y >= 0 && x < currentWidth && y < currentHeight)
-								{
-									accum += in(x, y, i) * static_cast<_ForwardType>(filters[filter](a, b, i));
-								}
-							}
-						}
-					}
-
-					filterX += stride;
-					out(k, j, filter) = accum;
-				}
-
-				filterY += stride;
-			}
-		}*/
-	}
-
-
-	/*
-	 * @brief Updated value of filters and biases, computes gradients for previous layer
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> &, const Image<BackwardType> & inGradients, 
-		Image<BackwardType> & outGradients, const TrainingSettings & trainingSettings) override
-	{
-		outGradients.clear();
-
-		// Reverses operation to compute how each input contributed to overall error
-		auto flattenedSize = outputSize.width * outputSize.height;
-
-		// If there is no padding, we may optimize the code
-		if (zeroPadding == 0)
-		{	
-			for (auto filter = 0u; filter < filterNum; filter++)
-			{
-				const auto offset = filter * flattenedSize;
-
-				for (auto i = 0u; i < flattenedSize; i++)
-				{
-					const auto index = i + offset;
-					biasDeltas[filter] += inGradients(index);
-
-					for (auto k = 0u; k < windowSize; k++)
-					{
-						outGradients(inputEdges[i][k]) += filters[filter](filterEdges[i][k]) * inGradients(index);
-						filterDeltas[filter](filterEdges[i][k]) += inGradients(index) * static_cast<BackwardType>(in(inputEdges[i][k]));
-					}
-				}
-			}
-		}
-		else
-		{
-			for (auto filter = 0u; filter < filterNum; filter++)
-			{
-				const auto offset = filter * flattenedSize;
-
-				for (auto i = 0u; i < flattenedSize; i++)
-				{
-					const auto index = i + offset;
-					biasDeltas[filter] += inGradients(index);
-
-					for (auto k = 0u; k < windowSize; k++)
-					{
-						if (inputEdges[i][k] >= 0)
-						{
-							outGradients(inputEdges[i][k]) += filters[filter](filterEdges[i][k]) * inGradients(index);
-							filterDeltas[filter](filterEdges[i][k]) += inGradients(index) * static_cast<BackwardType>(in(inputEdges[i][k]));
-						}
-					}
-				}
-			}
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*for (auto k = 0u; k < filterNum; k++)
-		{
-			for (auto x = 0u; x < in.getWidth(); x++)
-			{
-				for (auto y = 0u; y < in.getHeight(); y++)
-				{
-					// Find output coordinates that this input pixel affected
-					int Xmin = std::max(0, static_cast<int>((static_cast<int>(x) - filterExtent + 1) / stride));
-					int Xmax = x / stride;
-					int Ymin = std::max(0, static_cast<int>((static_cast<int>(y) - filterExtent + 1) / stride));
-					int Ymax = y / stride;
-
-					for (auto z = 0u; z < in.getDepth(); z++)
-					{
-						for (auto i = Xmin; i <= Xmax; i++)
-						{
-							int minx = i * stride;
-							for (int j = Ymin; j <= Ymax; j++)
-							{
-								int miny = j * stride;
-
-								outGradients(x, y, z) += filters[k](x - minx, y - miny, z) * inGradients(i, j, k);
-
-								filterDeltas[k](x - minx, y - miny, z) += inGradients(i, j, k) * static_cast<BackwardType>(in(x, y, z));
-								biasDeltas[k] += inGradients(i, j, k) / (filterExtent * filterExtent);
-							}
-						}
-					}
-				}
-			}
-		}*/
-
-		// Update weights one batch size is met
-		if (++examplesSinceUpdate == trainingSettings.batchSize)
-		{
-			this->optimizer->updateWeights(filters, filterDeltas, examplesSinceUpdate);
-			this->optimizer->updateWeights(biases, biasDeltas, examplesSinceUpdate);
-			examplesSinceUpdate = 0;
-		}
-	}
-
-
-	/*
-	 * @brief Initializes the optimizer
-	 */
-	virtual void initializeOptimizer() override
-	{
-		this->optimizer->initialize(filterNum, 1, filters[0].getDimensions(), filterNum);
-	}
-
-
-	/*
-	 * @brief Returns a reference to layer output
-	 */
-	virtual Image<_ForwardType> & getOutput() override
-	{
-		return output;
-	}
-
-
-	/*
-	 * @brief Returns a reference to layer gradient output
-	 */
-	virtual Image<BackwardType> & getGradientOutput() override
-	{
-		return gradientOutput;
-	}
-
-
-	/*
-	 * @brief Returns expected input size
-	 */
-	virtual Dimensions getInputSize() const override
-	{
-		return inputSize;
-	}
-
-
-	/*
-	 * @brief Returns output size
-	 */
-	virtual Dimensions getOutputSize() const override
-	{
-		return outputSize;
-	}
-
-
-	/*
-	 * @brief Returns stride
-	 */
-	unsigned getStride() const
-	{
-		return stride;
-	}
-
-
-	/*
-	 * @brief Returns filter extent
-	 */
-	unsigned getExtent() const
-	{
-		return filterExtent;
-	}
-
-
-	/*
-	 * @brief Returns number of filters (and feature maps)
-	 */
-	unsigned getFilterNum() const
-	{
-		return filterNum;
-	}
-
-
-	/*
-	 * @brief Returns if bias is used
-	 */
-	bool usesBias() const
-	{
-		return useBias;
-	}
-
-
-	/*
-	 * @brief Returns amount of zero padding used
-	 */
-	unsigned getZeroPadding() const
-	{
-		return zeroPadding;
-	}
-
-
-	/*
-	 * @brief Returns filter values
-	 */
-	std::vector<Image<BackwardType>> getFilters() const
-	{
-		return filters;
-	}
-
-
-	/*
-	 * @brief Returns bias values
-	 */
-	std::vector<BackwardType> getBiases() const
-	{
-		return biases;
-	}
-
-
-	/*
-	 * @brief Loads filter and bias values
-	 */
-	void loadFilters(const std::vector<Image<BackwardType>> & fs, const std::vector<BackwardType> & b = {})
-	{
-		if (fs.size() != filterNum || (useBias && b.size() != filterNum))
-		{
-			throw ConvolutionalLayerException("Cannot load filters due to inconsistent amounts of filters and/or biases.");
-		}
-
-		for (const auto & f : fs)
-		{
-			if (f.getHeight() != filterExtent || f.getWidth() != filterExtent || f.getDepth() != inputSize.depth)
-			{
-				throw ConvolutionalLayerException("Cannot load filters due to inconsistent dimensions of filters.");
-			}
-		}
-
-		biases = b;
-
-		filters = fs;
-	}
-
-private:
-
-	/*
-	 * @brief Creates edges to make convolution operation faster
-	 */
-	void createEdges()
-	{
-		auto currentWidth = static_cast<int>(inputSize.width);
-		auto currentHeight = static_cast<int>(inputSize.height);
-
-		for (auto filter = 0u; filter < filterNum; filter++)
-		{
-			int filterY = -static_cast<int>(zeroPadding);
-			for (auto j = 0u; j < outputSize.height; j++)
-			{
-				int filterX = -static_cast<int>(zeroPadding);
-				for (auto k = 0u; k < outputSize.width; k++)
-				{
-					for (auto i = 0u; i < inputSize.depth; i++)
-					{
-						for (auto b = 0u; b < filterExtent; b++)
-						{
-							for (auto a = 0u; a < filterExtent; a++)
-							{
-								int x = filterX + a;
-								int y = filterY + b;
-
-								if (x >= 0 && y >= 0 && x < currentWidth && y < currentHeight)
-								{
-									inputEdges[k + j * outputSize.width].push_back(i * inputSize.height * inputSize.width + y * inputSize.width + x);
-								}
-								else
-								{
-									inputEdges[k + j * outputSize.width].push_back(-1);
-								}
-
-								filterEdges[k + j * outputSize.width].push_back(i * filterExtent * filterExtent + b * filterExtent + a);
-							}
-						}
-					}
-					filterX += stride;
-				}
-				filterY += stride;
-			}
-		}
-	}
-
-
-	/*
-	 * @brief If we are using type with just a few bits we may have as low precision at the beginning that
-	 *             all weights are zeroes. We need to counter that.
-	 */
-	float computeWeightMultiplier()
-	{
-		auto epsValue = static_cast<float>(Limits::getEpsilonValue<_WeightType>());
-		auto maxWeight = (1.0f / (filterExtent * filterExtent * inputSize.depth)) / 1.25f;
-		auto multiplier = 1.0f;
-
-		while ((maxWeight * multiplier) < epsValue)
-		{
-			multiplier += 1.0f;
-		}
-
-		return multiplier;
-	}
-
-	/*
-	 * @brief Generates random weight
-	 */
-	BackwardType generateRandomWeight(float multiplier = 1.0f) const
-	{
-		auto randomVal = (static_cast<float>(rand()) / RAND_MAX) * 2 - 1;
-		return static_cast<BackwardType>(multiplier * randomVal * (1.0f / (filterExtent * filterExtent * inputSize.depth)));
-	}
-
-protected:
-
-	/// Edges used to speed up convolution
-	std::vector<std::vector<int>> inputEdges;
-	std::vector<std::vector<int>> filterEdges;
-
-	/// 3D size of filter
-	unsigned windowSize;
-
-	/// Accepted input size
-	Dimensions inputSize;
-
-	/// Output size
-	Dimensions outputSize;
-
-	/// Whether to use bias
-	bool useBias = false;
-
-	/// Number of filters
-	unsigned filterNum;
-
-	/// Size of filters
-	unsigned filterExtent;
-
-	/// Stride
-	unsigned stride;
-
-	/// Number of zero borders added aroung the image
-	unsigned zeroPadding;
-
-	/// Number of examples since last update of filters/biases
-	unsigned examplesSinceUpdate = 0;
-
-	/// Filters
-	std::vector<Image<BackwardType>> filters;
-
-	/// Filter deltas
-	std::vector<Image<BackwardType>> filterDeltas;
-
-	/// Biases
-	std::vector<BackwardType> biases;
-
-	/// Bias deltas
-	std::vector<BackwardType> biasDeltas;
-
-	/// Output to be forward propagated to next layer
-	Image<_ForwardType> output;
-
-	/// Gradients to be backward propagated to previous layer
-	Image<BackwardType> gradientOutput;
-
-
-};
-
-#endif
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Universal convolutional layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef CONVOLUTIONAL_LAYER_H
+#define CONVOLUTIONAL_LAYER_H
+
+#include "src/Layers/ILayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/Limits.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+/*
+ * @brief Exception thrown if problems occur during initialization
+ */
+class ConvolutionalLayerException : public CNNException 
+{ 
+	using CNNException::CNNException;
+};
+
+/*
+ * @brief Convolutional layer
+ */
+template <class _ForwardType, class _WeightType>
+class ConvolutionalLayer : public ILayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Creates Convolutional Layer with given parameters and initializes it for use
+	 *
+	 * @param input          Dimensions of input matrix
+	 * @param stride         Stride with which filter is slided across input
+	 * @param filterNum      Number of 3D filters
+	 * @param filterExtent   Height and width of filters
+	 * @param zeroPadding    Zero padding to be put around input
+	 * @param useBias        Whether to use biases for each filter
+	 * @param inferenceOnly  Layer is used only for forward propagation, gradients, deltas and master filters are not allocated
+	 */
+	ConvolutionalLayer(
+		const Dimensions & input
+		, const unsigned stride
+		, const unsigned filterNum
+		, const unsigned filterExtent
+		, const unsigned zeroPadding = 0
+		, const bool useBias = true
+		, const bool inferenceOnly = false)
+		: inputSize(input)
+		, useBias(useBias)
+		, filterNum(filterNum)
+		, filterExtent(filterExtent)
+		, stride(stride)
+		, zeroPadding(zeroPadding)
+		, gradientOutput(inferenceOnly ? Image<BackwardType>() : Image<BackwardType>(input))
+	{
+		// Check stride
+		if (stride == 0 || filterNum == 0 || filterExtent == 0)
+		{
+			throw ConvolutionalLayerException("Stride, filter extent or filter number were set to zero.");
+		}
+
+		auto multiplier = computeWeightMultiplier();
+
+		// Create empty filters and biases (without master copies directly in forward type)
+		for (auto i = 0u; i < filterNum; i++)
+		{
+			if (inferenceOnly)
+			{
+				forwardFilters.push_back(Image<_WeightType>(Dimensions{ filterExtent, filterExtent, input.depth }));
+				forwardBiases.push_back(static_cast<_WeightType>(generateRandomWeight(multiplier)));
+				continue;
+			}
+
+			filters.push_back(Image<BackwardType>(Dimensions{ filterExtent, filterExtent, input.depth }));
+			filterDeltas.push_back(Image<BackwardType>(Dimensions{ filterExtent, filterExtent, input.depth }));
+			filterDeltas.back().clear();
+
+			biases.push_back(generateRandomWeight(multiplier));
+			biasDeltas.push_back(0);
+		}
+
+		// Calculate output dimension and check if all parameters work together
+		auto newHeight = (static_cast<int>(inputSize.height) - filterExtent + 2 * zeroPadding) / static_cast<float>(stride) + 1;
+		auto newWidth = (static_cast<int>(inputSize.width) - filterExtent + 2 * zeroPadding) / static_cast<float>(stride) + 1;
+
+		outputSize.width = static_cast<unsigned>(newWidth);
+		outputSize.height = static_cast<unsigned>(newHeight);
+		outputSize.depth = filterNum;
+		windowSize = filterExtent * filterExtent * inputSize.depth;
+
+		// Check that convolution can be applied
+		if ((fabs(newWidth - outputSize.width) > 0.0001f)
+			|| (fabs(newHeight - outputSize.height) > 0.0001f)
+			|| ((inputSize.width + 2 * zeroPadding) < filterExtent)
+			|| ((inputSize.height + 2 * zeroPadding) < filterExtent))
+		{
+			throw ConvolutionalLayerException("Convolutions settings cannot be applied on given input dimensions.");
+		}
+
+		// Initialize output matrix
+		output = Image<_ForwardType>(outputSize);
+		inputEdges.resize(outputSize.width * outputSize.height);
+		filterEdges.resize(outputSize.width * outputSize.height);
+
+		// Initialize filters with random values
+		for (auto f = 0u; f < filterNum; f++)
+		{
+			for (auto i = 0u; i < input.depth; i++)
+			{
+				for (auto j = 0u; j < filterExtent; j++)
+				{
+					for (auto k = 0u; k < filterExtent; k++)
+					{
+						if (inferenceOnly)
+						{
+							forwardFilters[f](k, j, i) = static_cast<_WeightType>(generateRandomWeight(multiplier));
+						}
+						else
+						{
+							filters[f](k, j, i) = generateRandomWeight(multiplier);
+						}
+					}
+				}
+			}
+		}
+
+		convertWeights();
+		createEdges();
+	}
+
+
+	/*
+	 * @brief Propagates the image through convolutional layer obtainign features on output
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input to convolutional layer has different dimensions than declared.");
+		}
+
+		if (zeroPadding == 0)
+		{
+			(useBias) ? convolve<false, true>(in, out) : convolve<false, false>(in, out);
+		}
+		else
+		{
+			(useBias) ? convolve<true, true>(in, out) : convolve<true, false>(in, out);
+		}
+
+		// Slower, but more descriptive implementation for future reference
+		/*auto currentWidth = static_cast<int>(inputSize.width);
+		auto currentHeight = static_cast<int>(inputSize.height);
+		for (auto filter = 0u; filter < filterNum; filter++)
+		{
+			int filterY = -static_cast<int>(zeroPadding);
+
+			for (auto j = 0u; j < outputSize.height; j++)
+			{
+				int filterX = -static_cast<int>(zeroPadding);
+
+				for (auto k = 0u; k < outputSize.width; k++)
+				{
+					auto accum = static_cast<_ForwardType>(biases[filter]);
+
+					for (auto i = 0u; i < in.getDepth(); i++)
+					{
+						for (auto b = 0u; b < filterExtent; b++)
+						{
+							for (auto a = 0u; a < filterExtent; a++)
+							{
+								int x = filterX + a;
+								int y = filterY + b;
+
+								if (x >= 0 && y >= 0 && x < currentWidth && y < currentHeight)
+								{
+									accum += in(x, y, i) * static_cast<_ForwardType>(filters[filter](a, b, i));
+								}
+							}
+						}
+					}
+
+					filterX += stride;
+					out(k, j, filter) = accum;
+				}
+
+				filterY += stride;
+			}
+		}*/
+	}
+
+
+	/*
+	 * @brief Computes single output value of given filter (used also by kernels fused with following layers)
+	 */
+	template <bool _Padded, bool _Biased>
+	_ForwardType convolveCell(const Image<_ForwardType> & in, const unsigned filter, const unsigned cell) const
+	{
+		auto accum = (_Biased)
+						? (static_cast<_ForwardType>(forwardBiases[filter]))
+						: (static_cast<_ForwardType>(0.0f));
+
+		for (auto k = 0u; k < windowSize; k++)
+		{
+			// Edges leading into padding are negative
+			if (!_Padded || inputEdges[cell][k] >= 0)
+			{
+				accum += in(inputEdges[cell][k]) * static_cast<_ForwardType>(forwardFilters[filter](filterEdges[cell][k]));
+			}
+		}
+
+		return accum;
+	}
+
+
+	/*
+	 * @brief Selects convolution specialized for padding and bias of this layer
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = ConvolutionalLayer<_ForwardType, _WeightType>;
+		using Base = ILayer<_ForwardType, _WeightType>;
+
+		if (zeroPadding == 0)
+		{
+			return (useBias) ? &Base::template invokeKernel<Layer, &Layer::template convolve<false, true>>
+			                 : &Base::template invokeKernel<Layer, &Layer::template convolve<false, false>>;
+		}
+
+		return (useBias) ? &Base::template invokeKernel<Layer, &Layer::template convolve<true, true>>
+		                 : &Base::template invokeKernel<Layer, &Layer::template convolve<true, false>>;
+	}
+
+
+	/*
+	 * @brief Updated value of filters and biases, computes gradients for previous layer
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> &, const Image<BackwardType> & inGradients, 
+		Image<BackwardType> & outGradients, const TrainingSettings & trainingSettings) override
+	{
+		outGradients.clear();
+
+		// Reverses operation to compute how each input contributed to overall error
+		auto flattenedSize = outputSize.width * outputSize.height;
+
+		if (ThreadPool::getParallelThreshold() <= static_cast<size_t>(filterNum) * flattenedSize * windowSize && ThreadPool::getShared().getThreadNum() > 1)
+		{
+			parallelBackwardPropagation(in, inGradients, outGradients);
+		}
+		// If there is no padding, we may optimize the code
+		else if (zeroPadding == 0)
+		{	
+			for (auto filter = 0u; filter < filterNum; filter++)
+			{
+				const auto offset = filter * flattenedSize;
+
+				for (auto i = 0u; i < flattenedSize; i++)
+				{
+					const auto index = i + offset;
+					biasDeltas[filter] += inGradients(index);
+
+					for (auto k = 0u; k < windowSize; k++)
+					{
+						outGradients(inputEdges[i][k]) += filters[filter](filterEdges[i][k]) * inGradients(index);
+						filterDeltas[filter](filterEdges[i][k]) += inGradients(index) * static_cast<BackwardType>(in(inputEdges[i][k]));
+					}
+				}
+			}
+		}
+		else
+		{
+			for (auto filter = 0u; filter < filterNum; filter++)
+			{
+				const auto offset = filter * flattenedSize;
+
+				for (auto i = 0u; i < flattenedSize; i++)
+				{
+					const auto index = i + offset;
+					biasDeltas[filter] += inGradients(index);
+
+					for (auto k = 0u; k < windowSize; k++)
+					{
+						if (inputEdges[i][k] >= 0)
+						{
+							outGradients(inputEdges[i][k]) += filters[filter](filterEdges[i][k]) * inGradients(index);
+							filterDeltas[filter](filterEdges[i][k]) += inGradients(index) * static_cast<BackwardType>(in(inputEdges[i][k]));
+						}
+					}
+				}
+			}
+		}
+
+		// Slower, but more descriptive implementation for future reference
+		/*for (auto k = 0u; k < filterNum; k++)
+		{
+			for (auto x = 0u; x < in.getWidth(); x++)
+			{
+				for (auto y = 0u; y < in.getHeight(); y++)
+				{
+					// Find output coordinates that this input pixel affected
+					int Xmin = std::max(0, static_cast<int>((static_cast<int>(x) - filterExtent + 1) / stride));
+					int Xmax = x / stride;
+					int Ymin = std::max(0, static_cast<int>((static_cast<int>(y) - filterExtent + 1) / stride));
+					int Ymax = y / stride;
+
+					for (auto z = 0u; z < in.getDepth(); z++)
+					{
+						for (auto i = Xmin; i <= Xmax; i++)
+						{
+							int minx = i * stride;
+							for (int j = Ymin; j <= Ymax; j++)
+							{
+								int miny = j * stride;
+
+								outGradients(x, y, z) += filters[k](x - minx, y - miny, z) * inGradients(i, j, k);
+
+								filterDeltas[k](x - minx, y - miny, z) += inGradients(i, j, k) * static_cast<BackwardType>(in(x, y, z));
+								biasDeltas[k] += inGradients(i, j, k) / (filterExtent * filterExtent);
+							}
+						}
+					}
+				}
+			}
+		}*/
+
+		// Update weights one batch size is met
+		if (++examplesSinceUpdate == trainingSettings.batchSize)
+		{
+			this->optimizer->updateWeights(filters, filterDeltas, examplesSinceUpdate);
+			this->optimizer->updateWeights(biases, biasDeltas, examplesSinceUpdate);
+			examplesSinceUpdate = 0;
+			convertWeights();
+		}
+	}
+
+
+	/*
+	 * @brief Backward propagation uses only input of this layer
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Frees gradients, deltas and master copies of filters (forward uses converted ones)
+	 */
+	virtual void releaseTrainingState() override
+	{
+		ILayer<_ForwardType, _WeightType>::releaseTrainingState();
+
+		std::vector<Image<BackwardType>>().swap(filters);
+		std::vector<Image<BackwardType>>().swap(filterDeltas);
+		std::vector<BackwardType>().swap(biases);
+		std::vector<BackwardType>().swap(biasDeltas);
+		std::vector<std::vector<std::pair<unsigned, unsigned>>>().swap(gradientEdges);
+	}
+
+
+	/*
+	 * @brief Initializes the optimizer
+	 */
+	virtual void initializeOptimizer() override
+	{
+		this->optimizer->initialize(filterNum, 1, filters[0].getDimensions(), filterNum);
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer output
+	 */
+	virtual Image<_ForwardType> & getOutput() override
+	{
+		return output;
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer gradient output
+	 */
+	virtual Image<BackwardType> & getGradientOutput() override
+	{
+		return gradientOutput;
+	}
+
+
+	/*
+	 * @brief Returns expected input size
+	 */
+	virtual Dimensions getInputSize() const override
+	{
+		return inputSize;
+	}
+
+
+	/*
+	 * @brief Returns output size
+	 */
+	virtual Dimensions getOutputSize() const override
+	{
+		return outputSize;
+	}
+
+
+	/*
+	 * @brief Returns stride
+	 */
+	unsigned getStride() const
+	{
+		return stride;
+	}
+
+
+	/*
+	 * @brief Returns filter extent
+	 */
+	unsigned getExtent() const
+	{
+		return filterExtent;
+	}
+
+
+	/*
+	 * @brief Returns number of filters (and feature maps)
+	 */
+	unsigned getFilterNum() const
+	{
+		return filterNum;
+	}
+
+
+	/*
+	 * @brief Returns if bias is used
+	 */
+	bool usesBias() const
+	{
+		return useBias;
+	}
+
+
+	/*
+	 * @brief Returns amount of zero padding used
+	 */
+	unsigned getZeroPadding() const
+	{
+		return zeroPadding;
+	}
+
+
+	/*
+	 * @brief Returns filter values (converted back from forward filters if training state was released)
+	 */
+	std::vector<Image<BackwardType>> getFilters() const
+	{
+		if (!filters.empty())
+		{
+			return filters;
+		}
+
+		std::vector<Image<BackwardType>> out;
+		for (const auto & f : forwardFilters)
+		{
+			Image<BackwardType> filter(f.getDimensions());
+			for (auto i = 0u; i < f.getFlattenedSize(); i++)
+			{
+				filter(i) = static_cast<BackwardType>(static_cast<float>(f(i)));
+			}
+			out.push_back(filter);
+		}
+		return out;
+	}
+
+
+	/*
+	 * @brief Returns bias values (converted back from forward biases if training state was released)
+	 */
+	std::vector<BackwardType> getBiases() const
+	{
+		if (!filters.empty())
+		{
+			return biases;
+		}
+
+		std::vector<BackwardType> out;
+		for (auto b : forwardBiases)
+		{
+			out.push_back(static_cast<BackwardType>(static_cast<float>(b)));
+		}
+		return out;
+	}
+
+
+	/*
+	 * @brief Loads filter and bias values (only converted ones if training state was released)
+	 */
+	void loadFilters(const std::vector<Image<BackwardType>> & fs, const std::vector<BackwardType> & b = {})
+	{
+		if (fs.size() != filterNum || (useBias && b.size() != filterNum))
+		{
+			throw ConvolutionalLayerException("Cannot load filters due to inconsistent amounts of filters and/or biases.");
+		}
+
+		for (const auto & f : fs)
+		{
+			if (f.getHeight() != filterExtent || f.getWidth() != filterExtent || f.getDepth() != inputSize.depth)
+			{
+				throw ConvolutionalLayerException("Cannot load filters due to inconsistent dimensions of filters.");
+			}
+		}
+
+		if (filters.empty())
+		{
+			for (auto f = 0u; f < filterNum; f++)
+			{
+				ILayer<_ForwardType, _WeightType>::copyWeights(fs[f], forwardFilters[f]);
+			}
+
+			forwardBiases.clear();
+			for (auto bias : b)
+			{
+				forwardBiases.push_back(static_cast<_WeightType>(bias));
+			}
+			return;
+		}
+
+		biases = b;
+
+		filters = fs;
+
+		convertWeights();
+	}
+
+private:
+
+	/*
+	 * @brief Slides 3D filter accross matrix and computes output values (padding and bias are chosen at compile time),
+	 *            outputs of all filters are split among threads
+	 */
+	template <bool _Padded, bool _Biased>
+	void convolve(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto flattenedSize = outputSize.width * outputSize.height;
+
+		ThreadPool::runParallel(filterNum * flattenedSize, windowSize, [this, &in, &out, flattenedSize](size_t first, size_t last)
+		{
+			for (auto filter = static_cast<unsigned>(first / flattenedSize); filter * flattenedSize < last; filter++)
+			{
+				const auto offset = filter * flattenedSize;
+				const auto begin = static_cast<unsigned>(std::max<size_t>(first, offset) - offset);
+				const auto end = static_cast<unsigned>(std::min<size_t>(last, offset + flattenedSize) - offset);
+
+				for (auto i = begin; i < end; i++)
+				{
+					out(i + offset) = convolveCell<_Padded, _Biased>(in, filter, i);
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Backward propagation split among threads, results are identical to serial version
+	 *
+	 * Deltas are split by filters. Gradient of each input cell is gathered by one thread from all outputs
+	 * it contributed to, in the same order in which serial version scatters them, so no reduction is needed.
+	 */
+	void parallelBackwardPropagation(const Image<_ForwardType> & in, const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients)
+	{
+		const auto flattenedSize = outputSize.width * outputSize.height;
+
+		ThreadPool::runParallel(filterNum, flattenedSize * windowSize, [this, &in, &inGradients, flattenedSize](size_t first, size_t last)
+		{
+			for (auto filter = static_cast<unsigned>(first); filter < last; filter++)
+			{
+				const auto offset = filter * flattenedSize;
+
+				for (auto i = 0u; i < flattenedSize; i++)
+				{
+					const auto index = i + offset;
+					biasDeltas[filter] += inGradients(index);
+
+					for (auto k = 0u; k < windowSize; k++)
+					{
+						if (inputEdges[i][k] >= 0)
+						{
+							filterDeltas[filter](filterEdges[i][k]) += inGradients(index) * static_cast<BackwardType>(in(inputEdges[i][k]));
+						}
+					}
+				}
+			}
+		});
+
+		if (gradientEdges.empty())
+		{
+			createGradientEdges();
+		}
+
+		ThreadPool::runParallel(gradientEdges.size(), filterNum * windowSize, [this, &inGradients, &outGradients, flattenedSize](size_t first, size_t last)
+		{
+			for (auto cell = first; cell < last; cell++)
+			{
+				auto accum = outGradients(static_cast<unsigned>(cell));
+				for (auto filter = 0u; filter < filterNum; filter++)
+				{
+					const auto offset = filter * flattenedSize;
+					for (const auto & edge : gradientEdges[cell])
+					{
+						accum += filters[filter](edge.second) * inGradients(edge.first + offset);
+					}
+				}
+				outGradients(static_cast<unsigned>(cell)) = accum;
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Creates reverse edges (output position and filter position for each input cell) used by parallel backward propagation
+	 */
+	void createGradientEdges()
+	{
+		gradientEdges.resize(inputSize.width * inputSize.height * inputSize.depth);
+
+		for (auto i = 0u; i < outputSize.width * outputSize.height; i++)
+		{
+			for (auto k = 0u; k < windowSize; k++)
+			{
+				if (inputEdges[i][k] >= 0)
+				{
+					gradientEdges[inputEdges[i][k]].emplace_back(i, filterEdges[i][k]);
+				}
+			}
+		}
+	}
+
+
+	/*
+	 * @brief Creates edges to make convolution operation faster
+	 */
+	void createEdges()
+	{
+		auto currentWidth = static_cast<int>(inputSize.width);
+		auto currentHeight = static_cast<int>(inputSize.height);
+
+		for (auto filter = 0u; filter < filterNum; filter++)
+		{
+			int filterY = -static_cast<int>(zeroPadding);
+			for (auto j = 0u; j < outputSize.height; j++)
+			{
+				int filterX = -static_cast<int>(zeroPadding);
+				for (auto k = 0u; k < outputSize.width; k++)
+				{
+					for (auto i = 0u; i < inputSize.depth; i++)
+					{
+						for (auto b = 0u; b < filterExtent; b++)
+						{
+							for (auto a = 0u; a < filterExtent; a++)
+							{
+								int x = filterX + a;
+								int y = filterY + b;
+
+								if (x >= 0 && y >= 0 && x < currentWidth && y < currentHeight)
+								{
+									inputEdges[k + j * outputSize.width].push_back(i * inputSize.height * inputSize.width + y * inputSize.width + x);
+								}
+								else
+								{
+									inputEdges[k + j * outputSize.width].push_back(-1);
+								}
+
+								filterEdges[k + j * outputSize.width].push_back(i * filterExtent * filterExtent + b * filterExtent + a);
+							}
+						}
+					}
+					filterX += stride;
+				}
+				filterY += stride;
+			}
+		}
+	}
+
+
+	/*
+	 * @brief Converts master copies of filters and biases to type used during forward propagation
+	 *            (filters are shared if types are the same)
+	 */
+	void convertWeights()
+	{
+		if (filters.empty())
+		{
+			return;
+		}
+
+		forwardFilters.resize(filters.size());
+		for (auto f = 0u; f < filters.size(); f++)
+		{
+			ILayer<_ForwardType, _WeightType>::shareOrConvertWeights(filters[f], forwardFilters[f]);
+		}
+
+		forwardBiases.resize(biases.size());
+		for (auto b = 0u; b < biases.size(); b++)
+		{
+			forwardBiases[b] = static_cast<_WeightType>(biases[b]);
+		}
+	}
+
+
+	/*
+	 * @brief If we are using type with just a few bits we may have as low precision at the beginning that
+	 *             all weights are zeroes. We need to counter that.
+	 */
+	float computeWeightMultiplier()
+	{
+		auto epsValue = static_cast<float>(Limits::getEpsilonValue<_WeightType>());
+		auto maxWeight = (1.0f / (filterExtent * filterExtent * inputSize.depth)) / 1.25f;
+		auto multiplier = 1.0f;
+
+		while ((maxWeight * multiplier) < epsValue)
+		{
+			multiplier += 1.0f;
+		}
+
+		return multiplier;
+	}
+
+	/*
+	 * @brief Generates random weight
+	 */
+	BackwardType generateRandomWeight(float multiplier = 1.0f) const
+	{
+		auto randomVal = (static_cast<float>(rand()) / RAND_MAX) * 2 - 1;
+		return static_cast<BackwardType>(multiplier * randomVal * (1.0f / (filterExtent * filterExtent * inputSize.depth)));
+	}
+
+protected:
+
+	/// Edges used to speed up convolution
+	std::vector<std::vector<int>> inputEdges;
+	std::vector<std::vector<int>> filterEdges;
+
+	/// Output positions and filter positions each input cell contributed to (created by first parallel backward propagation)
+	std::vector<std::vector<std::pair<unsigned, unsigned>>> gradientEdges;
+
+	/// 3D size of filter
+	unsigned windowSize;
+
+	/// Accepted input size
+	Dimensions inputSize;
+
+	/// Output size
+	Dimensions outputSize;
+
+	/// Whether to use bias
+	bool useBias = false;
+
+	/// Number of filters
+	unsigned filterNum;
+
+	/// Size of filters
+	unsigned filterExtent;
+
+	/// Stride
+	unsigned stride;
+
+	/// Number of zero borders added aroung the image
+	unsigned zeroPadding;
+
+	/// Number of examples since last update of filters/biases
+	unsigned examplesSinceUpdate = 0;
+
+	/// Filters
+	std::vector<Image<BackwardType>> filters;
+
+	/// Filter deltas
+	std::vector<Image<BackwardType>> filterDeltas;
+
+	/// Biases
+	std::vector<BackwardType> biases;
+
+	/// Bias deltas
+	std::vector<BackwardType> biasDeltas;
+
+	/// Filters converted to weight type (used during forward propagation, share memory with filters of the same type)
+	std::vector<Image<_WeightType>> forwardFilters;
+
+	/// Biases converted to weight type (used during forward propagation)
+	std::vector<_WeightType> forwardBiases;
+
+	/// Output to be forward propagated to next layer
+	Image<_ForwardType> output;
+
+	/// Gradients to be backward propagated to previous layer
+	Image<BackwardType> gradientOutput;
+
+
+};
+
+#endif
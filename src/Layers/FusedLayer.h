@@ -0,0 +1,386 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Layer running convolution or fully connected layer together with following pooling and activation
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef FUSED_LAYER_H
+#define FUSED_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/PoolingLayer.h"
+#include "src/Layers/ActivationLayer.h"
+#include "src/Layers/LeakyReluActivationLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/SigmoidActivationLayer.h"
+#include "src/Layers/TanhActivationLayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/Limits.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <memory>
+#include <vector>
+
+/*
+ * @brief Runs convolution (or fully connected layer) with following elementwise activation and non-overlapping pooling
+ *            in one pass, only final values are written (used only by compiled execution plan)
+ *
+ * Layers stay part of network and keep their own buffers for training, fused layer only reads their weights,
+ * so gradients are not affected. Values are computed in the same order as by separate layers, results are identical.
+ */
+template <class _ForwardType, class _WeightType>
+class FusedLayer : public ILayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Fuses given layers (pooling or activation may be null)
+	 *
+	 * @param producer          Convolutional or fully connected layer
+	 * @param pooling           Pooling layer following producer (only after convolution)
+	 * @param activation        Elementwise activation layer following producer
+	 * @param activationFirst   Activation precedes pooling
+	 */
+	FusedLayer(const std::shared_ptr<ILayer<_ForwardType, _WeightType>> & producer,
+		const std::shared_ptr<PoolingLayer<_ForwardType, _WeightType>> & pooling,
+		const std::shared_ptr<ActivationLayer<_ForwardType, _WeightType>> & activation,
+		const bool activationFirst)
+		: producer(producer)
+		, convolution(std::dynamic_pointer_cast<ConvolutionalLayer<_ForwardType, _WeightType>>(producer))
+		, fullyConnected(std::dynamic_pointer_cast<FullyConnectedLayer<_ForwardType, _WeightType>>(producer))
+		, pooling(pooling)
+		, activation(activation)
+		, activationFirst(activationFirst)
+	{
+		if (!convolution && !fullyConnected)
+		{
+			throw CNNException("Only convolutional and fully connected layers may be fused.");
+		}
+	}
+
+
+	/*
+	 * @brief Fuses layers starting at given position if they form supported pattern
+	 *
+	 * Supported patterns are convolution followed by pooling and/or activation (in any order)
+	 * and fully connected layer followed by activation.
+	 *
+	 * @param  layers   Layers used during inference (shapes already validated)
+	 * @param  first    Position of convolutional or fully connected layer
+	 *
+	 * @return fused    Fused layer or null if nothing can be fused
+	 */
+	static std::shared_ptr<FusedLayer> tryFusing(const std::vector<std::shared_ptr<ILayer<_ForwardType, _WeightType>>> & layers, const unsigned first)
+	{
+		const auto & producer = layers[first];
+		auto isConvolution = static_cast<bool>(std::dynamic_pointer_cast<ConvolutionalLayer<_ForwardType, _WeightType>>(producer));
+		if (!isConvolution && !std::dynamic_pointer_cast<FullyConnectedLayer<_ForwardType, _WeightType>>(producer))
+		{
+			return nullptr;
+		}
+
+		std::shared_ptr<PoolingLayer<_ForwardType, _WeightType>> pooling;
+		std::shared_ptr<ActivationLayer<_ForwardType, _WeightType>> activation;
+		auto activationFirst = false;
+
+		for (auto i = first + 1; i < layers.size() && i <= first + 2; i++)
+		{
+			if (!pooling && isConvolution && isFusablePooling(layers[i]))
+			{
+				pooling = std::static_pointer_cast<PoolingLayer<_ForwardType, _WeightType>>(layers[i]);
+			}
+			else if (!activation && isFusableActivation(layers[i]))
+			{
+				activation = std::static_pointer_cast<ActivationLayer<_ForwardType, _WeightType>>(layers[i]);
+				activationFirst = !pooling;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if (!pooling && !activation)
+		{
+			return nullptr;
+		}
+
+		return std::make_shared<FusedLayer>(producer, pooling, activation, activationFirst);
+	}
+
+
+	/*
+	 * @brief Runs fused layers with check of input dimensions
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != getInputSize())
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input of fused layer has different dimensions than its first layer.");
+		}
+
+		compileKernel()(*this, in, out);
+	}
+
+
+	/*
+	 * @brief Fused layer is used only for inference, layers it consists of are trained separately
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> &, const Image<BackwardType> &,
+		Image<BackwardType> &, const TrainingSettings &) override
+	{
+		throw CNNException("Fused layer cannot be trained, its layers are trained separately.");
+	}
+
+
+	/*
+	 * @brief Selects kernel specialized for activation, padding and bias
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		switch ((activation) ? activation->getActivationFunctionType() : ActivationFunction::None)
+		{
+			case ActivationFunction::Sigmoid:
+				return selectKernel<SigmoidActivationLayer<_ForwardType, _WeightType>>();
+			case ActivationFunction::Tanh:
+				return selectKernel<TanhActivationLayer<_ForwardType, _WeightType>>();
+			case ActivationFunction::ReLU:
+				return selectKernel<ReluActivationLayer<_ForwardType, _WeightType>>();
+			case ActivationFunction::LeakyReLU:
+				return selectKernel<LeakyReluActivationLayer<_ForwardType, _WeightType>>();
+			default:
+				return selectKernel<NoActivation>();
+		}
+	}
+
+
+	/*
+	 * @brief Returns number of network layers replaced by this layer
+	 */
+	unsigned getFusedLayerNum() const
+	{
+		return 1 + ((pooling) ? 1 : 0) + ((activation) ? 1 : 0);
+	}
+
+
+	/*
+	 * @brief Returns expected input size
+	 */
+	virtual Dimensions getInputSize() const override
+	{
+		return producer->getInputSize();
+	}
+
+
+	/*
+	 * @brief Returns output size of last fused layer
+	 */
+	virtual Dimensions getOutputSize() const override
+	{
+		return (pooling) ? pooling->getOutputSize() : producer->getOutputSize();
+	}
+
+
+	/*
+	 * @brief Returns output of last fused layer
+	 */
+	virtual Image<_ForwardType> & getOutput() override
+	{
+		if (activationFirst || !activation)
+		{
+			return (pooling) ? pooling->getOutput() : producer->getOutput();
+		}
+
+		return activation->getOutput();
+	}
+
+
+	/*
+	 * @brief Returns gradient output of first fused layer
+	 */
+	virtual Image<BackwardType> & getGradientOutput() override
+	{
+		return producer->getGradientOutput();
+	}
+
+private:
+
+	/*
+	 * @brief Stands for missing activation
+	 */
+	struct NoActivation
+	{
+		static _ForwardType activateValue(const _ForwardType value)
+		{
+			return value;
+		}
+	};
+
+
+	/*
+	 * @brief Selects kernel for given activation
+	 */
+	template <class _Activation>
+	typename ILayer<_ForwardType, _WeightType>::Kernel selectKernel() const
+	{
+		using Base = ILayer<_ForwardType, _WeightType>;
+		using Layer = FusedLayer<_ForwardType, _WeightType>;
+
+		if (fullyConnected)
+		{
+			return &Base::template invokeKernel<Layer, &Layer::template multiply<_Activation>>;
+		}
+		else if (convolution->getZeroPadding() == 0)
+		{
+			return (convolution->usesBias()) ? &Base::template invokeKernel<Layer, &Layer::template convolve<false, true, _Activation>>
+			                                 : &Base::template invokeKernel<Layer, &Layer::template convolve<false, false, _Activation>>;
+		}
+
+		return (convolution->usesBias()) ? &Base::template invokeKernel<Layer, &Layer::template convolve<true, true, _Activation>>
+		                                 : &Base::template invokeKernel<Layer, &Layer::template convolve<true, false, _Activation>>;
+	}
+
+
+	/*
+	 * @brief Activates outputs of neurons
+	 */
+	template <class _Activation>
+	void multiply(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto & layer = *fullyConnected;
+
+		ThreadPool::runParallel(out.getFlattenedSize(), in.getFlattenedSize(), [&layer, &in, &out](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				out(i) = _Activation::activateValue(layer.multiplyNeuron(in, i));
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Convolves, pools and activates, each convolution output is computed once (pooling windows do not overlap)
+	 */
+	template <bool _Padded, bool _Biased, class _Activation>
+	void convolve(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto & layer = *convolution;
+		const auto convolutionSize = layer.getOutputSize();
+		const auto planeSize = convolutionSize.width * convolutionSize.height;
+		const auto windowSize = layer.getExtent() * layer.getExtent() * layer.getInputSize().depth;
+
+		if (!pooling)
+		{
+			ThreadPool::runParallel(out.getFlattenedSize(), windowSize, [&layer, &in, &out, planeSize](size_t first, size_t last)
+			{
+				for (auto i = static_cast<unsigned>(first); i < last; i++)
+				{
+					out(i) = _Activation::activateValue(layer.template convolveCell<_Padded, _Biased>(in, i / planeSize, i % planeSize));
+				}
+			});
+			return;
+		}
+
+		const auto & edges = pooling->getEdges();
+		const auto poolingWindowSize = pooling->getExtentSize() * pooling->getExtentSize();
+		const auto maximum = pooling->getPoolingOperationType() == PoolingOperation::Max;
+		const auto activateInputs = activationFirst;
+
+		ThreadPool::runParallel(out.getFlattenedSize(), windowSize * poolingWindowSize,
+			[&layer, &in, &out, &edges, planeSize, poolingWindowSize, maximum, activateInputs](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				auto accum = (maximum) ? Limits::getMinimumValue<_ForwardType>() : static_cast<_ForwardType>(0);
+				for (auto k = 0u; k < poolingWindowSize; k++)
+				{
+					auto value = layer.template convolveCell<_Padded, _Biased>(in, edges[i][k] / planeSize, edges[i][k] % planeSize);
+					if (activateInputs)
+					{
+						value = _Activation::activateValue(value);
+					}
+
+					if (!maximum)
+					{
+						accum += value;
+					}
+					else if (value > accum)
+					{
+						accum = value;
+					}
+				}
+
+				if (!maximum)
+				{
+					accum = accum / static_cast<_ForwardType>(static_cast<float>(poolingWindowSize));
+				}
+
+				out(i) = (activateInputs) ? accum : _Activation::activateValue(accum);
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Returns true if layer is pooling whose windows do not overlap
+	 */
+	static bool isFusablePooling(const std::shared_ptr<ILayer<_ForwardType, _WeightType>> & layer)
+	{
+		auto pooling = std::dynamic_pointer_cast<PoolingLayer<_ForwardType, _WeightType>>(layer);
+
+		return pooling && pooling->getStride() >= pooling->getExtentSize();
+	}
+
+
+	/*
+	 * @brief Returns true if layer applies activation on each cell separately
+	 */
+	static bool isFusableActivation(const std::shared_ptr<ILayer<_ForwardType, _WeightType>> & layer)
+	{
+		auto activation = std::dynamic_pointer_cast<ActivationLayer<_ForwardType, _WeightType>>(layer);
+		if (!activation)
+		{
+			return false;
+		}
+
+		switch (activation->getActivationFunctionType())
+		{
+			case ActivationFunction::Sigmoid: case ActivationFunction::Tanh: case ActivationFunction::ReLU: case ActivationFunction::LeakyReLU:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+private:
+
+	/// Convolutional or fully connected layer
+	std::shared_ptr<ILayer<_ForwardType, _WeightType>> producer;
+
+	/// Producer if it is convolutional layer
+	std::shared_ptr<ConvolutionalLayer<_ForwardType, _WeightType>> convolution;
+
+	/// Producer if it is fully connected layer
+	std::shared_ptr<FullyConnectedLayer<_ForwardType, _WeightType>> fullyConnected;
+
+	/// Pooling following producer (null if not fused)
+	std::shared_ptr<PoolingLayer<_ForwardType, _WeightType>> pooling;
+
+	/// Activation following producer (null if not fused)
+	std::shared_ptr<ActivationLayer<_ForwardType, _WeightType>> activation;
+
+	/// Activation precedes pooling
+	bool activationFirst;
+
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Global average pooling layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef GLOBAL_AVG_POOLING_LAYER_H
+#define GLOBAL_AVG_POOLING_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/PoolingLayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/ThreadPool.h"
+
+/*
+ * @brief Averages each channel of input into single cell (output has dimensions 1x1xdepth), replaces flattening
+ *            of large feature map into fully connected layer
+ */
+template <class _ForwardType, class _WeightType>
+class GlobalAvgPoolingLayer : public ILayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initializes global average pooling layer
+	 *
+	 * @param input      Dimensions of input matrix
+	 */
+	GlobalAvgPoolingLayer(const Dimensions & input)
+		: inputSize(input)
+		, outputSize(Dimensions{ 1, 1, input.depth })
+		, planeSize(input.width * input.height)
+		, output(Dimensions{ 1, 1, input.depth })
+		, gradientOutput(input)
+	{
+		if (planeSize == 0 || input.depth == 0)
+		{
+			throw PoolingLayerException("Global average pooling cannot be applied on empty input.");
+		}
+	}
+
+
+	/*
+	 * @brief Forward propagates a matrix by averaging each channel
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to declared input size in Global average pooling layer.");
+		}
+
+		average(in, out);
+	}
+
+
+	/*
+	 * @brief Compiled execution plan averages without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = GlobalAvgPoolingLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::average>;
+	}
+
+
+	/*
+	 * @brief Gradient of each channel is split evenly among its cells (channels are split among threads)
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> &,
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		ThreadPool::runParallel(inputSize.depth, planeSize, [this, &inGradients, &outGradients](size_t first, size_t last)
+		{
+			for (auto channel = static_cast<unsigned>(first); channel < last; channel++)
+			{
+				const auto gradient = inGradients(channel) / static_cast<BackwardType>(static_cast<float>(planeSize));
+				for (auto i = channel * planeSize; i < (channel + 1) * planeSize; i++)
+				{
+					outGradients(i) = gradient;
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Gradients are split evenly, output is not needed
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Returns expected input size
+	 */
+	virtual Dimensions getInputSize() const override
+	{
+		return inputSize;
+	}
+
+
+	/*
+	 * @brief Returns output size
+	 */
+	virtual Dimensions getOutputSize() const override
+	{
+		return outputSize;
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer output
+	 */
+	virtual Image<_ForwardType> & getOutput() override
+	{
+		return output;
+	}
+
+
+	/*
+	 * @brief Returns a reference to layer gradient output
+	 */
+	virtual Image<BackwardType> & getGradientOutput() override
+	{
+		return gradientOutput;
+	}
+
+private:
+
+	/*
+	 * @brief Sums each channel in independent lanes (reduction is vectorized, fixed point does not overflow in backward type)
+	 *            and divides sum by number of cells, channels are split among threads
+	 */
+	void average(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		ThreadPool::runParallel(inputSize.depth, planeSize, [this, &in, &out](size_t first, size_t last)
+		{
+			for (auto channel = static_cast<unsigned>(first); channel < last; channel++)
+			{
+				const auto begin = channel * planeSize;
+				const auto end = begin + planeSize;
+				const auto vectorEnd = begin + planeSize / LANE_NUM * LANE_NUM;
+
+				BackwardType lanes[LANE_NUM] = {};
+				for (auto i = begin; i < vectorEnd; i += LANE_NUM)
+				{
+					for (auto lane = 0u; lane < LANE_NUM; lane++)
+					{
+						lanes[lane] += static_cast<BackwardType>(static_cast<float>(in(i + lane)));
+					}
+				}
+
+				auto sum = static_cast<BackwardType>(0.0f);
+				for (auto lane = 0u; lane < LANE_NUM; lane++)
+				{
+					sum += lanes[lane];
+				}
+				for (auto i = vectorEnd; i < end; i++)
+				{
+					sum += static_cast<BackwardType>(static_cast<float>(in(i)));
+				}
+
+				out(channel) = static_cast<_ForwardType>(static_cast<float>(sum / static_cast<BackwardType>(static_cast<float>(planeSize))));
+			}
+		});
+	}
+
+private:
+
+	/// Number of independent partial sums of each channel
+	static constexpr unsigned LANE_NUM = 8;
+
+	/// Accepted input size
+	Dimensions inputSize;
+
+	/// Output size
+	Dimensions outputSize;
+
+	/// Number of cells of each channel
+	unsigned planeSize;
+
+	/// Output to be forward propagated to next layer
+	Image<_ForwardType> output;
+
+	/// Gradients to be backward propagated to previous layer
+	Image<BackwardType> gradientOutput;
+
+};
+
+#endif
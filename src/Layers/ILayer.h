@@ -1,129 +1,263 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Interface for layers
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef LAYER_INTERFACE_H
-#define LAYER_INTERFACE_H
-
-#include "../Image.h"
-#include "../TrainingSettings.h"
-#include "../Optimizers/IOptimizer.h"
-
-#include <istream>
-#include <ostream>
-
-/*
- * @brief Generic exception thrown by layers
- */
-class CNNException : public std::runtime_error
-{
-
-public:
-
-	explicit CNNException(const std::string & msg)
-		: std::runtime_error(msg.c_str()) {};
-
-};
-
-/*
- * @brief Exception thrown if input to layer has different dimensions than declared during initialization
- */
-class InputImageDoesNotHaveCorrectDimensions : public CNNException 
-{ 
-
-	using CNNException::CNNException; 
-
-};
-
-/*
- * @brief Interface all layers need to follow in order for them to be used in CNN interface
- */
-template <class _ForwardType, class _WeightType>
-class ILayer
-{
-
-public:
-
-	ILayer() = default;
-	~ILayer() = default;
-
-	/*
-	 * @brief Forward propagates an input matrix
-	 *
-	 * @param in Input matrix
-	 * @param out Output matrix (external or inside layer)
-	 *
-	 * @throws InputImageDoesNotHaveCorrectDimensions if input dimensions do not correspond to the ones declared during initialization
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) = 0;
-
-	/*
-	 * @brief Backward propagation to compute gradients and update learnable parameters
-	 *
-	 * @param in                 Original input during forward propagation
-	 * @param out                Original output during backward propagation (external or inside layer)
-	 * @param inGradients        Input gradients used to update learnable parameters in this layer
-	 * @param outGradients       Output gradients used to update learnable parameters in previous layer (external or inside layer)
-	 * @param trainingSettings   Settings for training (learning coefficient, batch size etc.)
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> & out, const Image<BackwardType> & inGradients,
-		                             Image<BackwardType> & outGradients, const TrainingSettings & trainingSettings) = 0;
-
-	/*
-	 * @brief Returns expected input dimensions
-	 */
-	virtual Dimensions getInputSize() const = 0;
-
-	/*
-	 * @brief Returns output dimensions
-	 */
-	virtual Dimensions getOutputSize() const = 0;
-
-	/*
-	 * @brief Returns a reference to this layers output (can be used both for reading and writing)
-	 */
-	virtual Image<_ForwardType> & getOutput() = 0;
-
-	/*
-	 * @brief Returns a reference to this layers gradient output (can be used both for reading and writing)
-	 */
-	virtual Image<BackwardType> & getGradientOutput() = 0;
-
-	/*
-	 * @brief Initializes optimizer (needed only for layers with learnable parameters)
-	 *
-	 * @param trainingSettings   Training settings that initialize optimizer (e.g. momentum, weight decay etc.)
-	 */
-	virtual void initializeOptimizer() {};
-
-public:
-
-	/*
-	 * @brief Sets an optimizer
-	 *
-	 * @param  opt   Optimizer to be used
-	 */
-	void setOptimizer(const std::shared_ptr<IOptimizer> opt)
-	{
-		optimizer = opt->clone();
-	}
-
-public:
-
-	/// This layer should be used only when learning, not during predictions
-	bool useOnlyWhenLearning = false;
-
-protected:
-
-	/// Optimizer pointer
-	std::unique_ptr<IOptimizer> optimizer;
-
-};
-
-#endif
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Interface for layers
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LAYER_INTERFACE_H
+#define LAYER_INTERFACE_H
+
+#include "../Image.h"
+#include "../TrainingSettings.h"
+#include "../Optimizers/IOptimizer.h"
+
+#include <istream>
+#include <ostream>
+
+/*
+ * @brief Generic exception thrown by layers
+ */
+class CNNException : public std::runtime_error
+{
+
+public:
+
+	explicit CNNException(const std::string & msg)
+		: std::runtime_error(msg.c_str()) {};
+
+};
+
+/*
+ * @brief Exception thrown if input to layer has different dimensions than declared during initialization
+ */
+class InputImageDoesNotHaveCorrectDimensions : public CNNException 
+{ 
+
+	using CNNException::CNNException; 
+
+};
+
+/*
+ * @brief Interface all layers need to follow in order for them to be used in CNN interface
+ */
+template <class _ForwardType, class _WeightType>
+class ILayer
+{
+
+public:
+
+	/// Kernel of compiled execution plan, runs given layer on buffers validated when plan was compiled
+	using Kernel = void(*)(ILayer & layer, const Image<_ForwardType> & in, Image<_ForwardType> & out);
+
+public:
+
+	ILayer() = default;
+	~ILayer() = default;
+
+	/*
+	 * @brief Forward propagates an input matrix
+	 *
+	 * @param in Input matrix
+	 * @param out Output matrix (external or inside layer)
+	 *
+	 * @throws InputImageDoesNotHaveCorrectDimensions if input dimensions do not correspond to the ones declared during initialization
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) = 0;
+
+	/*
+	 * @brief Forward propagates an input matrix without recording anything for backward propagation,
+	 *            layer is not modified so it may be called from multiple threads with different outputs
+	 *            (layers that record state during forward propagation must override it)
+	 *
+	 * @param in Input matrix
+	 * @param out Output matrix (external)
+	 *
+	 * @throws InputImageDoesNotHaveCorrectDimensions if input dimensions do not correspond to the ones declared during initialization
+	 */
+	virtual void inferencePropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		forwardPropagation(in, out);
+	}
+
+	/*
+	 * @brief Forward propagates an input matrix during training, called before backward propagation of the same input
+	 *            (layers that compute differently during training must override it, e.g. batch normalization uses statistics of batch)
+	 *
+	 * @param in Input matrix
+	 * @param out Output matrix (external or inside layer)
+	 *
+	 * @throws InputImageDoesNotHaveCorrectDimensions if input dimensions do not correspond to the ones declared during initialization
+	 */
+	virtual void trainingPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		forwardPropagation(in, out);
+	}
+
+	/*
+	 * @brief Selects kernel for compiled execution plan, kernel does not check dimensions of input and does not
+	 *            branch on parameters fixed at construction (layers without own kernel run inference propagation)
+	 */
+	virtual Kernel compileKernel() const
+	{
+		return &invokeKernel<ILayer, &ILayer::inferencePropagation>;
+	}
+
+	/*
+	 * @brief Backward propagation to compute gradients and update learnable parameters
+	 *
+	 * @param in                 Original input during forward propagation
+	 * @param out                Original output during backward propagation (external or inside layer)
+	 * @param inGradients        Input gradients used to update learnable parameters in this layer
+	 * @param outGradients       Output gradients used to update learnable parameters in previous layer (external or inside layer)
+	 * @param trainingSettings   Settings for training (learning coefficient, batch size etc.)
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> & out, const Image<BackwardType> & inGradients,
+		                             Image<BackwardType> & outGradients, const TrainingSettings & trainingSettings) = 0;
+
+	/*
+	 * @brief Returns expected input dimensions
+	 */
+	virtual Dimensions getInputSize() const = 0;
+
+	/*
+	 * @brief Returns output dimensions
+	 */
+	virtual Dimensions getOutputSize() const = 0;
+
+	/*
+	 * @brief Returns a reference to this layers output (can be used both for reading and writing)
+	 */
+	virtual Image<_ForwardType> & getOutput() = 0;
+
+	/*
+	 * @brief Returns a reference to this layers gradient output (can be used both for reading and writing)
+	 */
+	virtual Image<BackwardType> & getGradientOutput() = 0;
+
+	/*
+	 * @brief Initializes optimizer (needed only for layers with learnable parameters)
+	 *
+	 * @param trainingSettings   Training settings that initialize optimizer (e.g. momentum, weight decay etc.)
+	 */
+	virtual void initializeOptimizer() {};
+
+	/*
+	 * @brief Returns true if layer reads its own output during backward propagation
+	 *            (such output must not be overwritten by following layer running in place)
+	 */
+	virtual bool needsOutputForBackward() const { return true; };
+
+	/*
+	 * @brief Returns true if layer is elementwise and may write its output directly into its input buffer
+	 */
+	virtual bool supportsInPlace() const { return false; };
+
+	/*
+	 * @brief Returns true if forward propagation can be repeated with the same result
+	 *            (needed for recomputation of outputs that were not kept by gradient checkpointing)
+	 */
+	virtual bool supportsRecomputation() const { return true; };
+
+	/*
+	 * @brief Frees everything that is needed only for training (gradients, deltas, master copies of weights),
+	 *            layer may be used only for forward propagation afterwards
+	 */
+	virtual void releaseTrainingState()
+	{
+		getGradientOutput().release();
+	};
+
+	/*
+	 * @brief Returns true if layer may be trained (it was not created for inference only and its training state was not released)
+	 */
+	bool hasTrainingState()
+	{
+		return getGradientOutput().getFlattenedSize() > 0;
+	}
+
+public:
+
+	/*
+	 * @brief Sets an optimizer
+	 *
+	 * @param  opt   Optimizer to be used
+	 */
+	void setOptimizer(const std::shared_ptr<IOptimizer> opt)
+	{
+		optimizer = opt->clone();
+	}
+
+protected:
+
+	/*
+	 * @brief Calls given method of layer, instances are used as kernels of compiled execution plan
+	 */
+	template <class _Layer, void (_Layer::*_Method)(const Image<_ForwardType> &, Image<_ForwardType> &)>
+	static void invokeKernel(ILayer & layer, const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		(static_cast<_Layer &>(layer).*_Method)(in, out);
+	}
+
+	/*
+	 * @brief Forward weights of the same type as master weights share memory with them, no copy is kept
+	 */
+	static void shareOrConvertWeights(const Image<BackwardType> & weights, Image<BackwardType> & forwardWeights)
+	{
+		forwardWeights.shareWith(weights);
+	}
+
+	/*
+	 * @brief Converts master weights to type used during forward propagation (buffer of forward weights is reused)
+	 */
+	template <class _Type>
+	static void shareOrConvertWeights(const Image<BackwardType> & weights, Image<_Type> & forwardWeights)
+	{
+		if (forwardWeights.getDimensions() != weights.getDimensions())
+		{
+			forwardWeights.shareWith(Image<_Type>(weights.getDimensions()));
+		}
+
+		for (auto i = 0u; i < weights.getFlattenedSize(); i++)
+		{
+			forwardWeights(i) = static_cast<_Type>(weights(i));
+		}
+	}
+
+	/*
+	 * @brief Converts weights to type used during forward propagation into new buffer (layers without master weights),
+	 *            images sharing previous forward weights are not modified
+	 */
+	template <class _Type>
+	static void copyWeights(const Image<BackwardType> & weights, Image<_Type> & forwardWeights)
+	{
+		forwardWeights.shareWith(Image<_Type>(weights.getDimensions()));
+
+		for (auto i = 0u; i < weights.getFlattenedSize(); i++)
+		{
+			forwardWeights(i) = static_cast<_Type>(weights(i));
+		}
+	}
+
+public:
+
+	/// This layer should be used only when learning, not during predictions
+	bool useOnlyWhenLearning = false;
+
+	/// Output of this layer shares memory with its input (set by network)
+	bool runsInPlace = false;
+
+	/// Output of this layer is kept during training when checkpoints are placed explicitly
+	bool isCheckpoint = false;
+
+protected:
+
+	/// Optimizer pointer
+	std::unique_ptr<IOptimizer> optimizer;
+
+};
+
+#endif
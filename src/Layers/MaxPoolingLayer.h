@@ -1,148 +1,457 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Maximum pooling layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef MAX_POOLING_LAYER_H
-#define MAX_POOLING_LAYER_H
-
-#include "src/Layers/ILayer.h"
-#include "src/Layers/PoolingLayer.h"
-
-#include "src/Image.h"
-#include "src/Utils/Limits.h"
-
-/*
- * @brief Max pooling layer that reduces width and height of input matrix
- */
-template <class _ForwardType, class _WeightType>
-class MaxPoolingLayer : public PoolingLayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Checks parameters and validates output size
-	 */
-	MaxPoolingLayer(const Dimensions & input, const unsigned & extent, const unsigned & stride)
-		: PoolingLayer<_ForwardType, _WeightType>(input, extent, stride, PoolingOperation::Max)
-	{
-	}
-
-
-	/*
-	 * @brief Forward propagates a matrix in order to reduce dimension using given operation
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != this->inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to declared input size in Pooling layer.");
-		}
-
-		auto flattenedSize = out.getFlattenedSize();
-
-		// Perform pooling
-		_ForwardType initAccumValue = Limits::getMinimumValue<_ForwardType>();
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			auto accum = initAccumValue;
-			for (auto k = 0u; k < this->windowSize; k++)
-			{
-				if (in(this->edges[i][k]) > accum)
-				{
-					accum = in(this->edges[i][k]);
-				}
-			}
-			out(i) = accum;
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*for (auto z = 0u; z < outputSize.depth; z++)
-		{
-			unsigned currY = 0;
-			for (auto i = 0u; i < outputSize.height; i++)
-			{
-				unsigned currX = 0;
-				for (auto j = 0u; j < outputSize.width; j++)
-				{
-					auto accum = initAccumValue;
-					for (auto b = 0u; b < extent; b++)
-					{
-						for (auto a = 0u; a < extent; a++)
-						{
-							unsigned x = currX + a;
-							unsigned y = currY + b;
-
-							if (in(x, y, z) > accum)
-							{
-								accum = in(x, y, z);
-							}
-						}
-					}
-					out(j, i, z) = accum;
-					currX += stride;
-				}
-				currY += stride;
-			}
-		}*/
-	}
-
-
-	/*
-	 * @brief Computes gradients to be propagated to previous layer (depends on usder operation)
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> & out, const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
-	{
-		outGradients.clear();
-
-		auto flattenedSize = inGradients.getFlattenedSize();
-
-		// Reverse pooling (assign error to min/max element or split it if average was used)
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			for (auto k = 0u; k < this->windowSize; k++)
-			{
-				if (in(this->edges[i][k]) == out(i))
-				{
-					outGradients(this->edges[i][k]) += inGradients(i);
-				}
-			}
-		}
-
-		// Slower, but more descriptive implementation for future reference
-		/*for (auto z = 0u; z < outputSize.depth; z++)
-		{
-			unsigned currY = 0;
-			for (auto i = 0u; i < outputSize.height; i++)
-			{
-				unsigned currX = 0;
-				for (auto j = 0u; j < outputSize.width; j++)
-				{
-					for (auto b = 0u; b < extent; b++)
-					{
-						for (auto a = 0u; a < extent; a++)
-						{
-							unsigned x = currX + a;
-							unsigned y = currY + b;
-							if (in(x, y, z) == out(j, i, z))
-							{
-								outGradients(x, y, z) += inGradients(j, i, z);
-							}
-						}
-					}
-					currX += stride;
-				}
-				currY += stride;
-			}
-		}*/
-	}
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Maximum pooling layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef MAX_POOLING_LAYER_H
+#define MAX_POOLING_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/PoolingLayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/Limits.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+ * @brief Max pooling layer that reduces width and height of input matrix
+ *
+ * Overlapping windows of extent 4 and larger are pooled separably (van Herk/Gil-Werman), maximum of each row segment
+ * of window is found first and maximum of these row maxima then, both using prefix and suffix maxima of blocks of extent cells.
+ * Cost per output does not depend on extent then. The most common 2x2 windows with stride 2 are pooled by pairs of rows
+ * without indirection through edges. All ways select first maximum in window (row by row) that exceeds minimum
+ * of type, as the window scan starts from it.
+ */
+template <class _ForwardType, class _WeightType>
+class MaxPoolingLayer : public PoolingLayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Checks parameters and validates output size
+	 */
+	MaxPoolingLayer(const Dimensions & input, const unsigned & extent, const unsigned & stride)
+		: PoolingLayer<_ForwardType, _WeightType>(input, extent, stride, PoolingOperation::Max)
+		, separable(extent >= MIN_SEPARABLE_EXTENT && stride < extent)
+	{
+		// Position of maximum inside window is remembered in 8 bits if window is small enough
+		if (this->windowSize <= MAX_ARGMAX_WINDOW_SIZE)
+		{
+			argmax.resize(this->outputSize.width * this->outputSize.height * this->outputSize.depth);
+		}
+	}
+
+
+	/*
+	 * @brief Forward propagates a matrix in order to reduce dimension using given operation
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to declared input size in Pooling layer.");
+		}
+
+		(argmax.size() == out.getFlattenedSize()) ? pool<true>(in, out) : pool<false>(in, out);
+	}
+
+
+	/*
+	 * @brief Forward propagates a matrix without remembering positions of maxima
+	 */
+	virtual void inferencePropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input image does not correspond to declared input size in Pooling layer.");
+		}
+
+		pool<false>(in, out);
+	}
+
+
+	/*
+	 * @brief Compiled execution plan pools without checking dimensions of input and without remembering positions of maxima
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = MaxPoolingLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::template pool<false>>;
+	}
+
+
+	/*
+	 * @brief Computes gradients to be propagated to previous layer (depends on usder operation)
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> & in, const Image<_ForwardType> & out, const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		// Windows of 2x2 pooling cover each input cell once, every gradient is written directly
+		if (this->halving && !argmax.empty())
+		{
+			unpoolHalving(inGradients, outGradients);
+			return;
+		}
+
+		outGradients.clear();
+
+		// Windows of one channel touch only that channel, so channels are split among threads
+		const auto planeSize = this->outputSize.width * this->outputSize.height;
+
+		// Reverse pooling (assign error to element that was selected as maximum)
+		if (!argmax.empty())
+		{
+			ThreadPool::runParallel(this->outputSize.depth, planeSize, [this, &inGradients, &outGradients, planeSize](size_t first, size_t last)
+			{
+				for (auto i = static_cast<unsigned>(first * planeSize); i < last * planeSize; i++)
+				{
+					outGradients(this->edges[i][argmax[i]]) += inGradients(i);
+				}
+			});
+			return;
+		}
+
+		// Windows too large for 8 bit positions are scanned again (ties receive gradient as well)
+		ThreadPool::runParallel(this->outputSize.depth, planeSize * this->windowSize, [this, &in, &out, &inGradients, &outGradients, planeSize](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first * planeSize); i < last * planeSize; i++)
+			{
+				for (auto k = 0u; k < this->windowSize; k++)
+				{
+					if (in(this->edges[i][k]) == out(i))
+					{
+						outGradients(this->edges[i][k]) += inGradients(i);
+					}
+				}
+			}
+		});
+
+		// Slower, but more descriptive implementation for future reference
+		/*for (auto z = 0u; z < outputSize.depth; z++)
+		{
+			unsigned currY = 0;
+			for (auto i = 0u; i < outputSize.height; i++)
+			{
+				unsigned currX = 0;
+				for (auto j = 0u; j < outputSize.width; j++)
+				{
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							unsigned x = currX + a;
+							unsigned y = currY + b;
+							if (in(x, y, z) == out(j, i, z))
+							{
+								outGradients(x, y, z) += inGradients(j, i, z);
+							}
+						}
+					}
+					currX += stride;
+				}
+				currY += stride;
+			}
+		}*/
+	}
+
+
+	/*
+	 * @brief Output is needed only if positions of maxima could not be remembered
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return this->windowSize > MAX_ARGMAX_WINDOW_SIZE;
+	}
+
+
+	/*
+	 * @brief Releases positions of maxima together with gradients
+	 */
+	virtual void releaseTrainingState() override
+	{
+		ILayer<_ForwardType, _WeightType>::releaseTrainingState();
+		std::vector<uint8_t>().swap(argmax);
+	}
+
+private:
+
+	/*
+	 * @brief Performs pooling, first maximum in window may be remembered for back propagation
+	 */
+	template <bool _RecordArgmax>
+	void pool(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		if (separable)
+		{
+			poolSeparable<_RecordArgmax>(in, out);
+			return;
+		}
+		else if (this->halving)
+		{
+			poolHalving<_RecordArgmax>(in, out);
+			return;
+		}
+
+		// Output cells are split among threads
+		const _ForwardType initAccumValue = Limits::getMinimumValue<_ForwardType>();
+		ThreadPool::runParallel(out.getFlattenedSize(), this->windowSize, [this, &in, &out, initAccumValue](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				auto accum = initAccumValue;
+				auto position = 0u;
+				for (auto k = 0u; k < this->windowSize; k++)
+				{
+					if (in(this->edges[i][k]) > accum)
+					{
+						accum = in(this->edges[i][k]);
+						position = k;
+					}
+				}
+				out(i) = accum;
+				if (_RecordArgmax)
+				{
+					argmax[i] = static_cast<uint8_t>(position);
+				}
+			}
+		});
+
+		// Slower, but more descriptive implementation for future reference
+		/*for (auto z = 0u; z < outputSize.depth; z++)
+		{
+			unsigned currY = 0;
+			for (auto i = 0u; i < outputSize.height; i++)
+			{
+				unsigned currX = 0;
+				for (auto j = 0u; j < outputSize.width; j++)
+				{
+					auto accum = initAccumValue;
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							unsigned x = currX + a;
+							unsigned y = currY + b;
+
+							if (in(x, y, z) > accum)
+							{
+								accum = in(x, y, z);
+							}
+						}
+					}
+					out(j, i, z) = accum;
+					currX += stride;
+				}
+				currY += stride;
+			}
+		}*/
+	}
+
+
+	/*
+	 * @brief Pools 2x2 windows with stride 2, each output row is pooled from pair of input rows (rows are split among threads)
+	 *
+	 * Output row r is created from input rows 2r and 2r + 1 in all channels as height of input is even.
+	 * Maxima are selected without branches, so loop over row is vectorized.
+	 */
+	template <bool _RecordArgmax>
+	void poolHalving(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto inWidth = this->inputSize.width;
+		const auto outWidth = this->outputSize.width;
+		const _ForwardType initAccumValue = Limits::getMinimumValue<_ForwardType>();
+
+		ThreadPool::runParallel(this->outputSize.height * this->outputSize.depth, inWidth * 2, [this, &in, &out, inWidth, outWidth, initAccumValue](size_t first, size_t last)
+		{
+			for (auto row = static_cast<unsigned>(first); row < last; row++)
+			{
+				const auto top = &in(row * 2 * inWidth);
+				const auto bottom = top + inWidth;
+				const auto result = &out(row * outWidth);
+				const auto positions = _RecordArgmax ? &argmax[row * outWidth] : nullptr;
+
+				for (auto x = 0u; x < outWidth; x++)
+				{
+					// First maximum in order top left, top right, bottom left, bottom right
+					const bool topRight = top[2 * x + 1] > top[2 * x];
+					const bool bottomRight = bottom[2 * x + 1] > bottom[2 * x];
+					const auto topMaximum = topRight ? top[2 * x + 1] : top[2 * x];
+					const auto bottomMaximum = bottomRight ? bottom[2 * x + 1] : bottom[2 * x];
+					const bool bottomRow = bottomMaximum > topMaximum;
+					const auto maximum = bottomRow ? bottomMaximum : topMaximum;
+					const bool found = maximum > initAccumValue;
+
+					result[x] = found ? maximum : initAccumValue;
+					if (_RecordArgmax)
+					{
+						positions[x] = static_cast<uint8_t>(found ? (bottomRow ? 2 + bottomRight : topRight) : 0);
+					}
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Assigns gradient of each 2x2 window to its maximum and zero to other cells (rows are split among threads)
+	 */
+	void unpoolHalving(const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients)
+	{
+		const auto inWidth = this->inputSize.width;
+		const auto outWidth = this->outputSize.width;
+		const auto zero = static_cast<BackwardType>(0.0f);
+
+		ThreadPool::runParallel(this->outputSize.height * this->outputSize.depth, inWidth * 2, [this, &inGradients, &outGradients, inWidth, outWidth, zero](size_t first, size_t last)
+		{
+			for (auto row = static_cast<unsigned>(first); row < last; row++)
+			{
+				const auto top = &outGradients(row * 2 * inWidth);
+				const auto bottom = top + inWidth;
+				const auto gradients = &inGradients(row * outWidth);
+				const auto positions = &argmax[row * outWidth];
+
+				for (auto x = 0u; x < outWidth; x++)
+				{
+					top[2 * x] = (positions[x] == 0) ? gradients[x] : zero;
+					top[2 * x + 1] = (positions[x] == 1) ? gradients[x] : zero;
+					bottom[2 * x] = (positions[x] == 2) ? gradients[x] : zero;
+					bottom[2 * x + 1] = (positions[x] == 3) ? gradients[x] : zero;
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Performs pooling by rows and then by columns, channels are split among threads
+	 */
+	template <bool _RecordArgmax>
+	void poolSeparable(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		const auto inWidth = this->inputSize.width;
+		const auto inHeight = this->inputSize.height;
+		const auto outWidth = this->outputSize.width;
+		const auto outHeight = this->outputSize.height;
+		const _ForwardType initAccumValue = Limits::getMinimumValue<_ForwardType>();
+
+		ThreadPool::runParallel(this->outputSize.depth, inWidth * inHeight, [this, &in, &out, inWidth, inHeight, outWidth, outHeight, initAccumValue](size_t first, size_t last)
+		{
+			// Maximum of row segment of each window (and its column) for every row of channel, buffers are reused by thread
+			auto & rowMaxima = this->template getScratch<_ForwardType, 0>(inHeight * outWidth);
+			auto & rowPositions = this->template getScratch<unsigned, 0>(inHeight * outWidth);
+			auto & column = this->template getScratch<_ForwardType, 1>(inHeight);
+
+			const auto length = std::max(inWidth, inHeight);
+			auto & prefix = this->template getScratch<unsigned, 1>(length);
+			auto & suffix = this->template getScratch<unsigned, 2>(length);
+			auto & positions = this->template getScratch<unsigned, 3>(std::max(outWidth, outHeight));
+
+			for (auto z = static_cast<unsigned>(first); z < last; z++)
+			{
+				const auto plane = &in(z * inWidth * inHeight);
+				for (auto y = 0u; y < inHeight; y++)
+				{
+					const auto row = plane + y * inWidth;
+					findWindowMaxima(row, inWidth, outWidth, prefix, suffix, positions);
+					for (auto x = 0u; x < outWidth; x++)
+					{
+						rowPositions[y * outWidth + x] = positions[x];
+						rowMaxima[y * outWidth + x] = row[positions[x]];
+					}
+				}
+
+				for (auto x = 0u; x < outWidth; x++)
+				{
+					for (auto y = 0u; y < inHeight; y++)
+					{
+						column[y] = rowMaxima[y * outWidth + x];
+					}
+
+					findWindowMaxima(column.data(), inHeight, outHeight, prefix, suffix, positions);
+					for (auto y = 0u; y < outHeight; y++)
+					{
+						const auto i = z * outWidth * outHeight + y * outWidth + x;
+						const auto maximumRow = positions[y];
+						if (column[maximumRow] > initAccumValue)
+						{
+							out(i) = column[maximumRow];
+							if (_RecordArgmax)
+							{
+								const auto maximumColumn = rowPositions[maximumRow * outWidth + x];
+								argmax[i] = static_cast<uint8_t>((maximumRow - y * this->stride) * this->extent + maximumColumn - x * this->stride);
+							}
+						}
+						else
+						{
+							out(i) = initAccumValue;
+							if (_RecordArgmax)
+							{
+								argmax[i] = 0;
+							}
+						}
+					}
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Finds position of first maximum of every window in line (windows start at multiples of stride),
+	 *            window covers suffix of one block of extent cells and prefix of the following one
+	 */
+	void findWindowMaxima(const _ForwardType * values, const unsigned & length, const unsigned & windowNum,
+		std::vector<unsigned> & prefix, std::vector<unsigned> & suffix, std::vector<unsigned> & positions) const
+	{
+		for (auto block = 0u; block < length; block += this->extent)
+		{
+			const auto blockEnd = std::min(block + this->extent, length);
+
+			prefix[block] = block;
+			for (auto j = block + 1; j < blockEnd; j++)
+			{
+				prefix[j] = (values[j] > values[prefix[j - 1]]) ? j : prefix[j - 1];
+			}
+
+			suffix[blockEnd - 1] = blockEnd - 1;
+			for (auto j = blockEnd - 1; j-- > block;)
+			{
+				suffix[j] = (values[j] >= values[suffix[j + 1]]) ? j : suffix[j + 1];
+			}
+		}
+
+		for (auto k = 0u; k < windowNum; k++)
+		{
+			const auto left = suffix[k * this->stride];
+			const auto right = prefix[k * this->stride + this->extent - 1];
+			positions[k] = (values[left] >= values[right]) ? left : right;
+		}
+	}
+
+private:
+
+	/// Smallest extent of overlapping windows that are pooled separably
+	static constexpr unsigned MIN_SEPARABLE_EXTENT = 4;
+
+	/// Whether windows are pooled by rows and then by columns
+	bool separable;
+
+	/// Largest window whose positions fit into 8 bits
+	static constexpr unsigned MAX_ARGMAX_WINDOW_SIZE = std::numeric_limits<uint8_t>::max() + 1;
+
+	/// Position of maximum inside window for each output cell (from last forward propagation)
+	std::vector<uint8_t> argmax;
+
+};
+
 #endif
\ No newline at end of file
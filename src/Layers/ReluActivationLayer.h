@@ -1,74 +1,178 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief ReLU activation layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef RELU_ACTIVATION_LAYER_H
-#define RELU_ACTIVATION_LAYER_H
-
-#include "src/Layers/ILayer.h"
-#include "src/Layers/ActivationLayer.h"
-
-#include "src/Image.h"
-
-/*
- * @brief ReLU activation layer
- */
-template <class _ForwardType, class _WeightType>
-class ReluActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Initializes base class
-	 *
-	 * @param  input    Dimensions of input matrix
-	 */
-	ReluActivationLayer(const Dimensions & input)
-		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::ReLU)
-	{
-	}
-
-
-	/*
-	 * @brief Applies activation functions on all cells of input matrix
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != this->inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
-		}
-
-		auto flattenedSize = in.getFlattenedSize();
-
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			out(i) = (in(i) < static_cast<_ForwardType>(0.0f)) ? static_cast<_ForwardType>(0.0f) : in(i);
-		}
-	}
-
-
-	/*
-	 * @brief Applies activation function derivative and computes output gradients
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> & out, 
-		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
-	{
-		auto flattenedSize = out.getFlattenedSize();
-
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			outGradients(i) = (static_cast<BackwardType>(out(i)) < static_cast<BackwardType>(0.0f)) ? static_cast<BackwardType>(0.0f) : inGradients(i);
-		}
-	}
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief ReLU activation layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef RELU_ACTIVATION_LAYER_H
+#define RELU_ACTIVATION_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/ActivationLayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/BitMask.h"
+
+/*
+ * @brief ReLU activation layer
+ */
+template <class _ForwardType, class _WeightType>
+class ReluActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initializes base class
+	 *
+	 * @param  input    Dimensions of input matrix
+	 */
+	ReluActivationLayer(const Dimensions & input)
+		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::ReLU)
+		, activeMask(input.width * input.height * input.depth)
+	{
+	}
+
+
+	/*
+	 * @brief Applies activation functions on all cells of input matrix
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
+		}
+
+		auto flattenedSize = in.getFlattenedSize();
+
+		// Mask is not kept once training state was released
+		if (activeMask.getSize() != flattenedSize)
+		{
+			inferencePropagation(in, out);
+			return;
+		}
+
+		// Remember positive cells in bit mask (64 cells at a time), backward propagation needs only the mask,
+		// words are split among threads
+		const auto wordNum = (flattenedSize + BitMask::BITS_PER_WORD - 1) / BitMask::BITS_PER_WORD;
+		ThreadPool::runParallel(wordNum, BitMask::BITS_PER_WORD, [this, &in, &out, flattenedSize](size_t first, size_t last)
+		{
+			for (auto wordIndex = static_cast<unsigned>(first), i = wordIndex * BitMask::BITS_PER_WORD; wordIndex < last; wordIndex++)
+			{
+				uint64_t word = 0;
+				for (auto bit = 0u; bit < BitMask::BITS_PER_WORD && i < flattenedSize; bit++, i++)
+				{
+					auto positive = in(i) > static_cast<_ForwardType>(0.0f);
+					out(i) = positive ? in(i) : static_cast<_ForwardType>(0.0f);
+					word |= static_cast<uint64_t>(positive) << bit;
+				}
+				activeMask.setWord(wordIndex, word);
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Applies activation functions on all cells of input matrix without remembering positive cells
+	 */
+	virtual void inferencePropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
+		}
+
+		activate(in, out);
+	}
+
+
+	/*
+	 * @brief Applies activation function on single value (used also by kernels fused with previous layer)
+	 */
+	static _ForwardType activateValue(const _ForwardType value)
+	{
+		return (value < static_cast<_ForwardType>(0.0f)) ? static_cast<_ForwardType>(0.0f) : value;
+	}
+
+
+	/*
+	 * @brief Compiled execution plan applies activation without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = ReluActivationLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::activate>;
+	}
+
+
+	/*
+	 * @brief Applies activation function derivative and computes output gradients
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> &, 
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		const auto flattenedSize = outGradients.getFlattenedSize();
+		const auto wordNum = (flattenedSize + BitMask::BITS_PER_WORD - 1) / BitMask::BITS_PER_WORD;
+
+		ThreadPool::runParallel(wordNum, BitMask::BITS_PER_WORD, [this, &inGradients, &outGradients, flattenedSize](size_t first, size_t last)
+		{
+			for (auto wordIndex = static_cast<unsigned>(first), i = wordIndex * BitMask::BITS_PER_WORD; wordIndex < last; wordIndex++)
+			{
+				auto word = activeMask.getWord(wordIndex);
+				for (auto bit = 0u; bit < BitMask::BITS_PER_WORD && i < flattenedSize; bit++, i++)
+				{
+					outGradients(i) = ((word >> bit) & 1) ? inGradients(i) : static_cast<BackwardType>(0.0f);
+				}
+			}
+		});
+	}
+
+
+	/*
+	 * @brief Derivative is computed from bit mask of positive cells, output is not needed
+	 */
+	virtual bool needsOutputForBackward() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Releases bit mask together with gradients
+	 */
+	virtual void releaseTrainingState() override
+	{
+		ILayer<_ForwardType, _WeightType>::releaseTrainingState();
+		activeMask.release();
+	}
+
+private:
+
+	/*
+	 * @brief Applies activation function on all cells without recording mask (cells are split among threads)
+	 */
+	void activate(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		ThreadPool::runParallel(in.getFlattenedSize(), 1, [&in, &out](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				out(i) = activateValue(in(i));
+			}
+		});
+	}
+
+private:
+
+	/// Bit mask of cells that were positive during last forward propagation
+	BitMask activeMask;
+
+};
+
 #endif
\ No newline at end of file
@@ -1,74 +1,176 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Sigmoid activation layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef SIGMOID_ACTIVATION_LAYER_H
-#define SIGMOID_ACTIVATION_LAYER_H
-
-#include "src/Layers/ILayer.h"
-#include "src/Layers/ActivationLayer.h"
-
-#include "src/Image.h"
-
-/*
- * @brief Sigmoid activation layer
- */
-template <class _ForwardType, class _WeightType>
-class SigmoidActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Initializes base class
-	 *
-	 * @param  input    Dimensions of input matrix
-	 */
-	SigmoidActivationLayer(const Dimensions & input)
-		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::Sigmoid)
-	{
-	}
-
-
-	/*
-	 * @brief Applies activation functions on all cells of input matrix
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != this->inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
-		}
-
-		auto flattenedSize = in.getFlattenedSize();
-
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			out(i) = static_cast<_ForwardType>(1.0f) / (static_cast<_ForwardType>(1.0f) + static_cast<_ForwardType>(exp(-in(i))));
-		}
-	}
-
-
-	/*
-	 * @brief Applies activation function derivative and computes output gradients
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> & out, 
-		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
-	{
-		auto flattenedSize = out.getFlattenedSize();
-
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			outGradients(i) = (static_cast<BackwardType>(out(i)) * (static_cast<BackwardType>(1.0) - static_cast<BackwardType>(out(i)))) * inGradients(i);
-		}
-	}
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Sigmoid activation layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef SIGMOID_ACTIVATION_LAYER_H
+#define SIGMOID_ACTIVATION_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/ActivationLayer.h"
+
+#include "src/Image.h"
+#include "src/Utils/ActivationTables.h"
+#include "src/Utils/FastMath.h"
+
+/*
+ * @brief Sigmoid activation layer
+ */
+template <class _ForwardType, class _WeightType>
+class SigmoidActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initializes base class
+	 *
+	 * @param  input    Dimensions of input matrix
+	 */
+	SigmoidActivationLayer(const Dimensions & input)
+		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::Sigmoid)
+	{
+	}
+
+
+	/*
+	 * @brief Applies activation functions on all cells of input matrix
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
+		}
+
+		activate(in, out);
+	}
+
+
+	/*
+	 * @brief Applies activation function on single value in accuracy selected in FastMath (used by kernels fused with previous layer)
+	 */
+	static _ForwardType activateValue(const _ForwardType value)
+	{
+		switch (FastMath::getAccuracy())
+		{
+			case MathAccuracy::Fast:
+				return computeValue<MathAccuracy::Fast>(value);
+			case MathAccuracy::Fastest:
+				return computeValue<MathAccuracy::Fastest>(value);
+			case MathAccuracy::Exact: default:
+				return computeValue<MathAccuracy::Exact>(value);
+		}
+	}
+
+
+	/*
+	 * @brief Applies activation function on single value in given accuracy
+	 */
+	template <MathAccuracy _Accuracy>
+	static _ForwardType computeValue(const _ForwardType value)
+	{
+		return computeValue<_Accuracy>(value, ActivationTables::IsTabulated<_ForwardType>());
+	}
+
+
+	/*
+	 * @brief Looks value up in table of fixed point format (always exact in precision of format)
+	 */
+	template <MathAccuracy _Accuracy>
+	static _ForwardType computeValue(const _ForwardType value, std::true_type)
+	{
+		return ActivationTables::sigmoid(value);
+	}
+
+
+	/*
+	 * @brief Computes value (approximations are computed in float)
+	 */
+	template <MathAccuracy _Accuracy>
+	static _ForwardType computeValue(const _ForwardType value, std::false_type)
+	{
+		if (_Accuracy != MathAccuracy::Exact)
+		{
+			return static_cast<_ForwardType>(FastMath::sigmoid<_Accuracy>(static_cast<float>(_ForwardType(value))));
+		}
+
+		return static_cast<_ForwardType>(1.0f) / (static_cast<_ForwardType>(1.0f) + static_cast<_ForwardType>(exp(-value)));
+	}
+
+
+	/*
+	 * @brief Compiled execution plan applies activation without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = SigmoidActivationLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::activate>;
+	}
+
+
+	/*
+	 * @brief Applies activation function derivative and computes output gradients
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> & out, 
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		ThreadPool::runParallel(out.getFlattenedSize(), 1, [&out, &inGradients, &outGradients](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				outGradients(i) = (static_cast<BackwardType>(out(i)) * (static_cast<BackwardType>(1.0) - static_cast<BackwardType>(out(i)))) * inGradients(i);
+			}
+		});
+	}
+
+private:
+
+	/*
+	 * @brief Applies activation function on all cells in accuracy selected in FastMath
+	 */
+	void activate(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		switch (FastMath::getAccuracy())
+		{
+			case MathAccuracy::Fast:
+				activateAll<MathAccuracy::Fast>(in, out);
+				break;
+			case MathAccuracy::Fastest:
+				activateAll<MathAccuracy::Fastest>(in, out);
+				break;
+			case MathAccuracy::Exact: default:
+				activateAll<MathAccuracy::Exact>(in, out);
+				break;
+		}
+	}
+
+
+	/*
+	 * @brief Applies activation function on all cells (cells are split among threads, approximations are vectorized)
+	 */
+	template <MathAccuracy _Accuracy>
+	void activateAll(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		// Exponential costs roughly as much as sixteen multiplications (approximation as four)
+		const auto cost = (_Accuracy == MathAccuracy::Exact) ? 16 : 4;
+		ThreadPool::runParallel(in.getFlattenedSize(), cost, [&in, &out](size_t first, size_t last)
+		{
+			const auto input = &in(0);
+			const auto output = &out(0);
+			for (auto i = first; i < last; i++)
+			{
+				output[i] = computeValue<_Accuracy>(input[i]);
+			}
+		});
+	}
+
+};
+
 #endif
\ No newline at end of file
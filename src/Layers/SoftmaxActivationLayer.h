@@ -1,111 +1,216 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Softmax activation layer
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef SOFTMAX_ACTIVATION_LAYER_H
-#define SOFTMAX_ACTIVATION_LAYER_H
-
-#include "src/Layers/ILayer.h"
-#include "src/Layers/ActivationLayer.h"
-#include "src/Image.h"
-#include "src/Utils/Limits.h"
-
- /*
-  * @brief Softmax activation layer
-  */
-template <class _ForwardType, class _WeightType>
-class SoftmaxActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
-{
-
-public:
-
-	/*
-	 * @brief Initializes base class
-	 *
-	 * @param  input    Dimensions of input matrix
-	 */
-	SoftmaxActivationLayer(const Dimensions & input)
-		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::SoftMax)
-	{
-	}
-
-
-	/*
-	 * @brief Applies activation functions on all cells of input matrix
-	 */
-	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
-	{
-		if (in.getDimensions() != this->inputSize)
-		{
-			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
-		}
-
-		auto flattenedSize = in.getFlattenedSize();
-
-		// Find maximum
-		softmaxMax = Limits::getMinimumValue<_ForwardType>();
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			if (in(i) > softmaxMax)
-			{
-				softmaxMax = in(i);
-			}
-		}
-
-		// Compute sum
-		softmaxSum = 0;
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			softmaxSum += static_cast<_ForwardType>(exp(in(i) - softmaxMax));
-		}
-
-		// Compute output values
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			out(i) = static_cast<_ForwardType>(exp(in(i) - softmaxMax)) / softmaxSum;
-		}
-	}
-
-
-	/*
-	 * @brief Applies activation function derivative and computes output gradients
-	 */
-	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> & out, 
-		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
-	{
-		auto flattenedSize = out.getFlattenedSize();
-
-		outGradients.clear();
-		for (auto i = 0u; i < flattenedSize; i++)
-		{
-			for (auto k = 0u; k < flattenedSize; k++)
-			{
-				if (i == k)
-				{
-					outGradients(i) += (static_cast<BackwardType>(out(i)) * (static_cast<BackwardType>(1) - static_cast<BackwardType>(out(i)))) * inGradients(k);
-				}
-				else
-				{
-					outGradients(i) += (-static_cast<BackwardType>(out(i)) * static_cast<BackwardType>(out(k))) * inGradients(k);
-				}
-			}
-		}
-	}
-
-private:
-
-	/// Sum used by softmax activation
-	_ForwardType softmaxSum;
-
-	/// Max used by softmax activation
-	_ForwardType softmaxMax;
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Softmax activation layer
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef SOFTMAX_ACTIVATION_LAYER_H
+#define SOFTMAX_ACTIVATION_LAYER_H
+
+#include "src/Layers/ILayer.h"
+#include "src/Layers/ActivationLayer.h"
+#include "src/Image.h"
+#include "src/Utils/ActivationTables.h"
+#include "src/Utils/FastMath.h"
+#include "src/Utils/Limits.h"
+
+ /*
+  * @brief Softmax activation layer
+  */
+template <class _ForwardType, class _WeightType>
+class SoftmaxActivationLayer : public ActivationLayer<_ForwardType, _WeightType>
+{
+
+public:
+
+	/*
+	 * @brief Initializes base class
+	 *
+	 * @param  input    Dimensions of input matrix
+	 */
+	SoftmaxActivationLayer(const Dimensions & input)
+		: ActivationLayer<_ForwardType, _WeightType>(input, ActivationFunction::SoftMax)
+	{
+	}
+
+
+	/*
+	 * @brief Applies activation functions on all cells of input matrix
+	 */
+	virtual void forwardPropagation(const Image<_ForwardType> & in, Image<_ForwardType> & out) override
+	{
+		if (in.getDimensions() != this->inputSize)
+		{
+			throw InputImageDoesNotHaveCorrectDimensions("Input to Activation layer has different dimensions than declared during initilization.");
+		}
+
+		activate(in, out);
+	}
+
+
+	/*
+	 * @brief Compiled execution plan applies activation without checking dimensions of input
+	 */
+	virtual typename ILayer<_ForwardType, _WeightType>::Kernel compileKernel() const override
+	{
+		using Layer = SoftmaxActivationLayer<_ForwardType, _WeightType>;
+
+		return &ILayer<_ForwardType, _WeightType>::template invokeKernel<Layer, &Layer::activate>;
+	}
+
+
+	/*
+	 * @brief Softmax gradient of each cell depends on all input gradients, it cannot run in place
+	 */
+	virtual bool supportsInPlace() const override
+	{
+		return false;
+	}
+
+
+	/*
+	 * @brief Applies activation function derivative and computes output gradients
+	 */
+	virtual void backwardPropagation(const Image<_ForwardType> &, const Image<_ForwardType> & out, 
+		const Image<BackwardType> & inGradients, Image<BackwardType> & outGradients, const TrainingSettings &) override
+	{
+		auto flattenedSize = out.getFlattenedSize();
+
+		// Product with Jacobian reduces to out(i) * (inGradients(i) - sum of out(k) * inGradients(k))
+		auto weightedSum = static_cast<BackwardType>(0);
+		for (auto k = 0u; k < flattenedSize; k++)
+		{
+			weightedSum += static_cast<BackwardType>(out(k)) * inGradients(k);
+		}
+
+		ThreadPool::runParallel(flattenedSize, 1, [&out, &inGradients, &outGradients, weightedSum](size_t first, size_t last)
+		{
+			for (auto i = static_cast<unsigned>(first); i < last; i++)
+			{
+				outGradients(i) = static_cast<BackwardType>(out(i)) * (inGradients(i) - weightedSum);
+			}
+		});
+	}
+
+private:
+
+	/*
+	 * @brief Applies activation function on all cells
+	 */
+	void activate(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		activate(in, out, ActivationTables::IsTabulated<_ForwardType>());
+	}
+
+
+	/*
+	 * @brief Applies activation function on all cells in accuracy selected in FastMath
+	 */
+	void activate(const Image<_ForwardType> & in, Image<_ForwardType> & out, std::false_type)
+	{
+		switch (FastMath::getAccuracy())
+		{
+			case MathAccuracy::Fast:
+				activateAll<MathAccuracy::Fast>(in, out);
+				break;
+			case MathAccuracy::Fastest:
+				activateAll<MathAccuracy::Fastest>(in, out);
+				break;
+			case MathAccuracy::Exact: default:
+				activateAll<MathAccuracy::Exact>(in, out);
+				break;
+		}
+	}
+
+
+	/*
+	 * @brief Applies activation function on all cells of fixed point type (exponentials are looked up in table, sum is kept in raw integers)
+	 */
+	void activate(const Image<_ForwardType> & in, Image<_ForwardType> & out, std::true_type)
+	{
+		auto flattenedSize = in.getFlattenedSize();
+
+		// Find maximum
+		auto softmaxMax = Limits::getMinimumValue<_ForwardType>();
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			if (in(i) > softmaxMax)
+			{
+				softmaxMax = in(i);
+			}
+		}
+
+		// Compute exponentials and their sum (it does not saturate at maximum of format)
+		int64_t softmaxSum = 0;
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			out(i) = ActivationTables::exp(in(i) - softmaxMax);
+			softmaxSum += out(i).getRaw();
+		}
+
+		// Compute output values
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			out(i) = ActivationTables::divide(out(i), softmaxSum);
+		}
+	}
+
+
+	/*
+	 * @brief Returns exponential of value in given accuracy (approximations are computed in float)
+	 */
+	template <MathAccuracy _Accuracy>
+	static _ForwardType exponential(_ForwardType value)
+	{
+		if (_Accuracy != MathAccuracy::Exact)
+		{
+			return static_cast<_ForwardType>(FastMath::exp<_Accuracy>(static_cast<float>(value)));
+		}
+
+		return static_cast<_ForwardType>(exp(value));
+	}
+
+
+	/*
+	 * @brief Applies activation function on all cells (maximum and sum are local, so that concurrent inference is possible)
+	 */
+	template <MathAccuracy _Accuracy>
+	void activateAll(const Image<_ForwardType> & in, Image<_ForwardType> & out)
+	{
+		auto flattenedSize = in.getFlattenedSize();
+
+		// Find maximum
+		auto softmaxMax = Limits::getMinimumValue<_ForwardType>();
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			if (in(i) > softmaxMax)
+			{
+				softmaxMax = in(i);
+			}
+		}
+
+		// Compute exponentials (once) and their sum, softmax does not run in place
+		auto softmaxSum = static_cast<_ForwardType>(0);
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			out(i) = exponential<_Accuracy>(in(i) - softmaxMax);
+		}
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			softmaxSum += out(i);
+		}
+
+		// Compute output values
+		for (auto i = 0u; i < flattenedSize; i++)
+		{
+			out(i) = out(i) / softmaxSum;
+		}
+	}
+
+};
+
 #endif
\ No newline at end of file
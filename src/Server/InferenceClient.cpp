@@ -0,0 +1,109 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Client of inference server
+ */
+
+#include "src/Server/InferenceClient.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/*
+ * @brief Connects to server
+ *
+ * @throws ServerException if server is not listening on given socket
+ */
+InferenceClient::InferenceClient(const std::string & socketPath)
+{
+#ifndef _WIN32
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+	{
+		throw ServerException("Socket path is empty or too long.");
+	}
+	socketPath.copy(address.sun_path, socketPath.size());
+
+	connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (connection < 0)
+	{
+		throw ServerException("Could not create socket.");
+	}
+
+	if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		close(connection);
+		connection = -1;
+		throw ServerException("Could not connect to \"" + socketPath + "\".");
+	}
+#else
+	(void)socketPath;
+	throw ServerException("Unix domain sockets are not supported on this platform.");
+#endif
+}
+
+
+/*
+ * @brief Closes connection
+ */
+InferenceClient::~InferenceClient()
+{
+#ifndef _WIN32
+	if (connection >= 0)
+	{
+		close(connection);
+	}
+#endif
+}
+
+
+/*
+ * @brief Sends input tensor and returns output of network
+ *
+ * @throws ServerException if server could not process request or if connection was closed
+ */
+Image<ForwardType> InferenceClient::infer(const Image<ForwardType> & input)
+{
+	return request(Protocol::RequestType::Tensor, Protocol::encodeTensor(input));
+}
+
+
+/*
+ * @brief Sends PNG file and returns output of network
+ *
+ * @throws ServerException if server could not process request or if connection was closed
+ */
+Image<ForwardType> InferenceClient::inferPng(const std::vector<unsigned char> & png)
+{
+	return request(Protocol::RequestType::Png, png);
+}
+
+
+/*
+ * @brief Sends request and waits for response
+ */
+Image<ForwardType> InferenceClient::request(const Protocol::RequestType type, const std::vector<unsigned char> & payload)
+{
+	if (!Protocol::sendFrame(connection, static_cast<uint32_t>(type), payload))
+	{
+		throw ServerException("Connection to server was closed.");
+	}
+
+	uint32_t status;
+	std::vector<unsigned char> response;
+	if (!Protocol::receiveFrame(connection, status, response))
+	{
+		throw ServerException("Connection to server was closed.");
+	}
+
+	if (static_cast<Protocol::ResponseStatus>(status) != Protocol::ResponseStatus::Ok)
+	{
+		throw ServerException(std::string(response.begin(), response.end()));
+	}
+
+	return Protocol::decodeTensor(response);
+}
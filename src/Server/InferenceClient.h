@@ -0,0 +1,50 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Client of inference server
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef INFERENCE_CLIENT_H
+#define INFERENCE_CLIENT_H
+
+#include "src/Server/Protocol.h"
+
+#include <string>
+#include <vector>
+
+/*
+ * @brief Connection to inference server, requests are sent one after another over the same connection
+ */
+class InferenceClient
+{
+
+public:
+
+	explicit InferenceClient(const std::string & socketPath);
+
+	~InferenceClient();
+
+	InferenceClient(const InferenceClient &) = delete;
+
+	InferenceClient & operator=(const InferenceClient &) = delete;
+
+	Image<ForwardType> infer(const Image<ForwardType> & input);
+
+	Image<ForwardType> inferPng(const std::vector<unsigned char> & png);
+
+private:
+
+	Image<ForwardType> request(const Protocol::RequestType type, const std::vector<unsigned char> & payload);
+
+private:
+
+	/// Connected socket
+	int connection = -1;
+
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Scheduler coalescing concurrent inference requests into batches
+ */
+
+#include "src/Server/InferenceScheduler.h"
+
+#include <algorithm>
+#include <iterator>
+
+constexpr size_t InferenceScheduler::LATENCY_WINDOW;
+
+/*
+ * @brief Starts dispatcher
+ *
+ * @param cnn           Network used for inference (must outlive scheduler)
+ * @param maxBatchSize  Largest number of requests run together
+ * @param maxDelay      Longest time request waits for others to form batch (us)
+ */
+InferenceScheduler::InferenceScheduler(const ConvolutionalNeuralNetwork & cnn, const unsigned maxBatchSize, const unsigned maxDelay)
+	: cnn(cnn)
+	, maxBatchSize(maxBatchSize == 0 ? 1 : maxBatchSize)
+	, maxDelay(maxDelay)
+{
+	pending.reserve(this->maxBatchSize);
+	latencies.reserve(LATENCY_WINDOW);
+	dispatcher = std::thread(&InferenceScheduler::dispatch, this);
+}
+
+
+/*
+ * @brief Completes waiting requests and stops dispatcher
+ */
+InferenceScheduler::~InferenceScheduler()
+{
+	stop();
+}
+
+
+/*
+ * @brief Queues input for inference
+ *
+ * @return future  Output of network, holds CNNException if input does not fit network or if scheduler was stopped
+ */
+std::future<Image<ForwardType>> InferenceScheduler::submit(const Image<ForwardType> & input)
+{
+	Request request;
+	request.input = input;
+	request.submitted = std::chrono::steady_clock::now();
+	auto future = request.result.get_future();
+
+	if (Dimensions{ input.getWidth(), input.getHeight(), input.getDepth() } != cnn.getInputSize())
+	{
+		request.result.set_exception(std::make_exception_ptr(CNNException("Input has different dimensions than network.")));
+		return future;
+	}
+
+	size_t waiting;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (!running)
+		{
+			request.result.set_exception(std::make_exception_ptr(CNNException("Scheduler was stopped.")));
+			return future;
+		}
+
+		pending.push_back(std::move(request));
+		waiting = pending.size();
+		queueDepth = waiting;
+	}
+
+	// Dispatcher sleeps either until first request arrives or until batch is full
+	if (waiting == 1 || waiting >= maxBatchSize)
+	{
+		queueCondition.notify_one();
+	}
+
+	return future;
+}
+
+
+/*
+ * @brief Stops accepting requests, requests already queued are completed
+ */
+void InferenceScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (!running)
+		{
+			return;
+		}
+		running = false;
+	}
+
+	queueCondition.notify_one();
+	dispatcher.join();
+}
+
+
+/*
+ * @brief Returns current queue depth, counters and latency percentiles
+ */
+SchedulerStatistics InferenceScheduler::getStatistics() const
+{
+	SchedulerStatistics statistics;
+	statistics.queueDepth = queueDepth;
+
+	std::vector<float> sorted;
+	{
+		std::lock_guard<std::mutex> lock(statisticsMutex);
+		statistics.completedRequestNum = completedRequestNum;
+		statistics.batchNum = batchNum;
+		sorted = latencies;
+	}
+
+	if (!sorted.empty())
+	{
+		std::sort(sorted.begin(), sorted.end());
+		statistics.p50Latency = sorted[(sorted.size() - 1) / 2];
+		statistics.p99Latency = sorted[(sorted.size() - 1) * 99 / 100];
+	}
+
+	return statistics;
+}
+
+
+/*
+ * @brief Dispatcher loop, waits until batch is full or its first request is too old and runs it
+ */
+void InferenceScheduler::dispatch()
+{
+	std::vector<Request> batch;
+	batch.reserve(maxBatchSize);
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return !running || !pending.empty(); });
+			if (pending.empty())
+			{
+				return;
+			}
+
+			auto deadline = pending.front().submitted + maxDelay;
+			queueCondition.wait_until(lock, deadline, [this]() { return !running || pending.size() >= maxBatchSize; });
+
+			// Take whole batch at once, submitters then append into empty buffer
+			if (pending.size() <= maxBatchSize)
+			{
+				std::swap(batch, pending);
+			}
+			else
+			{
+				std::move(pending.begin(), pending.begin() + maxBatchSize, std::back_inserter(batch));
+				pending.erase(pending.begin(), pending.begin() + maxBatchSize);
+			}
+			queueDepth = pending.size();
+		}
+
+		runBatch(batch);
+		batch.clear();
+	}
+}
+
+
+/*
+ * @brief Runs batch through network and completes futures of its requests
+ */
+void InferenceScheduler::runBatch(std::vector<Request> & batch)
+{
+	std::vector<Image<ForwardType>> inputs;
+	inputs.reserve(batch.size());
+	for (const auto & request : batch)
+	{
+		inputs.push_back(request.input);
+	}
+
+	try
+	{
+		auto outputs = cnn.runBatch(inputs);
+		auto outputSize = cnn.getOutputSize();
+		auto rowSize = outputs.getWidth();
+		for (auto row = 0u; row < batch.size(); row++)
+		{
+			Image<ForwardType> output(outputSize);
+			std::copy(&outputs(0, row), &outputs(0, row) + rowSize, &output(0));
+			batch[row].result.set_value(output);
+		}
+	}
+	catch (...)
+	{
+		for (auto & request : batch)
+		{
+			request.result.set_exception(std::current_exception());
+		}
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	for (const auto & request : batch)
+	{
+		auto latency = std::chrono::duration<float, std::micro>(now - request.submitted).count();
+		if (latencies.size() < LATENCY_WINDOW)
+		{
+			latencies.push_back(latency);
+		}
+		else
+		{
+			latencies[latencyPosition] = latency;
+		}
+		latencyPosition = (latencyPosition + 1) % LATENCY_WINDOW;
+	}
+	completedRequestNum += batch.size();
+	batchNum++;
+}
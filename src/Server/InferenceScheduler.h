@@ -0,0 +1,138 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Scheduler coalescing concurrent inference requests into batches
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef INFERENCE_SCHEDULER_H
+#define INFERENCE_SCHEDULER_H
+
+#include "src/ConvolutionalNeuralNetwork.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * @brief Statistics of scheduler (latency is measured from submission to completion)
+ */
+struct SchedulerStatistics
+{
+	/// Requests waiting to be batched
+	size_t queueDepth = 0;
+
+	/// Requests completed since start
+	uint64_t completedRequestNum = 0;
+
+	/// Batches run since start
+	uint64_t batchNum = 0;
+
+	/// Median latency of recent requests (us)
+	float p50Latency = 0.0f;
+
+	/// 99th percentile latency of recent requests (us)
+	float p99Latency = 0.0f;
+};
+
+/*
+ * @brief Collects requests submitted by any number of threads and runs them through network in batches
+ *
+ * Batch is dispatched when maxBatchSize requests are waiting or when the oldest waiting request is maxDelay
+ * microseconds old. Submitting threads only append to pending batch, dispatcher takes the whole batch at once.
+ */
+class InferenceScheduler
+{
+
+public:
+
+	InferenceScheduler(const ConvolutionalNeuralNetwork & cnn, const unsigned maxBatchSize, const unsigned maxDelay);
+
+	~InferenceScheduler();
+
+	InferenceScheduler(const InferenceScheduler &) = delete;
+
+	InferenceScheduler & operator=(const InferenceScheduler &) = delete;
+
+	std::future<Image<ForwardType>> submit(const Image<ForwardType> & input);
+
+	void stop();
+
+	SchedulerStatistics getStatistics() const;
+
+private:
+
+	/*
+	 * @brief Request waiting in queue
+	 */
+	struct Request
+	{
+		Image<ForwardType> input;
+
+		std::promise<Image<ForwardType>> result;
+
+		std::chrono::steady_clock::time_point submitted;
+	};
+
+	void dispatch();
+
+	void runBatch(std::vector<Request> & batch);
+
+private:
+
+	/// Number of latencies used for percentiles
+	static constexpr size_t LATENCY_WINDOW = 8192;
+
+	/// Network shared with other users (only read)
+	const ConvolutionalNeuralNetwork & cnn;
+
+	/// Largest number of requests in batch
+	unsigned maxBatchSize;
+
+	/// Longest time the first request of batch waits for others
+	std::chrono::microseconds maxDelay;
+
+	/// Scheduler accepts requests
+	bool running = true;
+
+	/// Protects pending requests and running flag
+	std::mutex queueMutex;
+
+	/// Signals new request or shutdown
+	std::condition_variable queueCondition;
+
+	/// Requests waiting for dispatch
+	std::vector<Request> pending;
+
+	/// Number of waiting requests (readable without lock)
+	std::atomic<size_t> queueDepth{ 0 };
+
+	/// Protects statistics
+	mutable std::mutex statisticsMutex;
+
+	/// Latencies of recent requests (ring buffer, us)
+	std::vector<float> latencies;
+
+	/// Position of next latency in ring buffer
+	size_t latencyPosition = 0;
+
+	/// Requests completed since start
+	uint64_t completedRequestNum = 0;
+
+	/// Batches run since start
+	uint64_t batchNum = 0;
+
+	/// Thread forming and running batches
+	std::thread dispatcher;
+
+};
+
+#endif
@@ -0,0 +1,332 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Inference server listening on Unix domain socket
+ */
+
+#include "src/Server/InferenceServer.h"
+
+#include "src/Parsers/PngParser.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/// How often blocked threads check that server is still running (ms)
+constexpr int POLL_INTERVAL = 100;
+
+/// Time after which client that stopped sending in the middle of frame is disconnected (s)
+constexpr int RECEIVE_TIMEOUT = 5;
+
+/*
+ * @brief Initializes server, nothing is opened until start is called
+ *
+ * @param cnn          Network used for inference (must outlive server)
+ * @param socketPath   Path of Unix domain socket
+ * @param workerNum    Number of connections served concurrently
+ * @param grayscale    PNG images are converted to grayscale
+ */
+InferenceServer::InferenceServer(const ConvolutionalNeuralNetwork & cnn, const std::string & socketPath, const unsigned workerNum, const bool grayscale /*= false*/)
+	: cnn(cnn)
+	, socketPath(socketPath)
+	, workerNum(workerNum == 0 ? 1 : workerNum)
+	, grayscale(grayscale)
+{
+}
+
+
+/*
+ * @brief Stops server if it is running
+ */
+InferenceServer::~InferenceServer()
+{
+	stop();
+}
+
+
+/*
+ * @brief Runs requests of concurrent clients in batches, must be called before start
+ *
+ * @param maxBatchSize  Largest number of requests run together
+ * @param maxDelay      Longest time request waits for others to form batch (us)
+ */
+void InferenceServer::enableBatching(const unsigned maxBatchSize, const unsigned maxDelay)
+{
+	if (running)
+	{
+		throw ServerException("Batching cannot be enabled while server is running.");
+	}
+
+	scheduler = std::make_unique<InferenceScheduler>(cnn, maxBatchSize, maxDelay);
+}
+
+
+/*
+ * @brief Binds socket and starts accepting connections (returns immediately)
+ *
+ * @throws ServerException if socket could not be created
+ */
+void InferenceServer::start()
+{
+#ifndef _WIN32
+	if (running)
+	{
+		return;
+	}
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+	{
+		throw ServerException("Socket path is empty or too long.");
+	}
+	socketPath.copy(address.sun_path, socketPath.size());
+
+	listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listeningSocket < 0)
+	{
+		throw ServerException("Could not create socket.");
+	}
+
+	// Socket file left by previous instance would prevent binding
+	unlink(socketPath.c_str());
+	if (bind(listeningSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listeningSocket, SOMAXCONN) != 0)
+	{
+		close(listeningSocket);
+		listeningSocket = -1;
+		throw ServerException("Could not bind socket \"" + socketPath + "\".");
+	}
+
+	running = true;
+	acceptor = std::thread(&InferenceServer::acceptConnections, this);
+	for (auto i = 0u; i < workerNum; i++)
+	{
+		workers.emplace_back(&InferenceServer::serveConnections, this);
+	}
+#else
+	throw ServerException("Unix domain sockets are not supported on this platform.");
+#endif
+}
+
+
+/*
+ * @brief Stops accepting connections, lets workers finish requests in progress and removes socket
+ */
+void InferenceServer::stop()
+{
+#ifndef _WIN32
+	if (!running)
+	{
+		return;
+	}
+
+	running = false;
+	queueCondition.notify_all();
+
+	acceptor.join();
+	for (auto & worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+
+	// No more requests can be submitted, so scheduler is not needed anymore
+	if (scheduler)
+	{
+		scheduler->stop();
+	}
+
+	// Connections that were never served
+	for (const auto & connection : pendingConnections)
+	{
+		close(connection);
+	}
+	pendingConnections.clear();
+
+	close(listeningSocket);
+	listeningSocket = -1;
+	unlink(socketPath.c_str());
+#endif
+}
+
+
+/*
+ * @brief Returns true if server accepts connections
+ */
+bool InferenceServer::isRunning() const
+{
+	return running;
+}
+
+
+/*
+ * @brief Returns number of answered requests (including those answered with error)
+ */
+uint64_t InferenceServer::getServedRequestNum() const
+{
+	return servedRequestNum;
+}
+
+
+/*
+ * @brief Returns scheduler with batching statistics (null if batching is disabled)
+ */
+const InferenceScheduler * InferenceServer::getScheduler() const
+{
+	return scheduler.get();
+}
+
+
+/*
+ * @brief Accepts connections and passes them to workers
+ */
+void InferenceServer::acceptConnections()
+{
+#ifndef _WIN32
+	while (running)
+	{
+		pollfd descriptor = { listeningSocket, POLLIN, 0 };
+		if (poll(&descriptor, 1, POLL_INTERVAL) <= 0)
+		{
+			continue;
+		}
+
+		auto connection = accept(listeningSocket, nullptr, nullptr);
+		if (connection < 0)
+		{
+			continue;
+		}
+
+		timeval timeout = { RECEIVE_TIMEOUT, 0 };
+		setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			pendingConnections.push_back(connection);
+		}
+		queueCondition.notify_one();
+	}
+#endif
+}
+
+
+/*
+ * @brief Worker loop, serves queued connections until server stops
+ */
+void InferenceServer::serveConnections()
+{
+	while (true)
+	{
+		int connection;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return !running || !pendingConnections.empty(); });
+			if (!running)
+			{
+				return;
+			}
+
+			connection = pendingConnections.front();
+			pendingConnections.pop_front();
+		}
+
+		serveConnection(connection);
+	}
+}
+
+
+/*
+ * @brief Answers requests of one client until it disconnects or server stops
+ */
+void InferenceServer::serveConnection(const int connection)
+{
+#ifndef _WIN32
+	while (running)
+	{
+		// Wait for next request, but notice when server is being stopped
+		pollfd descriptor = { connection, POLLIN, 0 };
+		auto ready = poll(&descriptor, 1, POLL_INTERVAL);
+		if (ready == 0)
+		{
+			continue;
+		}
+		else if (ready < 0)
+		{
+			break;
+		}
+
+		uint32_t type;
+		std::vector<unsigned char> payload;
+		try
+		{
+			if (!Protocol::receiveFrame(connection, type, payload))
+			{
+				break;
+			}
+		}
+		catch (const ProtocolException & e)
+		{
+			// Stream cannot be resynchronized, report and disconnect
+			std::string message = e.what();
+			Protocol::sendFrame(connection, static_cast<uint32_t>(Protocol::ResponseStatus::Error), std::vector<unsigned char>(message.begin(), message.end()));
+			break;
+		}
+
+		auto status = Protocol::ResponseStatus::Ok;
+		std::vector<unsigned char> response;
+		try
+		{
+			response = processRequest(type, payload);
+		}
+		catch (const std::exception & e)
+		{
+			std::string message = e.what();
+			status = Protocol::ResponseStatus::Error;
+			response.assign(message.begin(), message.end());
+		}
+
+		servedRequestNum++;
+		if (!Protocol::sendFrame(connection, static_cast<uint32_t>(status), response))
+		{
+			break;
+		}
+	}
+
+	close(connection);
+#else
+	(void)connection;
+#endif
+}
+
+
+/*
+ * @brief Decodes input, runs network in shared thread pool and encodes output
+ *
+ * @throws ProtocolException if request type is unknown, other exceptions if input is not valid
+ */
+std::vector<unsigned char> InferenceServer::processRequest(const uint32_t type, const std::vector<unsigned char> & payload)
+{
+	Image<ForwardType> input;
+	switch (static_cast<Protocol::RequestType>(type))
+	{
+		case Protocol::RequestType::Tensor:
+			input.shareWith(Protocol::decodeTensor(payload));
+			break;
+		case Protocol::RequestType::Png:
+			input.shareWith(PngParser::parseInputImageFromMemory(payload, grayscale));
+			break;
+		default:
+			throw ProtocolException("Unknown request type.");
+	}
+
+	if (scheduler)
+	{
+		return Protocol::encodeTensor(scheduler->submit(input).get());
+	}
+
+	return Protocol::encodeTensor(cnn.runAsync(input).get());
+}
@@ -0,0 +1,114 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Inference server listening on Unix domain socket
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef INFERENCE_SERVER_H
+#define INFERENCE_SERVER_H
+
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Server/InferenceScheduler.h"
+#include "src/Server/Protocol.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * @brief Serves inference requests of local clients with network loaded once
+ *
+ * Accepted connections are queued and served by workers, each worker serves one connection at a time
+ * (connection may carry any number of requests). Workers only receive requests and send responses, networks run
+ * in shared thread pool (so computation is not oversubscribed). When batching is enabled, workers pass inputs
+ * to scheduler which runs concurrent requests together.
+ */
+class InferenceServer
+{
+
+public:
+
+	InferenceServer(const ConvolutionalNeuralNetwork & cnn, const std::string & socketPath, const unsigned workerNum, const bool grayscale = false);
+
+	~InferenceServer();
+
+	InferenceServer(const InferenceServer &) = delete;
+
+	InferenceServer & operator=(const InferenceServer &) = delete;
+
+	void enableBatching(const unsigned maxBatchSize, const unsigned maxDelay);
+
+	void start();
+
+	void stop();
+
+	bool isRunning() const;
+
+	uint64_t getServedRequestNum() const;
+
+	const InferenceScheduler * getScheduler() const;
+
+private:
+
+	void acceptConnections();
+
+	void serveConnections();
+
+	void serveConnection(const int connection);
+
+	std::vector<unsigned char> processRequest(const uint32_t type, const std::vector<unsigned char> & payload);
+
+private:
+
+	/// Network shared by all workers (only read)
+	const ConvolutionalNeuralNetwork & cnn;
+
+	/// Path of socket in file system
+	std::string socketPath;
+
+	/// Number of workers
+	unsigned workerNum;
+
+	/// PNG images are converted to grayscale
+	bool grayscale;
+
+	/// Listening socket
+	int listeningSocket = -1;
+
+	/// Server accepts and serves connections
+	std::atomic<bool> running{ false };
+
+	/// Number of answered requests
+	std::atomic<uint64_t> servedRequestNum{ 0 };
+
+	/// Thread accepting connections
+	std::thread acceptor;
+
+	/// Threads serving connections (not pinned, they mostly wait for sockets and results)
+	std::vector<std::thread> workers;
+
+	/// Protects queue of accepted connections
+	std::mutex queueMutex;
+
+	/// Signals new connection or shutdown
+	std::condition_variable queueCondition;
+
+	/// Accepted connections waiting for worker
+	std::deque<int> pendingConnections;
+
+	/// Scheduler forming batches (null if batching is disabled)
+	std::unique_ptr<InferenceScheduler> scheduler;
+
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Binary framing used by inference server and client
+ */
+
+#include "src/Server/Protocol.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/types.h>
+#endif
+
+namespace
+{
+
+#ifndef _WIN32
+
+/*
+ * @brief Sends whole buffer (retries on interrupts and partial writes)
+ */
+bool sendAll(const int socket, const unsigned char * buffer, size_t length)
+{
+	while (length > 0)
+	{
+		auto sent = send(socket, buffer, length, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (sent <= 0)
+		{
+			return false;
+		}
+
+		buffer += sent;
+		length -= static_cast<size_t>(sent);
+	}
+
+	return true;
+}
+
+
+/*
+ * @brief Receives exactly given number of bytes (returns false if connection was closed)
+ */
+bool receiveAll(const int socket, unsigned char * buffer, size_t length)
+{
+	while (length > 0)
+	{
+		auto received = recv(socket, buffer, length, 0);
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (received <= 0)
+		{
+			return false;
+		}
+
+		buffer += received;
+		length -= static_cast<size_t>(received);
+	}
+
+	return true;
+}
+
+#endif
+
+} // anonymous namespace
+
+
+/*
+ * @brief Sends frame with given type and payload, returns false if connection was closed
+ */
+bool Protocol::sendFrame(const int socket, const uint32_t type, const std::vector<unsigned char> & payload)
+{
+#ifndef _WIN32
+	FrameHeader header = { MAGIC, type, static_cast<uint32_t>(payload.size()) };
+
+	return sendAll(socket, reinterpret_cast<const unsigned char *>(&header), sizeof(header))
+		&& sendAll(socket, payload.data(), payload.size());
+#else
+	(void)socket; (void)type; (void)payload;
+	return false;
+#endif
+}
+
+
+/*
+ * @brief Receives frame, returns false if connection was closed
+ *
+ * @throws ProtocolException if frame does not start with magic number or if payload is too large
+ */
+bool Protocol::receiveFrame(const int socket, uint32_t & type, std::vector<unsigned char> & payload)
+{
+#ifndef _WIN32
+	FrameHeader header;
+	if (!receiveAll(socket, reinterpret_cast<unsigned char *>(&header), sizeof(header)))
+	{
+		return false;
+	}
+
+	if (header.magic != MAGIC)
+	{
+		throw ProtocolException("Frame does not start with magic number.");
+	}
+	else if (header.length > MAX_PAYLOAD_SIZE)
+	{
+		throw ProtocolException("Frame payload is too large.");
+	}
+
+	type = header.type;
+	payload.resize(header.length);
+
+	return receiveAll(socket, payload.data(), payload.size());
+#else
+	(void)socket; (void)type; (void)payload;
+	return false;
+#endif
+}
@@ -0,0 +1,152 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Binary framing used by inference server and client
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "src/CompileSettings.h"
+#include "src/Image.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * @brief Thrown if server could not be started or if communication fails
+ */
+class ServerException : public std::runtime_error
+{
+public:
+
+	explicit ServerException(const std::string & msg)
+		: std::runtime_error(msg.c_str())
+	{
+	}
+};
+
+/*
+ * @brief Thrown if received frame is not valid
+ */
+class ProtocolException : public ServerException
+{
+	using ServerException::ServerException;
+};
+
+/*
+ * @brief Framing of requests and responses (all numbers are in host byte order, both sides run on the same machine)
+ *
+ * Request:   magic, request type, payload length, payload
+ * Response:  magic, response status, payload length, payload
+ *
+ * Tensor payload contains width, height and depth (uint32) followed by width * height * depth values (float32).
+ * Png payload contains bytes of PNG file. Successful response carries output tensor, error response carries message.
+ */
+namespace Protocol
+{
+
+	/// Marks beginning of each frame ("TCNN")
+	constexpr uint32_t MAGIC = 0x4E4E4354;
+
+	/// Largest accepted payload
+	constexpr uint32_t MAX_PAYLOAD_SIZE = 256 * 1024 * 1024;
+
+	/*
+	 * @brief Type of request payload
+	 */
+	enum class RequestType : uint32_t
+	{
+		Tensor = 1,
+		Png = 2
+	};
+
+	/*
+	 * @brief Result of request
+	 */
+	enum class ResponseStatus : uint32_t
+	{
+		Ok = 0,
+		Error = 1
+	};
+
+	/*
+	 * @brief Header preceding each payload
+	 */
+	struct FrameHeader
+	{
+		uint32_t magic;
+
+		uint32_t type;
+
+		uint32_t length;
+	};
+
+
+	/*
+	 * @brief Serializes image into tensor payload
+	 */
+	inline std::vector<unsigned char> encodeTensor(const Image<ForwardType> & image)
+	{
+		uint32_t dimensions[3] = { image.getWidth(), image.getHeight(), image.getDepth() };
+		std::vector<unsigned char> payload(sizeof(dimensions) + image.getFlattenedSize() * sizeof(float));
+
+		std::memcpy(payload.data(), dimensions, sizeof(dimensions));
+		auto values = payload.data() + sizeof(dimensions);
+		for (auto i = 0u; i < image.getFlattenedSize(); i++)
+		{
+			auto value = static_cast<float>(image(i));
+			std::memcpy(values + i * sizeof(float), &value, sizeof(float));
+		}
+
+		return payload;
+	}
+
+
+	/*
+	 * @brief Deserializes tensor payload into image
+	 *
+	 * @throws ProtocolException if payload size does not correspond to its dimensions
+	 */
+	inline Image<ForwardType> decodeTensor(const std::vector<unsigned char> & payload)
+	{
+		uint32_t dimensions[3];
+		if (payload.size() < sizeof(dimensions))
+		{
+			throw ProtocolException("Tensor payload is too short.");
+		}
+		std::memcpy(dimensions, payload.data(), sizeof(dimensions));
+
+		auto valueNum = static_cast<uint64_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+		if (payload.size() != sizeof(dimensions) + valueNum * sizeof(float))
+		{
+			throw ProtocolException("Tensor payload size does not correspond to its dimensions.");
+		}
+
+		Image<ForwardType> image(Dimensions{ dimensions[0], dimensions[1], dimensions[2] });
+		auto values = payload.data() + sizeof(dimensions);
+		for (auto i = 0u; i < image.getFlattenedSize(); i++)
+		{
+			float value;
+			std::memcpy(&value, values + i * sizeof(float), sizeof(float));
+			image(i) = static_cast<ForwardType>(value);
+		}
+
+		return image;
+	}
+
+
+	bool sendFrame(const int socket, const uint32_t type, const std::vector<unsigned char> & payload);
+
+	bool receiveFrame(const int socket, uint32_t & type, std::vector<unsigned char> & payload);
+
+} // namespace Protocol
+
+#endif
@@ -1,74 +1,96 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Training settings
- */
-
-#ifdef _MSC_VER
-#pragma once
-#endif
-
-#ifndef TRAINING_SETTINGS_H
-#define TRAINING_SETTINGS_H
-
-/*
- * @brief Type of task (C)NN is solving (adjusts return types and output messages)
- */
-enum class TaskType
-{
-	Classification,
-	Regression
-};
-
-/*
- * Specifies loss function that computes how incorrect current output is
- */
-enum class LossFunctionType
-{
-	MeanSquaredError, // for regression
-	CrossEntropy, // for multiclass classification
-	BinaryCrossEntropy // for binary classification
-};
-
-/*
- * @brief Defines available training optimizers
- */
-enum class OptimizerType
-{
-	Adagrad,
-	Adam,
-	Sgd,
-	SgdWithMomentum,
-	SgdWithNestorovMomentum
-};
-
-/*
- * @brief Settings that are used by training algorithm
- */
-struct TrainingSettings
-{
-
-	/// Number of training epochs
-	unsigned epochs = 10;
-
-	/// Each X epochs, current error will be written to std::cout (if output is enabled)
-	unsigned epochOutputRate = 1;
-
-	/// Periodic output of average error (0 == none)
-	unsigned errorOutputRate = 0;
-
-	/// Validation before and after each epoch
-	bool periodicValidation = false;
-
-	/// Shuffle training data before each epoch begins
-	bool shuffle = false;
-
-	/// Batch size
-	/// 1	                == Stochastic (online) gradient descent
-	/// 1 < n < Data size   == Minibatch gradient descent
-	/// Data size           == Batch gradient descent
-	unsigned batchSize = 1;
-
-};
-
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Training settings
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef TRAINING_SETTINGS_H
+#define TRAINING_SETTINGS_H
+
+#include <cstddef>
+
+/*
+ * @brief Type of task (C)NN is solving (adjusts return types and output messages)
+ */
+enum class TaskType
+{
+	Classification,
+	Regression
+};
+
+/*
+ * Specifies loss function that computes how incorrect current output is
+ */
+enum class LossFunctionType
+{
+	MeanSquaredError, // for regression
+	CrossEntropy, // for multiclass classification
+	BinaryCrossEntropy // for binary classification
+};
+
+/*
+ * @brief Defines available training optimizers
+ */
+enum class OptimizerType
+{
+	Adagrad,
+	Adam,
+	Sgd,
+	SgdWithMomentum,
+	SgdWithNestorovMomentum
+};
+
+/*
+ * @brief Defines how layers whose outputs are kept during training (checkpoints) are chosen,
+ *            outputs of other layers are recomputed during backward propagation
+ */
+enum class CheckpointingStrategy
+{
+	Explicit, // layers marked in XML, all outputs are kept if no layer is marked
+	SquareRoot, // every sqrt(N)-th layer
+	MemoryBudget // least recomputation that fits into given memory
+};
+
+/*
+ * @brief Settings that are used by training algorithm
+ */
+struct TrainingSettings
+{
+
+	/// Number of training epochs
+	unsigned epochs = 10;
+
+	/// Each X epochs, current error will be written to std::cout (if output is enabled)
+	unsigned epochOutputRate = 1;
+
+	/// Periodic output of average error (0 == none)
+	unsigned errorOutputRate = 0;
+
+	/// Validation before and after each epoch
+	bool periodicValidation = false;
+
+	/// Shuffle training data before each epoch begins
+	bool shuffle = false;
+
+	/// Batch size
+	/// 1	                == Stochastic (online) gradient descent
+	/// 1 < n < Data size   == Minibatch gradient descent
+	/// Data size           == Batch gradient descent
+	unsigned batchSize = 1;
+
+	/// Placement of checkpoints for gradient checkpointing
+	CheckpointingStrategy checkpointing = CheckpointingStrategy::Explicit;
+
+	/// Memory available for layer outputs when checkpoints are placed by memory budget (bytes)
+	size_t checkpointingMemoryBudget = 0;
+
+	/// Number of classes sampled besides expected one when training softmax with cross entropy (0 == full softmax)
+	unsigned sampledClasses = 0;
+
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,199 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Lookup tables of activation functions for fixed point numbers
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef ACTIVATION_TABLES_H
+#define ACTIVATION_TABLES_H
+
+#include "src/Utils/FixedPointNumber.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/*
+ * @brief Function of fixed point number tabulated over raw integer representation
+ *
+ * Table covers inputs in [first, last], outside of them function is saturated (value at the nearest end is returned).
+ * If range has at most MAX_EXACT_ENTRIES inputs, table has entry for each of them. Otherwise it has entry
+ * for every 2^shift-th input (at most MAX_SEGMENTS segments) and values in between are interpolated linearly.
+ * Entries of such tables keep INTERPOLATION_BITS more bits, so that result is rounded only once.
+ * Lookup uses integer arithmetic only.
+ */
+class ActivationTable
+{
+public:
+
+	/// Largest range tabulated exactly (all inputs of 16 bit format)
+	static constexpr int64_t MAX_EXACT_ENTRIES = 65536;
+
+	/// Largest number of linear segments of wider formats
+	static constexpr int64_t MAX_SEGMENTS = 4096;
+
+	/// Additional precision of entries of interpolated tables
+	static constexpr unsigned INTERPOLATION_BITS = 8;
+
+	/*
+	 * @brief Tabulates function (of double) for raw inputs in [first, last], outputs are rounded and limited to [minimum, maximum]
+	 */
+	template <class _Function>
+	ActivationTable(_Function function, const int32_t factor, const int32_t first, const int32_t last, const int32_t minimum, const int32_t maximum)
+		: first(first), last(last), shift(0), precision(0)
+	{
+		const auto span = static_cast<int64_t>(last) - first;
+		if (span >= MAX_EXACT_ENTRIES)
+		{
+			while ((span >> shift) >= MAX_SEGMENTS)
+			{
+				shift++;
+			}
+			precision = INTERPOLATION_BITS;
+		}
+
+		// One more entry closes the last (partial) segment
+		values.resize(static_cast<size_t>(span >> shift) + 2);
+		for (auto i = 0u; i < values.size(); i++)
+		{
+			const auto input = static_cast<double>(first + (static_cast<int64_t>(i) << shift)) / factor;
+			const auto output = static_cast<int64_t>(std::llround(std::ldexp(function(input) * factor, static_cast<int>(precision))));
+			values[i] = std::min(std::max(output, static_cast<int64_t>(minimum) * (1 << precision)), static_cast<int64_t>(maximum) * (1 << precision));
+		}
+	}
+
+	/*
+	 * @brief Returns raw output for raw input
+	 */
+	int32_t lookup(const int32_t raw) const
+	{
+		const auto offset = static_cast<uint32_t>(std::min(std::max(raw, first), last) - first);
+		const auto index = offset >> shift;
+		if (shift == 0)
+		{
+			return static_cast<int32_t>(values[index]);
+		}
+
+		// Interpolated value is rounded to nearest
+		const auto fraction = static_cast<int64_t>(offset & ((1u << shift) - 1));
+		const auto bits = shift + precision;
+		const auto interpolated = values[index] * (static_cast<int64_t>(1) << shift) + (values[index + 1] - values[index]) * fraction;
+		return static_cast<int32_t>((interpolated + (static_cast<int64_t>(1) << (bits - 1))) >> bits);
+	}
+
+	/*
+	 * @brief Returns true if table interpolates between entries
+	 */
+	bool isInterpolated() const
+	{
+		return shift != 0;
+	}
+
+private:
+
+	/// Lowest tabulated input
+	int32_t first;
+
+	/// Highest tabulated input
+	int32_t last;
+
+	/// Binary logarithm of number of inputs per entry
+	unsigned shift;
+
+	/// Additional bits of entries
+	unsigned precision;
+
+	/// Outputs for inputs first + (i << shift) (multiplied by 2^precision)
+	std::vector<int64_t> values;
+
+};
+
+/*
+ * @brief Sigmoid, tanh and exponential of fixed point numbers computed from lookup tables
+ *
+ * Tables of each format are built on first use. They cover inputs up to (E + 2) * ln(2) in magnitude,
+ * functions are saturated beyond that in precision of the format.
+ */
+namespace ActivationTables
+{
+
+	/*
+	 * @brief Tells whether activation functions of given type are tabulated
+	 */
+	template <class _Type>
+	struct IsTabulated : std::false_type
+	{
+	};
+
+	template <int F, int E>
+	struct IsTabulated<FixedPoint<F, E>> : std::true_type
+	{
+	};
+
+
+	/*
+	 * @brief Creates table of function for given format (over negative inputs only if requested)
+	 */
+	template <int F, int E, class _Function>
+	ActivationTable createTable(_Function function, const bool negativeOnly)
+	{
+		const auto minimum = FixedPoint<F, E>::getMinimumValue().getRaw();
+		const auto maximum = FixedPoint<F, E>::getMaximumValue().getRaw();
+		const auto factor = static_cast<int32_t>(1) << E;
+		const auto limit = static_cast<int32_t>(std::ceil((E + 2) * std::log(2.0) * factor));
+
+		return ActivationTable(function, factor, std::max(-limit, minimum), negativeOnly ? 0 : std::min(limit, maximum), minimum, maximum);
+	}
+
+
+	/*
+	 * @brief Returns sigmoid of value
+	 */
+	template <int F, int E>
+	FixedPoint<F, E> sigmoid(const FixedPoint<F, E> value)
+	{
+		static const auto table = createTable<F, E>([](const double x) { return 1.0 / (1.0 + std::exp(-x)); }, false);
+		return FixedPoint<F, E>::fromRaw(table.lookup(value.getRaw()));
+	}
+
+
+	/*
+	 * @brief Returns hyperbolic tangent of value
+	 */
+	template <int F, int E>
+	FixedPoint<F, E> tanh(const FixedPoint<F, E> value)
+	{
+		static const auto table = createTable<F, E>([](const double x) { return std::tanh(x); }, false);
+		return FixedPoint<F, E>::fromRaw(table.lookup(value.getRaw()));
+	}
+
+
+	/*
+	 * @brief Returns exponential of non-positive value (as used by softmax, positive values return one)
+	 */
+	template <int F, int E>
+	FixedPoint<F, E> exp(const FixedPoint<F, E> value)
+	{
+		static const auto table = createTable<F, E>([](const double x) { return std::exp(x); }, true);
+		return FixedPoint<F, E>::fromRaw(table.lookup(value.getRaw()));
+	}
+
+
+	/*
+	 * @brief Divides value by positive raw sum of values (in integers, sum may exceed range of format)
+	 */
+	template <int F, int E>
+	FixedPoint<F, E> divide(const FixedPoint<F, E> value, const int64_t rawSum)
+	{
+		return FixedPoint<F, E>::fromRaw(static_cast<int32_t>((static_cast<int64_t>(value.getRaw()) << E) / rawSum));
+	}
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Compact mask storing one bit per element
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef BIT_MASK_H
+#define BIT_MASK_H
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * @brief Mask of boolean flags packed into 64 bit words (used to remember state for backward propagation)
+ */
+class BitMask
+{
+
+public:
+
+	/*
+	 * @brief Creates empty mask
+	 */
+	BitMask()
+		: size(0)
+	{
+	}
+
+
+	/*
+	 * @brief Creates mask for given number of elements, all flags cleared
+	 */
+	explicit BitMask(const unsigned size)
+		: size(size)
+		, words((size + BITS_PER_WORD - 1) / BITS_PER_WORD, 0)
+	{
+	}
+
+
+	/*
+	 * @brief Sets flag of given element
+	 */
+	inline void set(const unsigned index, const bool value)
+	{
+		auto & word = words[index / BITS_PER_WORD];
+		auto bit = static_cast<uint64_t>(1) << (index % BITS_PER_WORD);
+		word = value ? (word | bit) : (word & ~bit);
+	}
+
+
+	/*
+	 * @brief Returns flag of given element
+	 */
+	inline bool get(const unsigned index) const
+	{
+		return (words[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+	}
+
+
+	/*
+	 * @brief Returns word containing flags of elements [index * 64, index * 64 + 63]
+	 */
+	inline uint64_t getWord(const unsigned index) const
+	{
+		return words[index];
+	}
+
+
+	/*
+	 * @brief Sets word containing flags of elements [index * 64, index * 64 + 63]
+	 */
+	inline void setWord(const unsigned index, const uint64_t word)
+	{
+		words[index] = word;
+	}
+
+
+	/*
+	 * @brief Returns number of elements
+	 */
+	unsigned getSize() const
+	{
+		return size;
+	}
+
+
+	/*
+	 * @brief Returns number of bytes used by flags
+	 */
+	size_t getByteSize() const
+	{
+		return words.size() * sizeof(uint64_t);
+	}
+
+
+	/*
+	 * @brief Frees memory of mask
+	 */
+	void release()
+	{
+		size = 0;
+		std::vector<uint64_t>().swap(words);
+	}
+
+public:
+
+	/// Number of flags in one word
+	static constexpr unsigned BITS_PER_WORD = 64;
+
+private:
+
+	/// Number of elements
+	unsigned size;
+
+	/// Packed flags
+	std::vector<uint64_t> words;
+
+};
+
+#endif
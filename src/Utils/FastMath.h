@@ -0,0 +1,204 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Approximations of exponential used by activation functions
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * @brief Accuracy of exponential (and sigmoid, tanh and softmax using it)
+ *
+ * Maximum errors against double precision over [-20, 20] (relative for exp, absolute for sigmoid and tanh):
+ *     Exact     libm                   exp 6.0e-8    sigmoid 8.9e-8    tanh 1.8e-7
+ *     Fast      degree 5 polynomial    exp 7.8e-8    sigmoid 8.9e-8    tanh 1.8e-7
+ *     Fastest   degree 3 polynomial    exp 1.5e-4    sigmoid 3.8e-5    tanh 7.5e-5
+ */
+enum class MathAccuracy
+{
+	Exact,
+	Fast,
+	Fastest
+};
+
+/*
+ * @brief Exponential, sigmoid and tanh in selected accuracy
+ *
+ * Approximations split x * log2(e) into integer n and remainder, 2^n is composed directly in bits of float
+ * and e^remainder is evaluated by polynomial. They do not branch, so loops calling them are vectorized by compiler.
+ * Accuracy used by activation layers is shared by whole process.
+ */
+namespace FastMath
+{
+
+	/*
+	 * @brief Shared state
+	 */
+	struct State
+	{
+		/// Accuracy used by activation layers
+		std::atomic<MathAccuracy> accuracy{ MathAccuracy::Exact };
+	};
+
+	inline State & getState()
+	{
+		static State state;
+		return state;
+	}
+
+
+	/*
+	 * @brief Sets accuracy used by activation layers
+	 */
+	inline void setAccuracy(const MathAccuracy accuracy)
+	{
+		getState().accuracy = accuracy;
+	}
+
+
+	/*
+	 * @brief Returns accuracy used by activation layers
+	 */
+	inline MathAccuracy getAccuracy()
+	{
+		return getState().accuracy.load(std::memory_order_relaxed);
+	}
+
+
+	/*
+	 * @brief Returns 2^n for integer n in [-126, 127]
+	 */
+	inline float powerOfTwo(const int32_t n)
+	{
+		const auto bits = static_cast<uint32_t>(n + 127) << 23;
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+
+	/*
+	 * @brief Returns floor of x (for x that fits into int, without call of library)
+	 */
+	inline int32_t floorToInt(const float x)
+	{
+		const auto truncated = static_cast<int32_t>(x);
+		return truncated - static_cast<int32_t>(x < static_cast<float>(truncated));
+	}
+
+
+	/*
+	 * @brief Limits magnitude of x to 100 (exp under- or overflows far before)
+	 *
+	 * Clamping is done on bits of x, comparison of x with float constants would let compiler split loops by it
+	 * (values computed from clamped constant are folded) and such loops are not vectorized.
+	 */
+	inline float clampMagnitude(const float x)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		bits = (bits & 0x80000000u) | std::min(bits & 0x7fffffffu, 0x42c80000u);
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+
+	/*
+	 * @brief Returns value if keep is true, zero otherwise (on bits, for the same reason as clamping)
+	 */
+	inline float keepIf(const float value, const bool keep)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		bits &= 0u - static_cast<uint32_t>(keep);
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+
+	/*
+	 * @brief Exponential in given accuracy
+	 *
+	 * Exponent n of approximations is limited to range of normal floats, remainder is dropped then,
+	 * so that exp returns 2^-126 instead of underflow and 2^127 instead of overflow.
+	 */
+	template <MathAccuracy _Accuracy>
+	inline float exp(const float x);
+
+	template <>
+	inline float exp<MathAccuracy::Exact>(const float x)
+	{
+		return std::exp(x);
+	}
+
+	template <>
+	inline float exp<MathAccuracy::Fast>(const float x)
+	{
+		const auto clamped = clampMagnitude(x);
+
+		// Remainder lies in [-ln(2)/2, ln(2)/2], ln(2) is split into two parts so that it is subtracted exactly
+		const auto n = floorToInt(clamped * 1.44269504088896341f + 0.5f);
+		const auto exponent = std::min(std::max(n, -126), 127);
+		const auto r = keepIf(clamped - static_cast<float>(exponent) * 0.693359375f + static_cast<float>(exponent) * 2.12194440e-4f, n == exponent);
+
+		auto p = 1.9875691500e-4f;
+		p = p * r + 1.3981999507e-3f;
+		p = p * r + 8.3334519073e-3f;
+		p = p * r + 4.1665795894e-2f;
+		p = p * r + 1.6666665459e-1f;
+		p = p * r + 5.0000001201e-1f;
+
+		return (p * r * r + r + 1.0f) * powerOfTwo(exponent);
+	}
+
+	template <>
+	inline float exp<MathAccuracy::Fastest>(const float x)
+	{
+		// 2^f for f in [0, 1)
+		const auto t = clampMagnitude(x) * 1.44269504088896341f;
+		const auto n = floorToInt(t);
+		const auto exponent = std::min(std::max(n, -126), 127);
+		const auto f = keepIf(t - static_cast<float>(exponent), n == exponent);
+		const auto p = 1.0f + f * (0.6960656421638072f + f * (0.224494337302845f + f * 0.07944023841053369f));
+
+		return p * powerOfTwo(exponent);
+	}
+
+
+	/*
+	 * @brief Sigmoid in given accuracy
+	 */
+	template <MathAccuracy _Accuracy>
+	inline float sigmoid(const float x)
+	{
+		return 1.0f / (1.0f + exp<_Accuracy>(-x));
+	}
+
+
+	/*
+	 * @brief Hyperbolic tangent in given accuracy (computed as 2 * sigmoid(2x) - 1)
+	 */
+	template <MathAccuracy _Accuracy>
+	inline float tanh(const float x)
+	{
+		return 2.0f / (1.0f + exp<_Accuracy>(-2.0f * x)) - 1.0f;
+	}
+
+}
+
+#endif
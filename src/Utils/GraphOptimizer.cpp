@@ -0,0 +1,221 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Rewrites sequence of layers into cheaper equivalent one
+ */
+
+#include "src/Utils/GraphOptimizer.h"
+
+#include "src/LayerAliases.h"
+#include "src/Utils/PersistenceMapper.h"
+
+/*
+ * @brief Applies rewrites until no further rewrite is possible (moved activation may enable merge of poolings etc.)
+ *
+ * @param layers   Sequence of layers, input of each layer corresponds to output of previous one
+ *
+ * @return Equivalent sequence of layers (unchanged layers are shared with input sequence)
+ */
+std::vector<GraphOptimizer::LayerPointer> GraphOptimizer::optimize(const std::vector<LayerPointer> & layers)
+{
+	appliedRewrites.clear();
+
+	auto optimized = layers;
+	bool rewritten = true;
+	while (rewritten)
+	{
+		rewritten = foldBatchNormalization(optimized);
+		rewritten = removeIdentityPooling(optimized) || rewritten;
+		rewritten = moveActivationAfterMaxPooling(optimized) || rewritten;
+		rewritten = mergeMaxPooling(optimized) || rewritten;
+	}
+
+	return optimized;
+}
+
+
+/*
+ * @brief Descriptions of rewrites applied by last optimization (layers are numbered from 1 in sequence being rewritten)
+ */
+const std::vector<std::string> & GraphOptimizer::getAppliedRewrites() const
+{
+	return appliedRewrites;
+}
+
+
+/*
+ * @brief Folds batch normalization into previous convolutional or fully connected layer, which is created again with scaled
+ *            filters/weights and shifted biases (bias is added if previous layer did not use it), so no normalization is left
+ *
+ * Convolution is folded only if each filter is one feature of normalization. Output of single filter has one feature per cell,
+ * such normalization cannot be expressed by filter and is kept.
+ */
+bool GraphOptimizer::foldBatchNormalization(std::vector<LayerPointer> & layers)
+{
+	bool rewritten = false;
+	for (auto i = 0u; i + 1 < layers.size(); i++)
+	{
+		auto normalization = dynamic_cast<BatchNormalization *>(layers[i + 1].get());
+		if (!normalization)
+		{
+			continue;
+		}
+
+		auto convolution = dynamic_cast<Convolution *>(layers[i].get());
+		if (convolution && normalization->getFeatureNum() == convolution->getFilterNum())
+		{
+			// Each filter produces one channel, that is one feature of normalization
+			// Images share buffers when copied, filters of original layer must stay untouched
+			std::vector<Image<BackwardType>> filters;
+			for (const auto & filter : convolution->getFilters())
+			{
+				filters.emplace_back();
+				filters.back() = filter;
+			}
+			auto biases = convolution->usesBias() ? convolution->getBiases() : std::vector<BackwardType>(filters.size(), static_cast<BackwardType>(0.0f));
+			for (auto f = 0u; f < filters.size(); f++)
+			{
+				const auto multiplier = normalization->getNormalizationMultiplier(f);
+				for (auto k = 0u; k < filters[f].getFlattenedSize(); k++)
+				{
+					filters[f](k) = static_cast<BackwardType>(static_cast<float>(filters[f](k)) * multiplier);
+				}
+				biases[f] = static_cast<BackwardType>(static_cast<float>(biases[f]) * multiplier + normalization->getNormalizationOffset(f));
+			}
+
+			auto folded = std::make_shared<Convolution>(convolution->getInputSize(), convolution->getStride(), convolution->getFilterNum(),
+				convolution->getExtent(), convolution->getZeroPadding(), true, true);
+			folded->loadFilters(filters, biases);
+			layers[i] = folded;
+		}
+		else if (auto fullyConnected = dynamic_cast<FullyConnected *>(layers[i].get()))
+		{
+			// Each row holds weights of one output neuron followed by weight of its bias
+			Image<BackwardType> weights;
+			weights = fullyConnected->getNeuronWeights();
+			const auto inputNum = weights.getWidth() - 1;
+			for (auto neuron = 0u; neuron < weights.getHeight(); neuron++)
+			{
+				const auto feature = normalization->getFeature(neuron);
+				const auto multiplier = normalization->getNormalizationMultiplier(feature);
+				for (auto k = 0u; k < inputNum; k++)
+				{
+					weights(k, neuron) = static_cast<BackwardType>(static_cast<float>(weights(k, neuron)) * multiplier);
+				}
+
+				const auto bias = fullyConnected->usesBias() ? static_cast<float>(weights(inputNum, neuron)) : 0.0f;
+				weights(inputNum, neuron) = static_cast<BackwardType>(bias * multiplier + normalization->getNormalizationOffset(feature));
+			}
+
+			auto folded = std::make_shared<FullyConnected>(fullyConnected->getInputSize(), fullyConnected->getOutputSize(), true, true);
+			folded->setNeuronWeights(weights);
+			layers[i] = folded;
+		}
+		else
+		{
+			continue;
+		}
+
+		appliedRewrites.push_back("Folded batch normalization (layer " + std::to_string(i + 2) + ") into previous layer.");
+		layers.erase(layers.begin() + i + 1);
+		rewritten = true;
+	}
+
+	return rewritten;
+}
+
+
+/*
+ * @brief Removes poolings with 1x1 window and stride 1, they only copy their input (last layer is kept to preserve output)
+ */
+bool GraphOptimizer::removeIdentityPooling(std::vector<LayerPointer> & layers)
+{
+	bool rewritten = false;
+	for (auto i = 0u; i < layers.size() && layers.size() > 1; i++)
+	{
+		auto pooling = dynamic_cast<PoolingLayer<ForwardType, WeightType> *>(layers[i].get());
+		if (pooling && pooling->getExtentSize() == 1 && pooling->getStride() == 1)
+		{
+			appliedRewrites.push_back("Removed identity " + PersistenceMapper::getPoolingOperationString(pooling->getPoolingOperationType()) +
+				" pooling (layer " + std::to_string(i + 1) + ").");
+			layers.erase(layers.begin() + i);
+			rewritten = true;
+			i--;
+		}
+	}
+
+	return rewritten;
+}
+
+
+/*
+ * @brief Swaps monotonic activation followed by max pooling, activation is created again for pooled dimensions
+ */
+bool GraphOptimizer::moveActivationAfterMaxPooling(std::vector<LayerPointer> & layers)
+{
+	bool rewritten = false;
+	for (auto i = 0u; i + 1 < layers.size(); i++)
+	{
+		auto activation = dynamic_cast<ActivationLayer<ForwardType, WeightType> *>(layers[i].get());
+		auto pooling = dynamic_cast<PoolingLayer<ForwardType, WeightType> *>(layers[i + 1].get());
+		if (!activation || !pooling || pooling->getPoolingOperationType() != PoolingOperation::Max)
+		{
+			continue;
+		}
+
+		// Softmax depends on all cells, it does not commute with pooling
+		auto type = activation->getActivationFunctionType();
+		if (type != ActivationFunction::Sigmoid && type != ActivationFunction::Tanh &&
+			type != ActivationFunction::ReLU && type != ActivationFunction::LeakyReLU)
+		{
+			continue;
+		}
+
+		appliedRewrites.push_back("Moved " + PersistenceMapper::getActivationFunctionString(type) +
+			" activation (layer " + std::to_string(i + 1) + ") after max pooling (layer " + std::to_string(i + 2) + ").");
+
+		// Activation does not change dimensions, so pooling keeps its input size
+		layers[i] = layers[i + 1];
+		layers[i + 1] = PersistenceMapper::getActivationLayer(type, pooling->getOutputSize());
+		rewritten = true;
+	}
+
+	return rewritten;
+}
+
+
+/*
+ * @brief Merges two consecutive max poolings whose windows do not overlap (stride == extent),
+ *            each window of second pooling covers extent x extent windows of first one
+ */
+bool GraphOptimizer::mergeMaxPooling(std::vector<LayerPointer> & layers)
+{
+	bool rewritten = false;
+	for (auto i = 0u; i + 1 < layers.size(); i++)
+	{
+		auto first = dynamic_cast<PoolingLayer<ForwardType, WeightType> *>(layers[i].get());
+		auto second = dynamic_cast<PoolingLayer<ForwardType, WeightType> *>(layers[i + 1].get());
+		if (!first || !second || first->getPoolingOperationType() != PoolingOperation::Max ||
+			second->getPoolingOperationType() != PoolingOperation::Max)
+		{
+			continue;
+		}
+
+		// Overlapping windows would cover cells that neither pooling covers
+		if (first->getExtentSize() != first->getStride() || second->getExtentSize() != second->getStride())
+		{
+			continue;
+		}
+
+		auto extent = first->getExtentSize() * second->getExtentSize();
+		appliedRewrites.push_back("Merged max poolings (layers " + std::to_string(i + 1) + " and " + std::to_string(i + 2) +
+			") into single " + std::to_string(extent) + "x" + std::to_string(extent) + " max pooling.");
+
+		layers[i] = std::make_shared<MaxPooling>(first->getInputSize(), extent, extent);
+		layers[i]->releaseTrainingState();
+		layers.erase(layers.begin() + i + 1);
+		rewritten = true;
+	}
+
+	return rewritten;
+}
@@ -0,0 +1,61 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Rewrites sequence of layers into cheaper equivalent one
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef GRAPH_OPTIMIZER_H
+#define GRAPH_OPTIMIZER_H
+
+#include "src/CompileSettings.h"
+#include "src/Layers/ILayer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * @brief Applies rewrites that do not change results of inference on sequence of layers
+ *
+ * - batch normalization following convolutional or fully connected layer is folded into its filters/weights and biases
+ * - monotonic activations (sigmoid, tanh, ReLU, leaky ReLU) in front of max pooling are moved after it,
+ *   max of activated values is activation of max, activation then runs on pooled (smaller) image
+ * - pooling with 1x1 window and stride 1 is removed (copies its input)
+ * - consecutive non-overlapping max poolings are merged into one with larger window
+ *
+ * Rewrites are meant for inference only, gradients of rewritten layers would differ in case of ties and folded
+ * layers would not be trained as batch normalization. Layers created by rewrites therefore have no training state.
+ */
+class GraphOptimizer
+{
+
+public:
+
+	using LayerPointer = std::shared_ptr<ILayer<ForwardType, WeightType>>;
+
+	std::vector<LayerPointer> optimize(const std::vector<LayerPointer> & layers);
+
+	const std::vector<std::string> & getAppliedRewrites() const;
+
+private:
+
+	bool foldBatchNormalization(std::vector<LayerPointer> & layers);
+
+	bool removeIdentityPooling(std::vector<LayerPointer> & layers);
+
+	bool moveActivationAfterMaxPooling(std::vector<LayerPointer> & layers);
+
+	bool mergeMaxPooling(std::vector<LayerPointer> & layers);
+
+private:
+
+	/// Descriptions of rewrites applied by last optimization
+	std::vector<std::string> appliedRewrites;
+
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Allocator of buffers used by Image class (optionally backed by huge pages)
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef MEMORY_ALLOCATOR_H
+#define MEMORY_ALLOCATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/*
+ * @brief Statistics of allocations made through allocator
+ */
+struct AllocationStatistics
+{
+
+	/// Number of buffers allocated with huge page advice
+	uint64_t hugePageAllocations;
+
+	/// Bytes allocated with huge page advice
+	uint64_t hugePageBytes;
+
+	/// Anonymous memory of this process currently backed by huge pages (kB, 0 if unknown)
+	uint64_t anonHugePagesKb;
+
+};
+
+/*
+ * @brief Allocator used for all Image buffers
+ *
+ * Buffers larger than threshold are aligned to huge page boundary and advised to be backed by transparent
+ * huge pages (Linux only). Such buffers are not touched during allocation (for types without initialization),
+ * so their pages are placed on NUMA node of the thread that writes them first. Weights are shared by all
+ * workers and are written first by thread constructing the layer, so they stay on its node.
+ */
+namespace MemoryAllocator
+{
+
+	/// Size of huge page (2 MB on x86-64), huge page backed buffers are aligned to it
+	constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	/*
+	 * @brief Shared allocator state
+	 */
+	struct State
+	{
+		/// Buffers of at least this size are backed by huge pages (0 == disabled)
+		std::atomic<size_t> hugePageThreshold{ 0 };
+
+		/// Number of huge page backed allocations
+		std::atomic<uint64_t> hugePageAllocations{ 0 };
+
+		/// Bytes allocated with huge page advice
+		std::atomic<uint64_t> hugePageBytes{ 0 };
+	};
+
+	inline State & getState()
+	{
+		static State state;
+		return state;
+	}
+
+
+	/*
+	 * @brief Enables huge page backed allocations for buffers of at least given size (at least one huge page,
+	 *        smaller buffers would waste most of their huge page)
+	 */
+	inline void enableHugePages(const size_t thresholdBytes)
+	{
+		getState().hugePageThreshold = std::max(thresholdBytes, HUGE_PAGE_SIZE);
+	}
+
+
+	/*
+	 * @brief Disables huge page backed allocations
+	 */
+	inline void disableHugePages()
+	{
+		getState().hugePageThreshold = 0;
+	}
+
+
+	/*
+	 * @brief Returns true if buffer of given size should be backed by huge pages
+	 */
+	inline bool useHugePages(const size_t bytes)
+	{
+		auto threshold = getState().hugePageThreshold.load(std::memory_order_relaxed);
+		return threshold != 0 && bytes >= threshold;
+	}
+
+
+	/*
+	 * @brief Allocates memory aligned to huge page and advises kernel to back it with huge pages
+	 *
+	 * @throws std::bad_alloc if memory could not be allocated
+	 */
+	inline void * allocateHugePageBacked(const size_t bytes)
+	{
+		// Round up so that the whole buffer may be covered by huge pages
+		auto alignedBytes = ((bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+		void * memory = nullptr;
+
+#ifdef __linux__
+		if (posix_memalign(&memory, HUGE_PAGE_SIZE, alignedBytes) != 0)
+		{
+			throw std::bad_alloc();
+		}
+		madvise(memory, alignedBytes, MADV_HUGEPAGE);
+#else
+		memory = malloc(bytes);
+		if (!memory)
+		{
+			throw std::bad_alloc();
+		}
+#endif
+
+		getState().hugePageAllocations++;
+		getState().hugePageBytes += alignedBytes;
+
+		return memory;
+	}
+
+
+	/*
+	 * @brief Returns statistics of huge page backed allocations
+	 */
+	inline AllocationStatistics getStatistics()
+	{
+		AllocationStatistics statistics{ getState().hugePageAllocations.load(), getState().hugePageBytes.load(), 0 };
+
+		// Kernel reports how much anonymous memory is really backed by huge pages
+		std::ifstream smaps("/proc/self/smaps_rollup");
+		std::string line;
+		while (smaps.is_open() && std::getline(smaps, line))
+		{
+			if (line.compare(0, 14, "AnonHugePages:") == 0)
+			{
+				std::istringstream(line.substr(14)) >> statistics.anonHugePagesKb;
+				break;
+			}
+		}
+
+		return statistics;
+	}
+
+
+	/*
+	 * @brief Allocates array of given type (shared between images)
+	 */
+	template <class Type>
+	std::shared_ptr<Type> allocate(const unsigned count)
+	{
+		const auto bytes = static_cast<size_t>(count) * sizeof(Type);
+
+		if (!useHugePages(bytes))
+		{
+			return std::shared_ptr<Type>(new Type[count], std::default_delete<Type[]>());
+		}
+
+		auto memory = static_cast<Type *>(allocateHugePageBacked(bytes));
+		for (auto i = 0u; i < count; i++)
+		{
+			new (memory + i) Type; // default initialization, does not touch memory of fundamental types
+		}
+
+		return std::shared_ptr<Type>(memory, [count](Type * ptr)
+		{
+			for (auto i = 0u; i < count; i++)
+			{
+				ptr[i].~Type();
+			}
+			free(ptr);
+		});
+	}
+
+} // namespace MemoryAllocator
+
+#endif
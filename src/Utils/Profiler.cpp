@@ -0,0 +1,138 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Simple profiler based on hardware performance counters
+ */
+
+#include "src/Utils/Profiler.h"
+
+#include "src/Utils/MemoryAllocator.h"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * @brief Opens data TLB miss counter if system allows it
+ */
+Profiler::Profiler()
+{
+#ifdef __linux__
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled = 1;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	tlbMissCounter = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+
+/*
+ * @brief Closes counters
+ */
+Profiler::~Profiler()
+{
+#ifdef __linux__
+	if (tlbMissCounter >= 0)
+	{
+		close(tlbMissCounter);
+	}
+#endif
+}
+
+
+/*
+ * @brief Starts measurement
+ */
+void Profiler::start()
+{
+#ifdef __linux__
+	if (tlbMissCounter >= 0)
+	{
+		ioctl(tlbMissCounter, PERF_EVENT_IOC_RESET, 0);
+		ioctl(tlbMissCounter, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+	startTime = std::chrono::steady_clock::now();
+}
+
+
+/*
+ * @brief Stops measurement
+ */
+void Profiler::stop()
+{
+	std::chrono::duration<float> diff = std::chrono::steady_clock::now() - startTime;
+	elapsedSeconds = diff.count();
+
+#ifdef __linux__
+	if (tlbMissCounter >= 0)
+	{
+		ioctl(tlbMissCounter, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(tlbMissCounter, &tlbMisses, sizeof(tlbMisses)) != sizeof(tlbMisses))
+		{
+			tlbMisses = 0;
+		}
+	}
+#endif
+}
+
+
+/*
+ * @brief Returns true if hardware counters could be opened
+ */
+bool Profiler::countersAvailable() const
+{
+	return tlbMissCounter >= 0;
+}
+
+
+/*
+ * @brief Returns number of data TLB misses in last measurement
+ */
+uint64_t Profiler::getTlbMisses() const
+{
+	return tlbMisses;
+}
+
+
+/*
+ * @brief Returns length of last measurement in seconds
+ */
+float Profiler::getElapsedSeconds() const
+{
+	return elapsedSeconds;
+}
+
+
+/*
+ * @brief Prints measured values along with huge page usage
+ */
+void Profiler::printReport(std::ostream & os) const
+{
+	auto statistics = MemoryAllocator::getStatistics();
+
+	os << "=== Profile ===" << std::endl;
+	os << "Elapsed time: " << elapsedSeconds << " s" << std::endl;
+	if (countersAvailable())
+	{
+		os << "dTLB load misses: " << tlbMisses << std::endl;
+	}
+	else
+	{
+		os << "dTLB load misses: not available (hardware counters cannot be opened)" << std::endl;
+	}
+	os << "Huge page backed buffers: " << statistics.hugePageAllocations << " (" << statistics.hugePageBytes / 1024 << " kB)" << std::endl;
+	os << "Anonymous memory in huge pages: " << statistics.anonHugePagesKb << " kB" << std::endl;
+}
@@ -0,0 +1,65 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Simple profiler based on hardware performance counters
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/*
+ * @brief Measures wall time and data TLB misses of the whole process (including threads created later)
+ *
+ * Hardware counters are available on Linux only (and may be forbidden by perf_event_paranoid),
+ * profiler then reports wall time and huge page usage only.
+ */
+class Profiler
+{
+
+public:
+
+	Profiler();
+
+	~Profiler();
+
+	Profiler(const Profiler &) = delete;
+
+	Profiler & operator=(const Profiler &) = delete;
+
+	void start();
+
+	void stop();
+
+	bool countersAvailable() const;
+
+	uint64_t getTlbMisses() const;
+
+	float getElapsedSeconds() const;
+
+	void printReport(std::ostream & os) const;
+
+private:
+
+	/// File descriptor of data TLB miss counter (-1 if not available)
+	int tlbMissCounter = -1;
+
+	/// Number of data TLB misses in last measurement
+	uint64_t tlbMisses = 0;
+
+	/// Start of last measurement
+	std::chrono::steady_clock::time_point startTime;
+
+	/// Length of last measurement
+	float elapsedSeconds = 0.0f;
+
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Pinning of threads to cores
+ */
+
+#include "src/Utils/ThreadAffinity.h"
+
+#include <mutex>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ThreadAffinity
+{
+
+	/// Cores assigned to workers (empty == threads are not pinned)
+	std::vector<unsigned> affinityMap;
+
+	/// Guards affinity map
+	std::mutex affinityMutex;
+
+#ifdef __linux__
+	/// Cores that can be stored in cpu_set_t
+	const unsigned maxCoreNum = CPU_SETSIZE;
+#else
+	const unsigned maxCoreNum = 1024;
+#endif
+
+
+	/*
+	 * @brief Parses single core of affinity map
+	 *
+	 * @throws InvalidAffinityMap if core is not a number or it is too large
+	 */
+	unsigned parseCore(const std::string & description)
+	{
+		size_t length = 0;
+		auto core = std::stoul(description, &length);
+		if (length != description.size() || description.find('-') != std::string::npos)
+		{
+			throw InvalidAffinityMap("Affinity map must be comma separated list of cores or core ranges.");
+		}
+
+		if (core >= maxCoreNum)
+		{
+			throw InvalidAffinityMap("Core " + description + " in affinity map exceeds maximal core " + std::to_string(maxCoreNum - 1) + ".");
+		}
+
+		return static_cast<unsigned>(core);
+	}
+
+
+	/*
+	 * @brief Parses affinity map in format "0,2,4-7"
+	 *
+	 * @throws InvalidAffinityMap if description is not valid
+	 */
+	std::vector<unsigned> parseAffinityMap(const std::string & description)
+	{
+		std::vector<unsigned> cores;
+		std::istringstream ss(description);
+		std::string item;
+
+		try
+		{
+			while (std::getline(ss, item, ','))
+			{
+				auto dash = item.find('-');
+				if (dash == std::string::npos)
+				{
+					cores.push_back(parseCore(item));
+				}
+				else
+				{
+					auto first = parseCore(item.substr(0, dash));
+					auto last = parseCore(item.substr(dash + 1));
+					if (last < first)
+					{
+						throw InvalidAffinityMap("Core range in affinity map is reversed.");
+					}
+
+					for (auto core = first; core <= last; core++)
+					{
+						cores.push_back(core);
+					}
+				}
+			}
+		}
+		catch (const std::logic_error &)
+		{
+			throw InvalidAffinityMap("Affinity map must be comma separated list of cores or core ranges.");
+		}
+
+		if (cores.empty())
+		{
+			throw InvalidAffinityMap("Affinity map is empty.");
+		}
+
+		return cores;
+	}
+
+
+	/*
+	 * @brief Sets cores worker threads are pinned to
+	 */
+	void setAffinityMap(const std::vector<unsigned> & cores)
+	{
+		std::lock_guard<std::mutex> lock(affinityMutex);
+		affinityMap = cores;
+	}
+
+
+	/*
+	 * @brief Returns cores worker threads are pinned to
+	 */
+	std::vector<unsigned> getAffinityMap()
+	{
+		std::lock_guard<std::mutex> lock(affinityMutex);
+		return affinityMap;
+	}
+
+
+	/*
+	 * @brief Pins calling thread to core assigned to given worker, returns false if not pinned
+	 */
+	bool pinCurrentThread(const unsigned workerIndex)
+	{
+		auto cores = getAffinityMap();
+		if (cores.empty())
+		{
+			return false;
+		}
+
+		auto core = cores[workerIndex % cores.size()];
+		if (core >= maxCoreNum)
+		{
+			return false;
+		}
+
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+		return false;
+#endif
+	}
+
+} // namespace ThreadAffinity
@@ -0,0 +1,47 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Pinning of threads to cores
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * @brief Thrown if affinity map could not be parsed
+ */
+class InvalidAffinityMap : public std::runtime_error
+{
+public:
+
+	explicit InvalidAffinityMap(const std::string & msg)
+		: std::runtime_error(msg.c_str())
+	{
+	}
+};
+
+/*
+ * @brief Affinity map assigns cores to worker threads (worker i runs on map[i % map.size()])
+ */
+namespace ThreadAffinity
+{
+
+	std::vector<unsigned> parseAffinityMap(const std::string & description);
+
+	void setAffinityMap(const std::vector<unsigned> & cores);
+
+	std::vector<unsigned> getAffinityMap();
+
+	bool pinCurrentThread(const unsigned workerIndex);
+
+} // namespace ThreadAffinity
+
+#endif
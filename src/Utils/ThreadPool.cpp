@@ -0,0 +1,301 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Work-stealing pool of worker threads used by all parallel parts of library
+ */
+
+#include "src/Utils/ThreadPool.h"
+
+#include "src/Utils/ThreadAffinity.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+/// Pool whose worker is running on this thread (null for other threads)
+static thread_local ThreadPool * currentPool = nullptr;
+
+/// Index of worker running on this thread
+static thread_local unsigned currentWorker = 0;
+
+/// Number of workers of shared pool (0 == one per core)
+static unsigned sharedThreadNum = 0;
+
+/// Shared pool was already created
+static std::atomic<bool> sharedCreated(false);
+
+/// Smallest work split among workers by runParallel
+static std::atomic<size_t> parallelThreshold(64 * 1024);
+
+/*
+ * @brief Starts given number of workers (at least one)
+ */
+ThreadPool::ThreadPool(const unsigned threadNum)
+{
+	auto workerNum = std::max(1u, threadNum);
+	for (auto i = 0u; i <= workerNum; i++)
+	{
+		queues.push_back(std::make_unique<TaskQueue>());
+	}
+
+	for (auto i = 0u; i < workerNum; i++)
+	{
+		threads.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+
+/*
+ * @brief Finishes queued tasks and joins workers
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	sleepCondition.notify_all();
+
+	for (auto & thread : threads)
+	{
+		thread.join();
+	}
+}
+
+
+/*
+ * @brief Queues task, workers of this pool push to their own deque, other threads to injection deque
+ */
+void ThreadPool::enqueue(std::function<void()> task)
+{
+	auto & queue = (currentPool == this) ? *queues[currentWorker] : *queues.back();
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		pendingTaskNum++;
+	}
+	sleepCondition.notify_one();
+}
+
+
+/*
+ * @brief Calls body on consecutive chunks of [begin, end) in parallel, returns when all chunks are done
+ *
+ * Calling thread processes chunks as well and runs other pending tasks while waiting for the rest,
+ * so it may be called from tasks of this pool. Ranges with a single chunk run directly on calling thread.
+ *
+ * @param begin      First index
+ * @param end        One past last index
+ * @param grainSize  Smallest number of indices in chunk
+ * @param body       Function called with [chunkBegin, chunkEnd)
+ * @throws first exception thrown by body
+ */
+void ThreadPool::parallelFor(const size_t begin, const size_t end, const size_t grainSize, const std::function<void(size_t, size_t)> & body)
+{
+	if (end <= begin)
+	{
+		return;
+	}
+
+	auto grain = std::max<size_t>(1, grainSize);
+	auto chunkNum = (end - begin + grain - 1) / grain;
+	if (chunkNum == 1 || threads.size() == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	// More chunks than threads lets faster threads take over work of slower ones
+	chunkNum = std::min(chunkNum, 4 * (threads.size() + 1));
+	auto chunkSize = (end - begin + chunkNum - 1) / chunkNum;
+	chunkNum = (end - begin + chunkSize - 1) / chunkSize;
+
+	struct Region
+	{
+		std::atomic<size_t> nextChunk{ 0 };
+
+		std::atomic<size_t> finishedChunkNum{ 0 };
+
+		std::mutex exceptionMutex;
+
+		std::exception_ptr exception;
+	};
+
+	// Helpers may start after region is finished, so region is shared and body is touched only for unclaimed chunks
+	auto region = std::make_shared<Region>();
+	auto bodyPointer = &body;
+	auto processChunks = [region, bodyPointer, begin, end, chunkSize, chunkNum]()
+	{
+		for (auto chunk = region->nextChunk++; chunk < chunkNum; chunk = region->nextChunk++)
+		{
+			try
+			{
+				auto chunkBegin = begin + chunk * chunkSize;
+				(*bodyPointer)(chunkBegin, std::min(end, chunkBegin + chunkSize));
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(region->exceptionMutex);
+				if (!region->exception)
+				{
+					region->exception = std::current_exception();
+				}
+			}
+			region->finishedChunkNum++;
+		}
+	};
+
+	auto helperNum = std::min(chunkNum - 1, threads.size());
+	for (auto i = 0u; i < helperNum; i++)
+	{
+		enqueue(processChunks);
+	}
+
+	processChunks();
+
+	auto workerIndex = (currentPool == this) ? static_cast<int>(currentWorker) : -1;
+	while (region->finishedChunkNum < chunkNum)
+	{
+		if (!runPendingTask(workerIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	if (region->exception)
+	{
+		std::rethrow_exception(region->exception);
+	}
+}
+
+
+/*
+ * @brief Returns number of workers
+ */
+unsigned ThreadPool::getThreadNum() const
+{
+	return static_cast<unsigned>(threads.size());
+}
+
+
+/*
+ * @brief Sets number of workers of shared pool (0 == one per core)
+ *
+ * @throws std::logic_error if shared pool is already running
+ */
+void ThreadPool::setSharedThreadNum(const unsigned threadNum)
+{
+	if (sharedCreated)
+	{
+		throw std::logic_error("Shared thread pool is already running.");
+	}
+
+	sharedThreadNum = threadNum;
+}
+
+
+/*
+ * @brief Returns pool shared by whole library (created on first use)
+ */
+ThreadPool & ThreadPool::getShared()
+{
+	static ThreadPool pool(sharedThreadNum != 0 ? sharedThreadNum : std::thread::hardware_concurrency());
+	sharedCreated = true;
+
+	return pool;
+}
+
+
+/*
+ * @brief Sets smallest work (operations per call) that layers split among workers, 0 == always split
+ */
+void ThreadPool::setParallelThreshold(const size_t threshold)
+{
+	parallelThreshold = threshold;
+}
+
+
+/*
+ * @brief Returns smallest work (operations per call) that layers split among workers
+ */
+size_t ThreadPool::getParallelThreshold()
+{
+	return parallelThreshold;
+}
+
+
+/*
+ * @brief Runs one task (own newest, then injected, then stolen oldest), returns false if no task was found
+ */
+bool ThreadPool::runPendingTask(const int workerIndex)
+{
+	if (pendingTaskNum == 0)
+	{
+		return false;
+	}
+
+	auto queueNum = queues.size();
+	auto start = (workerIndex >= 0) ? static_cast<size_t>(workerIndex) : queueNum - 1;
+	std::function<void()> task;
+
+	for (auto i = 0u; i < queueNum && !task; i++)
+	{
+		auto & queue = *queues[(start + i) % queueNum];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+		{
+			continue;
+		}
+
+		if (i == 0 && workerIndex >= 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+
+	if (!task)
+	{
+		return false;
+	}
+
+	pendingTaskNum--;
+	task();
+
+	return true;
+}
+
+
+/*
+ * @brief Worker loop, runs tasks until pool is destroyed and no task is pending
+ */
+void ThreadPool::work(const unsigned workerIndex)
+{
+	currentPool = this;
+	currentWorker = workerIndex;
+	ThreadAffinity::pinCurrentThread(workerIndex + 1);
+
+	while (true)
+	{
+		if (runPendingTask(static_cast<int>(workerIndex)))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this]() { return !running || pendingTaskNum > 0; });
+		if (!running && pendingTaskNum == 0)
+		{
+			return;
+		}
+	}
+}
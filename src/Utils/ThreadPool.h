@@ -0,0 +1,121 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Work-stealing pool of worker threads used by all parallel parts of library
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * @brief Fixed number of workers, each with its own task deque
+ *
+ * Worker runs its newest task first and steals oldest tasks of other workers when its deque is empty.
+ * Tasks submitted from outside of pool go to shared injection deque. Thread waiting for parallelFor runs
+ * pending tasks meanwhile, so parallel regions may be nested without deadlock or oversubscription.
+ * Workers are pinned according to ThreadAffinity map (worker i uses map entry i + 1, entry 0 belongs to main thread).
+ */
+class ThreadPool
+{
+
+public:
+
+	explicit ThreadPool(const unsigned threadNum);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	void enqueue(std::function<void()> task);
+
+	void parallelFor(const size_t begin, const size_t end, const size_t grainSize, const std::function<void(size_t, size_t)> & body);
+
+	unsigned getThreadNum() const;
+
+	static void setSharedThreadNum(const unsigned threadNum);
+
+	static ThreadPool & getShared();
+
+	static void setParallelThreshold(const size_t threshold);
+
+	static size_t getParallelThreshold();
+
+
+	/*
+	 * @brief Splits [0, num) among workers of shared pool if total work reaches parallel threshold,
+	 *            smaller ranges run directly on calling thread (shared pool is not even created)
+	 *
+	 * @param num    Number of indices (e.g. filters, rows or elements)
+	 * @param cost   Work per index (e.g. multiply-accumulate operations)
+	 * @param body   Function called with [first, last)
+	 */
+	template <typename Body>
+	static void runParallel(const size_t num, const size_t cost, const Body & body)
+	{
+		auto threshold = getParallelThreshold();
+		if (num < 2 || num * std::max<size_t>(1, cost) < threshold)
+		{
+			body(static_cast<size_t>(0), num);
+			return;
+		}
+
+		// Each chunk gets at least quarter of threshold, so that scheduling overhead stays small
+		getShared().parallelFor(0, num, std::max<size_t>(1, threshold / (4 * std::max<size_t>(1, cost))), body);
+	}
+
+private:
+
+	/*
+	 * @brief Deque of tasks guarded by its own lock (owner and thieves contend only when they meet)
+	 */
+	struct TaskQueue
+	{
+		std::mutex mutex;
+
+		std::deque<std::function<void()>> tasks;
+	};
+
+	bool runPendingTask(const int workerIndex);
+
+	void work(const unsigned workerIndex);
+
+private:
+
+	/// Task deques of workers followed by injection deque for tasks from other threads
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+
+	/// Workers
+	std::vector<std::thread> threads;
+
+	/// Number of tasks queued and not yet taken
+	std::atomic<size_t> pendingTaskNum{ 0 };
+
+	/// Pool accepts tasks
+	bool running = true;
+
+	/// Protects sleeping of idle workers
+	std::mutex sleepMutex;
+
+	/// Wakes idle workers
+	std::condition_variable sleepCondition;
+
+};
+
+#endif
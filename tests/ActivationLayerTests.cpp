@@ -8,6 +8,13 @@
 
 #include "src/Image.h"
 #include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/SigmoidActivationLayer.h"
+#include "src/Layers/TanhActivationLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/DropoutLayer.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Optimizers/Sgd.h"
 
 TEST(ActivationLayerTest, ReluWorksCorrectlyOn2DImage)
 {
@@ -58,3 +65,203 @@ TEST(ActivationLayerTest, ReluWorksCorrectlyOn3DImage)
 
 	EXPECT_TRUE(Image<ForwardType>(expectedOutput) == activationLayer.getOutput());
 }
+
+TEST(ActivationLayerTest, ReluWorksCorrectlyInPlace)
+{
+	std::vector<std::vector<std::vector<ForwardType>>> input =
+	{ { { 1, -5 },
+		{ -3, 4 } },
+		{ { 5, -6 },
+		{ 13, -8 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> gradients =
+	{ { { 1, 2 },
+		{ 3, 4 } },
+		{ { 5, 6 },
+		{ 7, 8 }
+	} };
+
+	auto img = Image<ForwardType>(input);
+	auto grad = Image<BackwardType>(gradients);
+
+	ReluActivationLayer<ForwardType, WeightType> activationLayer(img.getDimensions());
+	activationLayer.getOutput().shareWith(img);
+	activationLayer.getGradientOutput().shareWith(grad);
+
+	activationLayer.forwardPropagation(img, activationLayer.getOutput());
+	activationLayer.backwardPropagation(img, activationLayer.getOutput(), grad, activationLayer.getGradientOutput(), TrainingSettings());
+
+	std::vector<std::vector<std::vector<ForwardType>>> expectedOutput =
+	{ { { 1, 0 },
+		{ 0, 4 } },
+		{ { 5, 0 },
+		{ 13, 0 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> expectedGradients =
+	{ { { 1, 0 },
+		{ 0, 4 } },
+		{ { 5, 0 },
+		{ 7, 0 }
+	} };
+
+	EXPECT_TRUE(Image<ForwardType>(expectedOutput) == img);
+	EXPECT_TRUE(Image<BackwardType>(expectedGradients) == grad);
+}
+
+TEST(ActivationLayerTest, ApproximatedExponentialStaysWithinDocumentedError)
+{
+	// Odd size covers remainder of vectorized loops, values reach saturated ends of sigmoid and tanh
+	Image<ForwardType> input(Dimensions{ 67, 1, 1 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>(i) * 0.6f - 20.0f);
+	}
+
+	SigmoidActivationLayer<ForwardType, WeightType> sigmoid(input.getDimensions());
+	TanhActivationLayer<ForwardType, WeightType> tanh(input.getDimensions());
+	SoftmaxActivationLayer<ForwardType, WeightType> softmax(input.getDimensions());
+
+	std::vector<Image<ForwardType>> exact(3);
+	for (auto accuracy : { MathAccuracy::Exact, MathAccuracy::Fast, MathAccuracy::Fastest })
+	{
+		FastMath::setAccuracy(accuracy);
+		sigmoid.forwardPropagation(input, sigmoid.getOutput());
+		tanh.forwardPropagation(input, tanh.getOutput());
+		softmax.forwardPropagation(input, softmax.getOutput());
+
+		auto tolerance = (accuracy == MathAccuracy::Fastest) ? 2e-4f : 1e-6f;
+		auto layer = 0u;
+		for (auto output : { &sigmoid.getOutput(), &tanh.getOutput(), &softmax.getOutput() })
+		{
+			if (accuracy == MathAccuracy::Exact)
+			{
+				exact[layer] = *output;
+			}
+
+			for (auto i = 0u; i < output->getFlattenedSize(); i++)
+			{
+				EXPECT_NEAR(static_cast<float>((*output)(i)), static_cast<float>(exact[layer](i)), tolerance);
+			}
+			layer++;
+		}
+	}
+
+	FastMath::setAccuracy(MathAccuracy::Exact);
+}
+
+TEST(ActivationLayerTest, SoftmaxGradientsMatchJacobian)
+{
+	Image<ForwardType> input(std::vector<ForwardType>{ 0.5f, -1.0f, 2.0f, 0.0f });
+	Image<BackwardType> gradients(std::vector<BackwardType>{ 0.3f, -0.2f, 1.0f, 0.7f });
+
+	SoftmaxActivationLayer<ForwardType, WeightType> softmax(input.getDimensions());
+	softmax.forwardPropagation(input, softmax.getOutput());
+	softmax.backwardPropagation(input, softmax.getOutput(), gradients, softmax.getGradientOutput(), TrainingSettings());
+
+	const auto & out = softmax.getOutput();
+	for (auto i = 0u; i < 4; i++)
+	{
+		auto expected = 0.0f;
+		for (auto k = 0u; k < 4; k++)
+		{
+			expected += out(i) * ((i == k) ? 1.0f - out(k) : -out(k)) * gradients(k);
+		}
+		EXPECT_NEAR(softmax.getGradientOutput()(i), expected, 1e-6f);
+	}
+}
+
+TEST(ActivationLayerTest, OutputLayersFusedWithLossTrainLikeSeparateLayers)
+{
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	data.emplace_back(Image<ForwardType>(std::vector<ForwardType>{ 1.0f, 0.0f, -1.0f, 0.5f }), Image<ForwardType>(std::vector<ForwardType>{ 0.0f, 1.0f, 0.0f }));
+	data.emplace_back(Image<ForwardType>(std::vector<ForwardType>{ -0.5f, 1.0f, 0.0f, 2.0f }), Image<ForwardType>(std::vector<ForwardType>{ 1.0f, 0.0f, 0.0f }));
+	data.emplace_back(Image<ForwardType>(std::vector<ForwardType>{ 0.0f, 0.5f, 1.0f, -1.0f }), Image<ForwardType>(std::vector<ForwardType>{ 0.0f, 0.0f, 1.0f }));
+
+	for (auto lossFunction : { LossFunctionType::CrossEntropy, LossFunctionType::BinaryCrossEntropy })
+	{
+		// Dropout that never drops hides output layer from loss function, so that its Jacobian is used
+		std::vector<std::shared_ptr<FullyConnectedLayer<ForwardType, WeightType>>> layers;
+		std::vector<float> errors;
+		for (auto separate : { false, true })
+		{
+			srand(11);
+			ConvolutionalNeuralNetwork cnn;
+			layers.push_back(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 4, 1, 1 }, Dimensions{ 3, 1, 1 }));
+			cnn.addLayer(layers.back());
+			if (lossFunction == LossFunctionType::CrossEntropy)
+			{
+				cnn.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+			}
+			else
+			{
+				cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+			}
+			if (separate)
+			{
+				cnn.addLayer(std::make_shared<DropoutLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, 0.0f));
+			}
+
+			TrainingSettings settings;
+			settings.epochs = 5;
+			errors.push_back(cnn.train(settings, data, lossFunction, std::make_shared<Sgd>()));
+		}
+
+		EXPECT_NEAR(errors[0], errors[1], 1e-4f);
+
+		auto fused = layers[0]->getNeuronWeights();
+		auto separate = layers[1]->getNeuronWeights();
+		for (auto i = 0u; i < fused.getFlattenedSize(); i++)
+		{
+			EXPECT_NEAR(fused(i), separate(i), 1e-4f);
+		}
+	}
+}
+
+TEST(ActivationLayerTest, SampledSoftmaxLearnsManyClasses)
+{
+	// Each of 64 classes is given by its own input
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	for (auto i = 0u; i < 64; i++)
+	{
+		data.emplace_back(Image<ForwardType>(Dimensions{ 64, 1, 1 }), Image<ForwardType>(Dimensions{ 64, 1, 1 }));
+		data.back().first.clear();
+		data.back().second.clear();
+		data.back().first(i) = 1.0f;
+		data.back().second(i) = 1.0f;
+	}
+
+	srand(5);
+	ConvolutionalNeuralNetwork cnn;
+	cnn.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 64, 1, 1 }, Dimensions{ 64, 1, 1 }));
+	cnn.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 64, 1, 1 }));
+
+	auto optimizer = std::make_shared<Sgd>();
+	optimizer->learningRate = 0.5f;
+
+	TrainingSettings settings;
+	settings.sampledClasses = 4;
+	settings.epochs = 1;
+	auto firstError = cnn.train(settings, data, LossFunctionType::CrossEntropy, optimizer);
+	settings.epochs = 20;
+	auto lastError = cnn.train(settings, data, LossFunctionType::CrossEntropy, optimizer);
+
+	// Validation uses full softmax
+	EXPECT_LT(lastError, firstError);
+	EXPECT_FLOAT_EQ(cnn.validate(data), 100.0f);
+}
+
+TEST(ActivationLayerTest, SampledSoftmaxRequiresFullyConnectedLayerAndSoftmax)
+{
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	data.emplace_back(Image<ForwardType>(std::vector<ForwardType>{ 1.0f, 0.0f }), Image<ForwardType>(std::vector<ForwardType>{ 0.0f, 1.0f, 0.0f, 0.0f }));
+
+	ConvolutionalNeuralNetwork cnn;
+	cnn.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 2, 1, 1 }, Dimensions{ 4, 1, 1 }));
+	cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 4, 1, 1 }));
+
+	TrainingSettings settings;
+	settings.sampledClasses = 1;
+	EXPECT_THROW(cnn.train(settings, data, LossFunctionType::CrossEntropy, std::make_shared<Sgd>()), CNNException);
+}
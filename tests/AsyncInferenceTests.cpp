@@ -0,0 +1,75 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for asynchronous inference
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+
+#include <future>
+#include <vector>
+
+class AsyncInferenceTests : public ::testing::Test
+{
+	public:
+
+		AsyncInferenceTests()
+		{
+			auto layer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 2, 1, 1 }, true);
+			layer->setNeuronWeights(Image<WeightType>({ {
+				{ -3.0f, -2.0f, -1.0f, 0.0f },
+				{  1.0f,  2.0f,  3.0f, 4.0f }
+				} }));
+
+			cnn.addLayer(layer);
+			cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 2, 1, 1 }));
+		}
+
+	protected:
+
+		ConvolutionalNeuralNetwork cnn;
+};
+
+TEST_F(AsyncInferenceTests, FuturesHoldSameOutputsAsDirectRun)
+{
+	cnn.setMaxInFlight(3);
+
+	std::vector<std::future<Image<ForwardType>>> futures;
+	for (auto i = 0; i < 64; i++)
+	{
+		futures.push_back(cnn.runAsync(Image<ForwardType>(std::vector<ForwardType>{ static_cast<float>(i), -2.0f, 1.0f })));
+		EXPECT_LE(cnn.getInFlight(), 3u);
+	}
+
+	auto context = cnn.createExecutionContext();
+	for (auto i = 0; i < 64; i++)
+	{
+		auto output = futures[i].get();
+		Image<ForwardType> expected;
+		expected = cnn.run(context, Image<ForwardType>(std::vector<ForwardType>{ static_cast<float>(i), -2.0f, 1.0f }));
+
+		EXPECT_TRUE(expected == output);
+	}
+}
+
+TEST_F(AsyncInferenceTests, CancelledRunStoresException)
+{
+	CancellationToken token;
+	token.cancel();
+
+	auto future = cnn.runAsync(Image<ForwardType>(std::vector<ForwardType>{ 1.0f, 2.0f, 3.0f }), token);
+
+	EXPECT_THROW(future.get(), CancelledException);
+}
+
+TEST_F(AsyncInferenceTests, FailedRunStoresException)
+{
+	auto future = cnn.runAsync(Image<ForwardType>(Dimensions{ 4, 1, 1 }));
+
+	EXPECT_THROW(future.get(), CNNException);
+}
@@ -0,0 +1,294 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for Batch normalization layer
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/BatchNormalizationLayer.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Optimizers/Sgd.h"
+
+TEST(BatchNormalizationLayerTest, NormalizesChannelsWithRunningStatistics)
+{
+	std::vector<std::vector<std::vector<ForwardType>>> input =
+	{ { { 1, 3 },
+		{ 5, 7 }
+	  },
+	  { { 2, 4 },
+		{ 6, 8 }
+	} };
+
+	auto img = Image<ForwardType>(input);
+	BatchNormalizationLayer<ForwardType, WeightType> layer(img.getDimensions(), 0.1f, 1e-5f);
+	layer.loadParameters({ 2.0f, 1.0f }, { 1.0f, -1.0f }, { 4.0f, 5.0f }, { 4.0f - 1e-5f, 1.0f - 1e-5f });
+	layer.forwardPropagation(img, layer.getOutput());
+
+	// (x - mean) / sqrt(variance + epsilon) * scale + shift
+	std::vector<std::vector<std::vector<ForwardType>>> expectedOutput =
+	{ { { -2, 0 },
+		{ 2, 4 }
+	  },
+	  { { -4, -2 },
+		{ 0, 2 }
+	} };
+
+	auto expected = Image<ForwardType>(expectedOutput);
+	for (auto i = 0u; i < expected.getFlattenedSize(); i++)
+	{
+		EXPECT_NEAR(static_cast<float>(expected(i)), static_cast<float>(layer.getOutput()(i)), 1e-4f);
+	}
+}
+
+/*
+ * @brief Creates layer with non-trivial scales and shifts and optimizer that does not change them
+ */
+static std::shared_ptr<BatchNormalizationLayer<ForwardType, WeightType>> createTrainedLayer(const Dimensions & dimensions)
+{
+	auto layer = std::make_shared<BatchNormalizationLayer<ForwardType, WeightType>>(dimensions, 0.1f, 1e-5f);
+	auto optimizer = std::make_shared<Sgd>();
+	optimizer->learningRate = 0.0f;
+	layer->setOptimizer(optimizer);
+	layer->initializeOptimizer();
+
+	std::vector<BackwardType> scales, shifts, means, variances;
+	for (auto feature = 0u; feature < layer->getFeatureNum(); feature++)
+	{
+		scales.push_back(static_cast<BackwardType>(1.5f - 0.5f * feature));
+		shifts.push_back(static_cast<BackwardType>(0.25f * feature));
+		means.push_back(static_cast<BackwardType>(0.0f));
+		variances.push_back(static_cast<BackwardType>(1.0f));
+	}
+	layer->loadParameters(scales, shifts, means, variances);
+
+	return layer;
+}
+
+
+/*
+ * @brief Compares gradients of layer with central differences of loss sum(weights * output)
+ */
+static void expectGradientsMatchDifferences(BatchNormalizationLayer<ForwardType, WeightType> & layer, Image<ForwardType> & input, const TrainingSettings & settings)
+{
+	Image<BackwardType> weights(input.getDimensions());
+	for (auto i = 0u; i < weights.getFlattenedSize(); i++)
+	{
+		weights(i) = static_cast<BackwardType>(static_cast<float>((i * 5) % 7) / 3.0f - 1.0f);
+	}
+
+	auto loss = [&layer, &weights](const Image<ForwardType> & in)
+	{
+		layer.trainingPropagation(in, layer.getOutput());
+		auto sum = 0.0;
+		for (auto i = 0u; i < in.getFlattenedSize(); i++)
+		{
+			sum += static_cast<double>(weights(i)) * static_cast<double>(layer.getOutput()(i));
+		}
+		return sum;
+	};
+
+	// Differences first, training propagation is repeatable until backward propagation accumulates the sample
+	const auto step = 1e-2f;
+	std::vector<double> differences;
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		const auto value = input(i);
+		input(i) = value + step;
+		const auto higher = loss(input);
+		input(i) = value - step;
+		const auto lower = loss(input);
+		input(i) = value;
+		differences.push_back((higher - lower) / (2.0 * step));
+	}
+
+	loss(input);
+	layer.backwardPropagation(input, layer.getOutput(), weights, layer.getGradientOutput(), settings);
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		EXPECT_NEAR(differences[i], static_cast<float>(layer.getGradientOutput()(i)), 2e-3);
+	}
+}
+
+TEST(BatchNormalizationLayerTest, TrainingNormalizesChannelsWithStatisticsOfSample)
+{
+	BatchNormalizationLayer<ForwardType, WeightType> layer(Dimensions{ 2, 1, 2 }, 0.1f, 1e-5f);
+	auto optimizer = std::make_shared<Sgd>();
+	optimizer->learningRate = 0.0f;
+	layer.setOptimizer(optimizer);
+	layer.initializeOptimizer();
+
+	TrainingSettings settings;
+	settings.batchSize = 2;
+
+	Image<BackwardType> gradients(Dimensions{ 2, 1, 2 });
+	gradients.clear();
+
+	Image<ForwardType> first(std::vector<std::vector<std::vector<ForwardType>>>{ { { 1.0f, 3.0f } }, { { 4.0f, 4.0f } } });
+	layer.trainingPropagation(first, layer.getOutput());
+	EXPECT_NEAR(-1.0f, static_cast<float>(layer.getOutput()(0)), 1e-3f);
+	EXPECT_NEAR(1.0f, static_cast<float>(layer.getOutput()(1)), 1e-3f);
+	EXPECT_NEAR(0.0f, static_cast<float>(layer.getOutput()(2)), 1e-3f);
+	layer.backwardPropagation(first, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+
+	// Previous sample of batch does not matter
+	Image<ForwardType> second(std::vector<std::vector<std::vector<ForwardType>>>{ { { 3.0f, 5.0f } }, { { 2.0f, 6.0f } } });
+	layer.trainingPropagation(second, layer.getOutput());
+	EXPECT_NEAR(-1.0f, static_cast<float>(layer.getOutput()(0)), 1e-3f);
+	EXPECT_NEAR(1.0f, static_cast<float>(layer.getOutput()(1)), 1e-3f);
+	EXPECT_NEAR(-1.0f, static_cast<float>(layer.getOutput()(2)), 1e-3f);
+	EXPECT_NEAR(1.0f, static_cast<float>(layer.getOutput()(3)), 1e-3f);
+	layer.backwardPropagation(second, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+
+	// Running statistics are mean of batch and mean of unbiased variances of samples
+	EXPECT_FLOAT_EQ(3.0f, static_cast<float>(layer.getRunningMeans()[0]));
+	EXPECT_FLOAT_EQ(2.0f, static_cast<float>(layer.getRunningVariances()[0]));
+	EXPECT_FLOAT_EQ(4.0f, static_cast<float>(layer.getRunningMeans()[1]));
+	EXPECT_FLOAT_EQ(4.0f, static_cast<float>(layer.getRunningVariances()[1]));
+
+	// Inference uses running statistics
+	layer.forwardPropagation(second, layer.getOutput());
+	EXPECT_NEAR(2.0f / std::sqrt(2.0f), static_cast<float>(layer.getOutput()(1)), 1e-3f);
+}
+
+TEST(BatchNormalizationLayerTest, TrainingNormalizesNeuronsWithStatisticsOfBatch)
+{
+	BatchNormalizationLayer<ForwardType, WeightType> layer(Dimensions{ 2, 1, 1 }, 0.1f, 1e-5f);
+	auto optimizer = std::make_shared<Sgd>();
+	optimizer->learningRate = 0.0f;
+	layer.setOptimizer(optimizer);
+	layer.initializeOptimizer();
+
+	TrainingSettings settings;
+	settings.batchSize = 3;
+
+	Image<BackwardType> gradients(Dimensions{ 2, 1, 1 });
+	gradients.clear();
+
+	// First sample of batch is its own mean
+	Image<ForwardType> first(std::vector<ForwardType>{ 1.0f, 2.0f });
+	layer.trainingPropagation(first, layer.getOutput());
+	EXPECT_NEAR(0.0f, static_cast<float>(layer.getOutput()(0)), 1e-3f);
+	layer.backwardPropagation(first, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+
+	// Second one is normalized with both samples
+	Image<ForwardType> second(std::vector<ForwardType>{ 3.0f, 2.0f });
+	layer.trainingPropagation(second, layer.getOutput());
+	EXPECT_NEAR(1.0f, static_cast<float>(layer.getOutput()(0)), 1e-3f);
+	EXPECT_NEAR(0.0f, static_cast<float>(layer.getOutput()(1)), 1e-3f);
+
+	// Batch of one sample cannot be normalized
+	settings.batchSize = 1;
+	EXPECT_THROW(layer.backwardPropagation(second, layer.getOutput(), gradients, layer.getGradientOutput(), settings), BatchNormalizationLayerException);
+}
+
+TEST(BatchNormalizationLayerTest, GradientsOfChannelsMatchFiniteDifferences)
+{
+	auto layer = createTrainedLayer(Dimensions{ 3, 2, 2 });
+	TrainingSettings settings;
+	settings.batchSize = 4;
+
+	Image<ForwardType> input(Dimensions{ 3, 2, 2 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>((i * 7) % 11) / 4.0f - 1.0f);
+	}
+
+	expectGradientsMatchDifferences(*layer, input, settings);
+}
+
+TEST(BatchNormalizationLayerTest, GradientsOfNeuronsMatchFiniteDifferences)
+{
+	auto layer = createTrainedLayer(Dimensions{ 3, 1, 1 });
+	TrainingSettings settings;
+	settings.batchSize = 4;
+
+	// Gradients of later samples of batch
+	Image<ForwardType> first(std::vector<ForwardType>{ 0.5f, -1.0f, 2.0f });
+	Image<ForwardType> second(std::vector<ForwardType>{ -0.5f, 1.0f, 1.5f });
+	Image<ForwardType> third(std::vector<ForwardType>{ 1.0f, 0.0f, -2.0f });
+	Image<BackwardType> gradients(std::vector<BackwardType>{ 1.0f, -1.0f, 0.5f });
+	layer->trainingPropagation(first, layer->getOutput());
+	layer->backwardPropagation(first, layer->getOutput(), gradients, layer->getGradientOutput(), settings);
+	expectGradientsMatchDifferences(*layer, second, settings);
+	expectGradientsMatchDifferences(*layer, third, settings);
+}
+
+TEST(BatchNormalizationLayerTest, BatchUpdatesRunningStatistics)
+{
+	BatchNormalizationLayer<ForwardType, WeightType> layer(Dimensions{ 3, 1, 1 }, 0.5f, 1e-5f);
+	auto optimizer = std::make_shared<Sgd>();
+	optimizer->learningRate = 0.0f;
+	layer.setOptimizer(optimizer);
+	layer.initializeOptimizer();
+
+	TrainingSettings settings;
+	settings.batchSize = 2;
+
+	Image<BackwardType> gradients(Dimensions{ 3, 1, 1 });
+	gradients.clear();
+
+	// First batch replaces initial statistics, each cell of FC output is one feature
+	Image<ForwardType> first(std::vector<ForwardType>{ 1.0f, 2.0f, -1.0f });
+	Image<ForwardType> second(std::vector<ForwardType>{ 3.0f, 2.0f, 1.0f });
+	layer.backwardPropagation(first, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+	layer.backwardPropagation(second, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+
+	EXPECT_FLOAT_EQ(2.0f, static_cast<float>(layer.getRunningMeans()[0]));
+	EXPECT_FLOAT_EQ(2.0f, static_cast<float>(layer.getRunningVariances()[0]));
+	EXPECT_FLOAT_EQ(2.0f, static_cast<float>(layer.getRunningMeans()[1]));
+	EXPECT_FLOAT_EQ(0.0f, static_cast<float>(layer.getRunningVariances()[1]));
+	EXPECT_FLOAT_EQ(0.0f, static_cast<float>(layer.getRunningMeans()[2]));
+
+	// Next batches are weighted by momentum
+	layer.backwardPropagation(second, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+	layer.backwardPropagation(second, layer.getOutput(), gradients, layer.getGradientOutput(), settings);
+
+	EXPECT_FLOAT_EQ(2.5f, static_cast<float>(layer.getRunningMeans()[0]));
+	EXPECT_FLOAT_EQ(1.0f, static_cast<float>(layer.getRunningVariances()[0]));
+	EXPECT_FLOAT_EQ(0.5f, static_cast<float>(layer.getRunningMeans()[2]));
+}
+
+TEST(BatchNormalizationLayerTest, FoldedNetworkMatchesOriginal)
+{
+	srand(7);
+
+	auto convolution = std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 2 }, 1, 3, 3, 1, false);
+	auto convolutionNormalization = std::make_shared<BatchNormalizationLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 3 });
+	convolutionNormalization->loadParameters({ 0.5f, 2.0f, -1.0f }, { 0.1f, -0.2f, 0.3f }, { 0.2f, -0.1f, 0.0f }, { 0.5f, 2.0f, 1.5f });
+	auto fullyConnected = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 3 }, Dimensions{ 2, 1, 1 });
+	auto fullyConnectedNormalization = std::make_shared<BatchNormalizationLayer<ForwardType, WeightType>>(Dimensions{ 2, 1, 1 });
+	fullyConnectedNormalization->loadParameters({ 1.5f, 0.5f }, { 0.0f, 1.0f }, { 0.3f, -0.3f }, { 0.8f, 1.2f });
+
+	ConvolutionalNeuralNetwork cnn;
+	cnn.addLayer(convolution);
+	cnn.addLayer(convolutionNormalization);
+	cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 3 }));
+	cnn.addLayer(fullyConnected);
+	cnn.addLayer(fullyConnectedNormalization);
+	cnn.releaseTrainingState();
+
+	Image<ForwardType> input(Dimensions{ 6, 6, 2 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>((i * 7) % 17) / 8.0f - 1.0f);
+	}
+
+	Image<ForwardType> expected;
+	expected = cnn.run(input);
+
+	// Network used only for inference folds normalization during compilation
+	cnn.compile();
+	EXPECT_EQ(3, std::distance(cnn.begin(), cnn.end()));
+
+	auto context = cnn.createExecutionContext();
+	const auto & output = cnn.run(context, input);
+	for (auto i = 0u; i < expected.getFlattenedSize(); i++)
+	{
+		EXPECT_NEAR(static_cast<float>(expected(i)), static_cast<float>(output(i)), 1e-4f);
+	}
+}
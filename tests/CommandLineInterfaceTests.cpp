@@ -0,0 +1,149 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for command line interface
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/CommandLineInterface.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+#include "src/Utils/Persistence.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	/*
+	 * @brief Writes 32-bit number in big endian (as IDX header requires)
+	 */
+	void writeBigEndian(std::ofstream & file, const uint32_t value)
+	{
+		for (auto shift : { 24, 16, 8, 0 })
+		{
+			file.put(static_cast<char>((value >> shift) & 0xFF));
+		}
+	}
+
+	/*
+	 * @brief Pixel of given sample
+	 */
+	uint8_t getPixel(const unsigned sample, const unsigned i)
+	{
+		return static_cast<uint8_t>((i * 37 + sample * 91) % 256);
+	}
+
+	/*
+	 * @brief Image parsed from pixels of given sample
+	 */
+	Image<ForwardType> createInput(const unsigned sample)
+	{
+		Image<ForwardType> input(Dimensions{ 4, 4, 1 });
+		for (auto i = 0u; i < input.getFlattenedSize(); i++)
+		{
+			input(i) = static_cast<ForwardType>(getPixel(sample, i) / 255.0f);
+		}
+
+		return input;
+	}
+}
+
+TEST(CommandLineInterfaceTests, BatchInferenceDoesNotNeedLabels)
+{
+	srand(11);
+	ConvolutionalNeuralNetwork original;
+	original.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 1 }, Dimensions{ 3, 1, 1 }));
+	original.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+
+	const auto directory = "/tmp/typecnn_cli_" + std::to_string(getpid());
+	const auto networkPath = directory + "/network.xml";
+	const auto idxPath = directory + "/images.idx3-ubyte";
+	const auto binPath = directory + "/images.bin";
+	const auto predictionsPath = directory + "/predictions.txt";
+	ASSERT_EQ(0, mkdir(directory.c_str(), 0700));
+	Persistence().dumpNetwork(original, networkPath);
+
+	// IDX images without labels file, followed by BIN records whose label byte is ignored
+	const auto idxSampleNum = 3u;
+	const auto binSampleNum = 2u;
+	std::ofstream idxFile(idxPath, std::ios::binary);
+	writeBigEndian(idxFile, 0x00000803);
+	writeBigEndian(idxFile, idxSampleNum);
+	writeBigEndian(idxFile, 4);
+	writeBigEndian(idxFile, 4);
+	for (auto sample = 0u; sample < idxSampleNum; sample++)
+	{
+		for (auto i = 0u; i < 16; i++)
+		{
+			idxFile.put(static_cast<char>(getPixel(sample, i)));
+		}
+	}
+	idxFile.close();
+
+	std::ofstream binFile(binPath, std::ios::binary);
+	for (auto sample = idxSampleNum; sample < idxSampleNum + binSampleNum; sample++)
+	{
+		binFile.put(static_cast<char>(0xFF));
+		for (auto i = 0u; i < 16; i++)
+		{
+			binFile.put(static_cast<char>(getPixel(sample, i)));
+		}
+	}
+	binFile.close();
+
+	std::vector<std::string> arguments = { "TypeCNN", "-c", networkPath, "--batch", idxPath, "--batch", binPath, "--predictions", predictionsPath };
+	std::vector<char *> argv;
+	for (auto & argument : arguments)
+	{
+		argv.push_back(&argument[0]);
+	}
+	auto exitCode = CommandLineInterface().runWithGivenArguments(static_cast<int>(argv.size()), argv.data());
+
+	std::vector<Image<ForwardType>> inputs;
+	for (auto sample = 0u; sample < idxSampleNum + binSampleNum; sample++)
+	{
+		inputs.push_back(createInput(sample));
+	}
+	auto expected = Persistence().loadNetwork(networkPath, true, true).runBatch(inputs);
+
+	std::vector<std::string> lines;
+	std::ifstream predictions(predictionsPath);
+	for (std::string line; std::getline(predictions, line); )
+	{
+		lines.push_back(line);
+	}
+	predictions.close();
+	std::system(("rm -rf " + directory).c_str());
+
+	ASSERT_EQ(EXIT_SUCCESS, exitCode);
+	ASSERT_EQ(expected.getHeight(), lines.size());
+	for (auto row = 0u; row < expected.getHeight(); row++)
+	{
+		// Predicted class is followed by all outputs
+		std::istringstream line(lines[row]);
+		unsigned predictedClass;
+		line >> predictedClass;
+		EXPECT_EQ(static_cast<unsigned>(std::max_element(&expected(0, row), &expected(0, row) + 3) - &expected(0, row)), predictedClass);
+
+		for (auto i = 0u; i < expected.getWidth(); i++)
+		{
+			float output;
+			ASSERT_TRUE(line >> output);
+			EXPECT_NEAR(static_cast<float>(expected(i, row)), output, 1e-4f);
+		}
+	}
+}
+
+#endif
@@ -8,6 +8,11 @@
 
 #include "src/Image.h"
 #include "src/Layers/ConvolutionalLayer.h"
+#include "src/Optimizers/Sgd.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <limits>
+#include <type_traits>
 
 // We need to access inner structures of Convolutional layer for some tests
 class ConvolutionalLayerTests : public ::testing::Test, public ConvolutionalLayer<ForwardType, WeightType>
@@ -198,3 +203,97 @@ TEST_F(ConvolutionalLayerTests, ForwardAndBackwardPropagationWorkCorrectly)
 	EXPECT_TRUE(expectedFilterDeltas == filterDeltas[0]);
 	EXPECT_EQ(expectedBiasDeltas[0], biasDeltas[0]);
 }
+
+TEST_F(ConvolutionalLayerTests, ForwardFiltersAreCopiedOnlyForDifferentType)
+{
+	const auto shared = static_cast<void *>(&forwardFilters[0](0)) == static_cast<void *>(&filters[0](0));
+	EXPECT_EQ((std::is_same<WeightType, BackwardType>::value), shared);
+}
+
+TEST(ConvolutionalLayerInferenceTests, LayerCreatedForInferenceOnlyHasNoTrainingState)
+{
+	Image<ForwardType> input(std::vector<std::vector<std::vector<ForwardType>>>
+	{ { { 1 } },
+	  { { 5 }
+	} });
+
+	srand(3);
+	ConvolutionalLayer<ForwardType, WeightType> trainable(input.getDimensions(), 1, 3, 3, 1, true);
+	srand(3);
+	ConvolutionalLayer<ForwardType, WeightType> layer(input.getDimensions(), 1, 3, 3, 1, true, true);
+
+	// Random filters and biases are generated directly in forward type
+	auto trainableFilters = trainable.getFilters();
+	auto filters = layer.getFilters();
+	ASSERT_EQ(3u, filters.size());
+	for (auto f = 0u; f < filters.size(); f++)
+	{
+		EXPECT_TRUE(trainableFilters[f] == filters[f]);
+	}
+	EXPECT_EQ(trainable.getBiases(), layer.getBiases());
+	EXPECT_FALSE(layer.hasTrainingState());
+	EXPECT_EQ(0u, layer.getGradientOutput().getFlattenedSize());
+
+	Image<BackwardType> filter(Dimensions{ 3, 3, 2 });
+	for (auto i = 0u; i < filter.getFlattenedSize(); i++)
+	{
+		filter(i) = static_cast<BackwardType>(static_cast<float>(i % 9 + 1));
+	}
+	std::vector<Image<BackwardType>> testFilters = { filter, filter, filter };
+	layer.loadFilters(testFilters, { 1, 2, 3 });
+
+	// Loaded filters are copied
+	filter(4) = 100.0f;
+
+	layer.forwardPropagation(input, layer.getOutput());
+
+	Image<ForwardType> expectedOutput(std::vector<std::vector<std::vector<ForwardType>>>
+	{ { { 31 } },
+	  { { 32 } },
+	  { { 33 } }
+	});
+
+	EXPECT_TRUE(expectedOutput == layer.getOutput());
+}
+
+TEST(ConvolutionalLayerParallelTests, ParallelPropagationMatchesSerial)
+{
+	ConvolutionalLayer<ForwardType, WeightType> serial(Dimensions{ 9, 9, 3 }, 2, 4, 3, 1, true);
+	ConvolutionalLayer<ForwardType, WeightType> parallel(Dimensions{ 9, 9, 3 }, 2, 4, 3, 1, true);
+	parallel.loadFilters(serial.getFilters(), serial.getBiases());
+	serial.setOptimizer(std::make_shared<Sgd>());
+	parallel.setOptimizer(std::make_shared<Sgd>());
+
+	Image<ForwardType> input(Dimensions{ 9, 9, 3 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>(i % 17) / 8.0f - 1.0f);
+	}
+
+	Image<BackwardType> gradients(serial.getOutputSize());
+	for (auto i = 0u; i < gradients.getFlattenedSize(); i++)
+	{
+		gradients(i) = static_cast<BackwardType>(static_cast<float>(i % 7) / 3.0f - 1.0f);
+	}
+
+	auto threshold = ThreadPool::getParallelThreshold();
+	TrainingSettings settings;
+
+	ThreadPool::setParallelThreshold(std::numeric_limits<size_t>::max());
+	serial.forwardPropagation(input, serial.getOutput());
+	serial.backwardPropagation(input, serial.getOutput(), gradients, serial.getGradientOutput(), settings);
+
+	ThreadPool::setParallelThreshold(0);
+	parallel.forwardPropagation(input, parallel.getOutput());
+	parallel.backwardPropagation(input, parallel.getOutput(), gradients, parallel.getGradientOutput(), settings);
+
+	ThreadPool::setParallelThreshold(threshold);
+
+	EXPECT_TRUE(serial.getOutput() == parallel.getOutput());
+	EXPECT_TRUE(serial.getGradientOutput() == parallel.getGradientOutput());
+	for (auto f = 0u; f < serial.getFilterNum(); f++)
+	{
+		EXPECT_TRUE(serial.getFilters()[f] == parallel.getFilters()[f]);
+	}
+	EXPECT_EQ(serial.getBiases(), parallel.getBiases());
+}
@@ -0,0 +1,210 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for compiled execution plan
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/MaxPoolingLayer.h"
+#include "src/Layers/AvgPoolingLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/LeakyReluActivationLayer.h"
+#include "src/Layers/TanhActivationLayer.h"
+#include "src/Layers/SigmoidActivationLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+#include "src/Utils/ThreadPool.h"
+
+class ExecutionPlanTests : public ::testing::Test
+{
+	public:
+
+		ExecutionPlanTests()
+		{
+			srand(7);
+
+			// Covers kernels with and without padding and bias
+			cnn.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }, 1, 4, 3, 1, true));
+			cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 4 }));
+			cnn.addLayer(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 4 }, 2, 2));
+			cnn.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 4 }, 1, 2, 3, 0, false));
+			cnn.addLayer(std::make_shared<TanhActivationLayer<ForwardType, WeightType>>(Dimensions{ 2, 2, 2 }));
+			cnn.addLayer(std::make_shared<AvgPoolingLayer<ForwardType, WeightType>>(Dimensions{ 2, 2, 2 }, 2, 2));
+			cnn.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 1, 1, 2 }, Dimensions{ 3, 1, 1 }));
+			cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+			cnn.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+		}
+
+	protected:
+
+		static Image<ForwardType> createInput(const Dimensions & dimensions, const unsigned sample)
+		{
+			Image<ForwardType> input(dimensions);
+			for (auto i = 0u; i < input.getFlattenedSize(); i++)
+			{
+				input(i) = static_cast<ForwardType>(static_cast<float>((i * 7 + sample * 13) % 17) / 8.0f - 1.0f);
+			}
+
+			return input;
+		}
+
+		static void expectRowsMatch(const std::vector<Image<ForwardType>> & expected, const Image<ForwardType> & outputs)
+		{
+			ASSERT_EQ(expected.size(), outputs.getHeight());
+			for (auto row = 0u; row < outputs.getHeight(); row++)
+			{
+				ASSERT_EQ(expected[row].getFlattenedSize(), outputs.getWidth());
+				for (auto i = 0u; i < outputs.getWidth(); i++)
+				{
+					EXPECT_NEAR(static_cast<float>(expected[row](i)), static_cast<float>(outputs(i, row)), 1e-5f);
+				}
+			}
+		}
+
+	protected:
+
+		ConvolutionalNeuralNetwork cnn;
+};
+
+TEST_F(ExecutionPlanTests, CompiledPlanMatchesCheckedPropagation)
+{
+	auto checkedContext = cnn.createExecutionContext();
+	cnn.compile();
+	auto compiledContext = cnn.createExecutionContext();
+
+	EXPECT_TRUE(cnn.isCompiled());
+
+	for (auto sample = 0; sample < 4; sample++)
+	{
+		auto input = createInput(Dimensions{ 8, 8, 2 }, sample);
+
+		Image<ForwardType> expected;
+		expected = cnn.run(checkedContext, input);
+
+		EXPECT_TRUE(expected == cnn.run(compiledContext, input));
+	}
+}
+
+TEST_F(ExecutionPlanTests, CompiledPlanChecksInputOnce)
+{
+	cnn.compile();
+	auto context = cnn.createExecutionContext();
+
+	EXPECT_THROW(cnn.run(context, Image<ForwardType>(Dimensions{ 8, 8, 1 })), InputImageDoesNotHaveCorrectDimensions);
+}
+
+TEST_F(ExecutionPlanTests, CompilationRejectsMismatchedLayers)
+{
+	cnn.compile();
+	cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 4, 1, 1 }));
+
+	EXPECT_FALSE(cnn.isCompiled());
+	EXPECT_THROW(cnn.compile(), CNNException);
+}
+
+TEST_F(ExecutionPlanTests, StaleContextsAreRejected)
+{
+	cnn.compile();
+	auto compiledContext = cnn.createExecutionContext();
+	auto input = createInput(Dimensions{ 8, 8, 2 }, 0);
+
+	// Layers of previous plan may be gone after recompilation
+	cnn.compile(false);
+	EXPECT_THROW(cnn.run(compiledContext, input), CNNException);
+
+	auto checkedContext = cnn.createExecutionContext();
+	EXPECT_NO_THROW(cnn.run(checkedContext, input));
+
+	// Buffers do not match added layer
+	cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+	EXPECT_THROW(cnn.run(checkedContext, input), CNNException);
+
+	ConvolutionalNeuralNetwork other;
+	other.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }));
+	auto otherContext = other.createExecutionContext();
+	EXPECT_THROW(cnn.run(otherContext, input), CNNException);
+}
+
+TEST_F(ExecutionPlanTests, FusedLayersMatchSeparateLayers)
+{
+	// Pooling precedes activation here, unlike in fixture
+	ConvolutionalNeuralNetwork lenet;
+	lenet.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 12, 12, 1 }, 1, 3, 5, 2, true));
+	lenet.addLayer(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 12, 12, 3 }, 2, 2));
+	lenet.addLayer(std::make_shared<LeakyReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 3 }));
+	lenet.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 6, 6, 3 }, Dimensions{ 5, 1, 1 }));
+	lenet.addLayer(std::make_shared<LeakyReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 5, 1, 1 }));
+
+	for (auto network : { &cnn, &lenet })
+	{
+		auto inputSize = (network == &cnn) ? Dimensions{ 8, 8, 2 } : Dimensions{ 12, 12, 1 };
+
+		// Contexts of previous plan cannot be run after compilation
+		network->compile(false);
+		auto separateContext = network->createExecutionContext();
+		std::vector<Image<ForwardType>> expected(4);
+		for (auto sample = 0u; sample < expected.size(); sample++)
+		{
+			expected[sample] = network->run(separateContext, createInput(inputSize, sample));
+		}
+
+		network->compile();
+		auto fusedContext = network->createExecutionContext();
+
+		// Outputs of fused convolutions and pooling are not allocated
+		EXPECT_LT(fusedContext.getByteSize(), separateContext.getByteSize());
+
+		for (auto sample = 0u; sample < expected.size(); sample++)
+		{
+			EXPECT_TRUE(expected[sample] == network->run(fusedContext, createInput(inputSize, sample)));
+		}
+	}
+}
+
+TEST_F(ExecutionPlanTests, BatchedRunsMatchSingleRuns)
+{
+	const auto threadNum = ThreadPool::getShared().getThreadNum();
+
+	// Empty batch, batches smaller than number of workers and batch split unevenly among them
+	for (auto batchSize : { 0u, 1u, threadNum > 1 ? threadNum - 1 : 1u, 3 * threadNum + 1 })
+	{
+		std::vector<Image<ForwardType>> inputs;
+		std::vector<Image<ForwardType>> expected;
+		for (auto sample = 0u; sample < batchSize; sample++)
+		{
+			// Output of network is overwritten by next run, it is copied
+			inputs.push_back(createInput(Dimensions{ 8, 8, 2 }, sample));
+			expected.emplace_back();
+			expected.back() = cnn.run(inputs.back());
+		}
+
+		for (auto compiled : { false, true })
+		{
+			if (compiled)
+			{
+				cnn.compile();
+			}
+
+			expectRowsMatch(expected, cnn.runBatch(inputs));
+
+			auto context = cnn.createExecutionContext();
+			expectRowsMatch(expected, cnn.runBatch(context, inputs));
+
+			auto next = 0u;
+			expectRowsMatch(expected, cnn.runBatch([&inputs, &next](Image<ForwardType> & input)
+			{
+				if (next == inputs.size())
+				{
+					return false;
+				}
+
+				input = inputs[next++];
+				return true;
+			}));
+		}
+	}
+}
@@ -7,7 +7,13 @@
 #include <gtest/gtest.h>
 
 #include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
 #include "src/Layers/FullyConnectedLayer.h"
+#include "src/Optimizers/Sgd.h"
+#include "src/Utils/ThreadPool.h"
+
+#include <limits>
+#include <type_traits>
 
 // We need to access inner structures of Convolutional layer for some tests
 class FullyConnectedLayerTests : public ::testing::Test, public FullyConnectedLayer<ForwardType, WeightType>
@@ -115,3 +121,119 @@ TEST_F(FullyConnectedLayerTests, BackwardPropagation)
 	EXPECT_TRUE(expectedOutputDeltas == getGradientOutput());
 	EXPECT_TRUE(expectedDeltas == deltas);
 }
+
+TEST_F(FullyConnectedLayerTests, ForwardPropagationAfterReleasingTrainingState)
+{
+	auto layer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 2, 1, 1 }, true);
+
+	Image<ForwardType> input(std::vector<std::vector<std::vector<ForwardType>>>{ {
+		{ 1.0f, 2.0f, 3.0f }
+		} });
+
+	Image<WeightType> testWeights({ {
+		{ -3.0f, -2.0f, -1.0f, 0.0f },
+		{  1.0f,  2.0f,  3.0f, 4.0f }
+		} });
+
+	Image<ForwardType> expectedOutput(std::vector<std::vector<std::vector<ForwardType>>>{ {
+		{ -10.0f, 18.0f }
+		} }
+	);
+
+	layer->setNeuronWeights(testWeights);
+	layer->releaseTrainingState();
+	layer->forwardPropagation(input, layer->getOutput());
+
+	EXPECT_TRUE(expectedOutput == layer->getOutput());
+	EXPECT_EQ(0u, layer->getGradientOutput().getFlattenedSize());
+	EXPECT_TRUE(testWeights == layer->getNeuronWeights());
+}
+
+TEST_F(FullyConnectedLayerTests, ForwardWeightsAreCopiedOnlyForDifferentType)
+{
+	const auto shared = static_cast<void *>(&forwardWeights(0)) == static_cast<void *>(&weights(0));
+	EXPECT_EQ((std::is_same<WeightType, BackwardType>::value), shared);
+
+	// Forward propagation sees updated weights in both cases
+	Image<BackwardType> testWeights({ {
+		{ -3.0f, -2.0f, -1.0f, 0.0f },
+		{  1.0f,  2.0f,  3.0f, 4.0f }
+		} });
+	setNeuronWeights(testWeights);
+
+	Image<ForwardType> input(std::vector<ForwardType>{ 1.0f, 2.0f, 3.0f });
+	forwardPropagation(input, getOutput());
+	EXPECT_TRUE(Image<ForwardType>(std::vector<ForwardType>{ -10.0f, 18.0f }) == getOutput());
+}
+
+TEST(FullyConnectedLayerInferenceTests, LayerCreatedForInferenceOnlyHasNoTrainingState)
+{
+	srand(3);
+	FullyConnectedLayer<ForwardType, WeightType> trainable(Dimensions{ 3, 1, 1 }, Dimensions{ 2, 1, 1 }, true);
+	srand(3);
+	auto layer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 2, 1, 1 }, true, true);
+
+	// Random weights are generated directly in forward type
+	EXPECT_TRUE(trainable.getNeuronWeights() == layer->getNeuronWeights());
+	EXPECT_TRUE(trainable.hasTrainingState());
+	EXPECT_FALSE(layer->hasTrainingState());
+	EXPECT_EQ(0u, layer->getGradientOutput().getFlattenedSize());
+
+	// Loaded weights are copied
+	Image<BackwardType> testWeights({ {
+		{ -3.0f, -2.0f, -1.0f, 0.0f },
+		{  1.0f,  2.0f,  3.0f, 4.0f }
+		} });
+	layer->setNeuronWeights(testWeights);
+	testWeights(0) = 100.0f;
+
+	Image<ForwardType> input(std::vector<ForwardType>{ 1.0f, 2.0f, 3.0f });
+	Image<ForwardType> expectedOutput(std::vector<ForwardType>{ -10.0f, 18.0f });
+	layer->forwardPropagation(input, layer->getOutput());
+	EXPECT_TRUE(expectedOutput == layer->getOutput());
+
+	ConvolutionalNeuralNetwork cnn;
+	cnn.addLayer(layer);
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	data.emplace_back(input, expectedOutput);
+	TrainingSettings settings;
+	EXPECT_THROW(cnn.train(settings, data, LossFunctionType::MeanSquaredError, std::make_shared<Sgd>()), CNNException);
+}
+
+TEST(FullyConnectedLayerParallelTests, ParallelPropagationMatchesSerial)
+{
+	FullyConnectedLayer<ForwardType, WeightType> serial(Dimensions{ 5, 5, 4 }, Dimensions{ 37, 1, 1 }, true);
+	FullyConnectedLayer<ForwardType, WeightType> parallel(Dimensions{ 5, 5, 4 }, Dimensions{ 37, 1, 1 }, true);
+	parallel.setNeuronWeights(serial.getNeuronWeights());
+	serial.setOptimizer(std::make_shared<Sgd>());
+	parallel.setOptimizer(std::make_shared<Sgd>());
+
+	Image<ForwardType> input(Dimensions{ 5, 5, 4 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>(i % 13) / 6.0f - 1.0f);
+	}
+
+	Image<BackwardType> gradients(Dimensions{ 37, 1, 1 });
+	for (auto i = 0u; i < gradients.getFlattenedSize(); i++)
+	{
+		gradients(i) = static_cast<BackwardType>(static_cast<float>(i % 5) / 2.0f - 1.0f);
+	}
+
+	auto threshold = ThreadPool::getParallelThreshold();
+	TrainingSettings settings;
+
+	ThreadPool::setParallelThreshold(std::numeric_limits<size_t>::max());
+	serial.forwardPropagation(input, serial.getOutput());
+	serial.backwardPropagation(input, serial.getOutput(), gradients, serial.getGradientOutput(), settings);
+
+	ThreadPool::setParallelThreshold(0);
+	parallel.forwardPropagation(input, parallel.getOutput());
+	parallel.backwardPropagation(input, parallel.getOutput(), gradients, parallel.getGradientOutput(), settings);
+
+	ThreadPool::setParallelThreshold(threshold);
+
+	EXPECT_TRUE(serial.getOutput() == parallel.getOutput());
+	EXPECT_TRUE(serial.getGradientOutput() == parallel.getGradientOutput());
+	EXPECT_TRUE(serial.getNeuronWeights() == parallel.getNeuronWeights());
+}
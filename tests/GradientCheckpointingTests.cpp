@@ -0,0 +1,219 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for gradient checkpointing
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/MaxPoolingLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/LeakyReluActivationLayer.h"
+#include "src/Layers/TanhActivationLayer.h"
+#include "src/Layers/SigmoidActivationLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+#include "src/Layers/DropoutLayer.h"
+#include "src/Optimizers/Sgd.h"
+#include "src/Utils/Persistence.h"
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class GradientCheckpointingTests : public ::testing::Test
+{
+	public:
+
+		GradientCheckpointingTests()
+		{
+			for (auto sample = 0u; sample < 6; sample++)
+			{
+				Image<ForwardType> input(Dimensions{ 8, 8, 2 });
+				for (auto i = 0u; i < input.getFlattenedSize(); i++)
+				{
+					input(i) = static_cast<ForwardType>(static_cast<float>((i * 7 + sample * 13) % 17) / 8.0f - 1.0f);
+				}
+
+				Image<ForwardType> expected(Dimensions{ 3, 1, 1 });
+				expected.clear();
+				expected(sample % 3) = static_cast<ForwardType>(1.0f);
+				data.emplace_back(input, expected);
+			}
+		}
+
+	protected:
+
+		/*
+		 * @brief Creates the same network on each call, it has chains of in place activations and dropout (which cannot be recomputed)
+		 */
+		static ConvolutionalNeuralNetwork createNetwork()
+		{
+			srand(7);
+			ConvolutionalNeuralNetwork cnn;
+			cnn.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }, 1, 4, 3, 1, true));
+			cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 4 }));
+			cnn.addLayer(std::make_shared<LeakyReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 4 }));
+			cnn.addLayer(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 4 }, 2, 2));
+			cnn.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 4 }, 1, 4, 3, 1, true));
+			cnn.addLayer(std::make_shared<TanhActivationLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 4 }));
+			cnn.addLayer(std::make_shared<DropoutLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 4 }, 0.25f));
+			cnn.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 4 }, 1, 3, 3, 1, false));
+			cnn.addLayer(std::make_shared<SigmoidActivationLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 3 }));
+			cnn.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 3 }, Dimensions{ 5, 1, 1 }));
+			cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 5, 1, 1 }));
+			cnn.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 5, 1, 1 }, Dimensions{ 3, 1, 1 }));
+			cnn.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+
+			return cnn;
+		}
+
+
+		/*
+		 * @brief Trains network (dropout draws the same masks in each training) and returns error of each epoch
+		 */
+		std::vector<float> train(ConvolutionalNeuralNetwork & cnn, const TrainingSettings & settings)
+		{
+			auto epochSettings = settings;
+			epochSettings.epochs = 1;
+			epochSettings.batchSize = 2;
+
+			auto optimizer = std::make_shared<Sgd>();
+			optimizer->learningRate = 0.1f;
+
+			srand(11);
+			std::vector<float> errors;
+			for (auto epoch = 0u; epoch < 3; epoch++)
+			{
+				errors.push_back(cnn.train(epochSettings, data, LossFunctionType::CrossEntropy, optimizer));
+			}
+
+			return errors;
+		}
+
+
+		/*
+		 * @brief Expects bit-identical errors, filters and weights
+		 */
+		static void expectIdentical(const std::vector<float> & expectedErrors, ConvolutionalNeuralNetwork & expected,
+			const std::vector<float> & actualErrors, ConvolutionalNeuralNetwork & actual)
+		{
+			EXPECT_EQ(expectedErrors, actualErrors);
+
+			for (auto layer = expected.begin(), other = actual.begin(); layer != expected.end(); ++layer, ++other)
+			{
+				if (auto convolution = dynamic_cast<ConvolutionalLayer<ForwardType, WeightType> *>(layer->get()))
+				{
+					auto otherFilters = dynamic_cast<ConvolutionalLayer<ForwardType, WeightType> *>(other->get())->getFilters();
+					auto filters = convolution->getFilters();
+					for (auto f = 0u; f < filters.size(); f++)
+					{
+						EXPECT_TRUE(filters[f] == otherFilters[f]);
+					}
+				}
+				else if (auto fullyConnected = dynamic_cast<FullyConnectedLayer<ForwardType, WeightType> *>(layer->get()))
+				{
+					auto otherWeights = dynamic_cast<FullyConnectedLayer<ForwardType, WeightType> *>(other->get())->getNeuronWeights();
+					EXPECT_TRUE(fullyConnected->getNeuronWeights() == otherWeights);
+				}
+			}
+		}
+
+	protected:
+
+		std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+};
+
+TEST_F(GradientCheckpointingTests, SquareRootCheckpointsGiveIdenticalTraining)
+{
+	auto reference = createNetwork();
+	auto referenceErrors = train(reference, TrainingSettings());
+	EXPECT_EQ(0u, reference.getCheckpointingStatistics().recomputedLayerNum);
+
+	auto checkpointed = createNetwork();
+	TrainingSettings settings;
+	settings.checkpointing = CheckpointingStrategy::SquareRoot;
+	auto errors = train(checkpointed, settings);
+
+	EXPECT_GT(checkpointed.getCheckpointingStatistics().recomputedLayerNum, 0u);
+	expectIdentical(referenceErrors, reference, errors, checkpointed);
+}
+
+TEST_F(GradientCheckpointingTests, MemoryBudgetCheckpointsGiveIdenticalTraining)
+{
+	auto reference = createNetwork();
+	auto referenceErrors = train(reference, TrainingSettings());
+
+	// Outputs of the first chain alone exceed half of all outputs
+	auto checkpointed = createNetwork();
+	TrainingSettings settings;
+	settings.checkpointing = CheckpointingStrategy::MemoryBudget;
+	settings.checkpointingMemoryBudget = 8 * 8 * 4 * sizeof(ForwardType);
+	auto errors = train(checkpointed, settings);
+
+	const auto statistics = checkpointed.getCheckpointingStatistics();
+	EXPECT_GT(statistics.recomputedLayerNum, 0u);
+	EXPECT_LT(statistics.peakActivationBytes, statistics.fullActivationBytes);
+	expectIdentical(referenceErrors, reference, errors, checkpointed);
+}
+
+TEST_F(GradientCheckpointingTests, ExplicitCheckpointsGiveIdenticalTraining)
+{
+	auto reference = createNetwork();
+	auto referenceErrors = train(reference, TrainingSettings());
+
+	// Pooling and fully connected layer keep their outputs, the rest is recomputed (except chain with dropout)
+	auto checkpointed = createNetwork();
+	checkpointed.begin()[3]->isCheckpoint = true;
+	checkpointed.begin()[9]->isCheckpoint = true;
+	auto errors = train(checkpointed, TrainingSettings());
+
+	const auto statistics = checkpointed.getCheckpointingStatistics();
+	EXPECT_GT(statistics.recomputedLayerNum, 0u);
+	EXPECT_LT(statistics.checkpointNum, statistics.layerNum);
+	expectIdentical(referenceErrors, reference, errors, checkpointed);
+}
+
+#ifndef _WIN32
+TEST_F(GradientCheckpointingTests, CheckpointsLoadedFromXmlGiveIdenticalTraining)
+{
+	auto original = createNetwork();
+	original.begin()[3]->isCheckpoint = true;
+	original.begin()[7]->isCheckpoint = true;
+
+	// Weights are dumped next to network
+	const auto directory = "/tmp/typecnn_checkpoints_" + std::to_string(getpid());
+	const auto path = directory + "/network.xml";
+	ASSERT_EQ(0, mkdir(directory.c_str(), 0700));
+	Persistence().dumpNetwork(original, path);
+
+	// Both networks get the same (dumped) weights, reference ignores checkpoints
+	auto reference = Persistence().loadNetwork(path, true);
+	for (auto & layer : reference)
+	{
+		layer->isCheckpoint = false;
+	}
+	auto checkpointed = Persistence().loadNetwork(path, true);
+	EXPECT_TRUE(checkpointed.begin()[3]->isCheckpoint);
+	EXPECT_TRUE(checkpointed.begin()[7]->isCheckpoint);
+	EXPECT_FALSE(checkpointed.begin()[4]->isCheckpoint);
+
+	std::system(("rm -rf " + directory).c_str());
+
+	auto referenceErrors = train(reference, TrainingSettings());
+	auto errors = train(checkpointed, TrainingSettings());
+
+	EXPECT_EQ(0u, reference.getCheckpointingStatistics().recomputedLayerNum);
+	EXPECT_GT(checkpointed.getCheckpointingStatistics().recomputedLayerNum, 0u);
+	expectIdentical(referenceErrors, reference, errors, checkpointed);
+}
+#endif
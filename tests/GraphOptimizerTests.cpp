@@ -0,0 +1,126 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for graph optimizer
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Utils/GraphOptimizer.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/MaxPoolingLayer.h"
+#include "src/Layers/AvgPoolingLayer.h"
+#include "src/Layers/BatchNormalizationLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/LeakyReluActivationLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+
+class GraphOptimizerTests : public ::testing::Test
+{
+	public:
+
+		GraphOptimizerTests()
+		{
+			srand(7);
+
+			// Activation in front of two max poolings, identity pooling and softmax that must stay in place
+			layers.push_back(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 1 }, 1, 2, 3, 1, true));
+			layers.push_back(std::make_shared<LeakyReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }));
+			layers.push_back(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }, 2, 2));
+			layers.push_back(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 2 }, 2, 2));
+			layers.push_back(std::make_shared<AvgPoolingLayer<ForwardType, WeightType>>(Dimensions{ 2, 2, 2 }, 1, 1));
+			layers.push_back(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 2, 2, 2 }, Dimensions{ 3, 1, 1 }));
+			layers.push_back(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+		}
+
+	protected:
+
+		static ConvolutionalNeuralNetwork createNetwork(const std::vector<GraphOptimizer::LayerPointer> & layers)
+		{
+			ConvolutionalNeuralNetwork cnn;
+			for (const auto & layer : layers)
+			{
+				cnn.addLayer(layer);
+			}
+			cnn.releaseTrainingState();
+
+			return cnn;
+		}
+
+	protected:
+
+		std::vector<GraphOptimizer::LayerPointer> layers;
+};
+
+TEST_F(GraphOptimizerTests, RewrittenNetworkMatchesOriginal)
+{
+	auto original = createNetwork(layers);
+
+	GraphOptimizer optimizer;
+	auto optimized = createNetwork(optimizer.optimize(layers));
+
+	// Activation moved after both poolings, poolings merged, identity pooling removed
+	EXPECT_EQ(5u, static_cast<unsigned>(std::distance(optimized.begin(), optimized.end())));
+	EXPECT_EQ(4u, static_cast<unsigned>(optimizer.getAppliedRewrites().size()));
+
+	auto pooling = dynamic_cast<MaxPoolingLayer<ForwardType, WeightType> *>(optimized.begin()[1].get());
+	ASSERT_NE(nullptr, pooling);
+	EXPECT_EQ(4u, pooling->getExtentSize());
+	auto activation = dynamic_cast<LeakyReluActivationLayer<ForwardType, WeightType> *>(optimized.begin()[2].get());
+	EXPECT_NE(nullptr, activation);
+
+	for (auto sample = 0u; sample < 4; sample++)
+	{
+		Image<ForwardType> input(Dimensions{ 8, 8, 1 });
+		for (auto i = 0u; i < input.getFlattenedSize(); i++)
+		{
+			input(i) = static_cast<ForwardType>(static_cast<float>((i * 7 + sample * 13) % 17) / 8.0f - 1.0f);
+		}
+
+		Image<ForwardType> expected;
+		expected = original.run(input);
+
+		EXPECT_TRUE(expected == optimized.run(input));
+	}
+}
+
+TEST_F(GraphOptimizerTests, OverlappingPoolingsAreNotMerged)
+{
+	std::vector<GraphOptimizer::LayerPointer> overlapping;
+	overlapping.push_back(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 7, 7, 1 }, 3, 2));
+	overlapping.push_back(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 3, 3, 1 }, 3, 3));
+	overlapping.push_back(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 1, 1, 1 }));
+
+	GraphOptimizer optimizer;
+	auto optimized = optimizer.optimize(overlapping);
+
+	EXPECT_EQ(overlapping, optimized);
+	EXPECT_TRUE(optimizer.getAppliedRewrites().empty());
+}
+
+TEST_F(GraphOptimizerTests, NormalizationOfSingleFilterIsNotFolded)
+{
+	// Output of single filter has one feature of normalization per cell
+	std::vector<GraphOptimizer::LayerPointer> singleFilter;
+	singleFilter.push_back(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 1 }, 1, 1, 3, 1, true));
+	auto normalization = std::make_shared<BatchNormalizationLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 1 });
+	std::vector<BackwardType> scales, shifts, means, variances;
+	for (auto feature = 0u; feature < normalization->getFeatureNum(); feature++)
+	{
+		scales.push_back(static_cast<BackwardType>(0.5f + 0.1f * feature));
+		shifts.push_back(static_cast<BackwardType>(0.2f * feature - 1.0f));
+		means.push_back(static_cast<BackwardType>(0.05f * feature));
+		variances.push_back(static_cast<BackwardType>(1.0f + 0.1f * feature));
+	}
+	normalization->loadParameters(scales, shifts, means, variances);
+	singleFilter.push_back(normalization);
+
+	GraphOptimizer optimizer;
+	auto optimized = optimizer.optimize(singleFilter);
+
+	EXPECT_EQ(singleFilter, optimized);
+	EXPECT_TRUE(optimizer.getAppliedRewrites().empty());
+}
@@ -0,0 +1,172 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for inference server
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Server/InferenceClient.h"
+#include "src/Server/InferenceScheduler.h"
+#include "src/Server/InferenceServer.h"
+
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#ifndef _WIN32
+
+class InferenceServerTests : public ::testing::Test
+{
+	public:
+
+		InferenceServerTests()
+		: socketPath("/tmp/typecnn_test_" + std::to_string(getpid()) + ".sock")
+		{
+			auto layer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 2, 1, 1 }, true);
+			layer->setNeuronWeights(Image<WeightType>({ {
+				{ -3.0f, -2.0f, -1.0f, 0.0f },
+				{  1.0f,  2.0f,  3.0f, 4.0f }
+				} }));
+
+			cnn.addLayer(layer);
+			cnn.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 2, 1, 1 }));
+		}
+
+	protected:
+
+		ConvolutionalNeuralNetwork cnn;
+
+		std::string socketPath;
+};
+
+TEST_F(InferenceServerTests, ConcurrentClientsGetSameOutputsAsDirectRun)
+{
+	InferenceServer server(cnn, socketPath, 2);
+	server.start();
+
+	auto mismatchNum = 0u;
+	std::vector<std::thread> clients;
+	std::mutex mismatchMutex;
+	for (auto c = 0; c < 4; c++)
+	{
+		clients.emplace_back([this, c, &mismatchNum, &mismatchMutex]()
+		{
+			InferenceClient client(socketPath);
+			auto context = cnn.createExecutionContext();
+			for (auto i = 0; i < 50; i++)
+			{
+				Image<ForwardType> input(std::vector<ForwardType>{ static_cast<float>(i), static_cast<float>(c), -1.0f });
+				auto output = client.infer(input);
+
+				Image<ForwardType> expected;
+				expected = cnn.run(context, input);
+				if (!(output == expected))
+				{
+					std::lock_guard<std::mutex> lock(mismatchMutex);
+					mismatchNum++;
+				}
+			}
+		});
+	}
+
+	for (auto & client : clients)
+	{
+		client.join();
+	}
+	server.stop();
+
+	EXPECT_EQ(0u, mismatchNum);
+	EXPECT_EQ(200u, server.getServedRequestNum());
+}
+
+TEST_F(InferenceServerTests, InvalidInputIsReportedAndConnectionStaysOpen)
+{
+	InferenceServer server(cnn, socketPath, 1);
+	server.start();
+
+	InferenceClient client(socketPath);
+	EXPECT_THROW(client.infer(Image<ForwardType>(Dimensions{ 5, 1, 1 })), ServerException);
+	EXPECT_THROW(client.inferPng({ 1, 2, 3 }), ServerException);
+
+	Image<ForwardType> expected(std::vector<std::vector<std::vector<ForwardType>>>{ {
+		{ 0.0f, 18.0f }
+		} });
+	auto output = client.infer(Image<ForwardType>(std::vector<ForwardType>{ 1.0f, 2.0f, 3.0f }));
+
+	EXPECT_TRUE(expected == output);
+}
+
+TEST_F(InferenceServerTests, SchedulerCoalescesConcurrentRequests)
+{
+	InferenceScheduler scheduler(cnn, 8, 20000);
+
+	// All requests are submitted well within delay, so they have to be batched
+	std::vector<std::future<Image<ForwardType>>> futures;
+	for (auto i = 0; i < 32; i++)
+	{
+		futures.push_back(scheduler.submit(Image<ForwardType>(std::vector<ForwardType>{ static_cast<float>(i), 1.0f, -1.0f })));
+	}
+
+	auto context = cnn.createExecutionContext();
+	for (auto i = 0; i < 32; i++)
+	{
+		auto output = futures[i].get();
+		Image<ForwardType> expected;
+		expected = cnn.run(context, Image<ForwardType>(std::vector<ForwardType>{ static_cast<float>(i), 1.0f, -1.0f }));
+
+		EXPECT_TRUE(expected == output);
+	}
+
+	auto statistics = scheduler.getStatistics();
+	EXPECT_EQ(32u, statistics.completedRequestNum);
+	EXPECT_EQ(4u, statistics.batchNum);
+	EXPECT_EQ(0u, statistics.queueDepth);
+	EXPECT_LE(statistics.p50Latency, statistics.p99Latency);
+
+	EXPECT_THROW(scheduler.submit(Image<ForwardType>(Dimensions{ 5, 1, 1 })).get(), CNNException);
+}
+
+TEST_F(InferenceServerTests, BatchingServerGivesSameOutputsAsDirectRun)
+{
+	InferenceServer server(cnn, socketPath, 4);
+	server.enableBatching(4, 1000);
+	server.start();
+
+	std::vector<std::thread> clients;
+	std::vector<unsigned> mismatchNums(4, 0);
+	for (auto c = 0; c < 4; c++)
+	{
+		clients.emplace_back([this, c, &mismatchNums]()
+		{
+			InferenceClient client(socketPath);
+			auto context = cnn.createExecutionContext();
+			for (auto i = 0; i < 20; i++)
+			{
+				Image<ForwardType> input(std::vector<ForwardType>{ static_cast<float>(c), static_cast<float>(i), 2.0f });
+				auto output = client.infer(input);
+
+				Image<ForwardType> expected;
+				expected = cnn.run(context, input);
+				mismatchNums[c] += (output == expected) ? 0 : 1;
+			}
+		});
+	}
+
+	for (auto & client : clients)
+	{
+		client.join();
+	}
+	server.stop();
+
+	EXPECT_EQ(std::vector<unsigned>(4, 0), mismatchNums);
+	EXPECT_EQ(80u, server.getScheduler()->getStatistics().completedRequestNum);
+}
+
+#endif
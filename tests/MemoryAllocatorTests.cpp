@@ -0,0 +1,69 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for allocator of image buffers
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/Utils/MemoryAllocator.h"
+
+#include <cstdint>
+
+TEST(MemoryAllocatorTests, ThresholdIsAtLeastHugePage)
+{
+	MemoryAllocator::enableHugePages(0);
+	EXPECT_FALSE(MemoryAllocator::useHugePages(1));
+	EXPECT_FALSE(MemoryAllocator::useHugePages(MemoryAllocator::HUGE_PAGE_SIZE - 1));
+	EXPECT_TRUE(MemoryAllocator::useHugePages(MemoryAllocator::HUGE_PAGE_SIZE));
+
+	MemoryAllocator::enableHugePages(3 * MemoryAllocator::HUGE_PAGE_SIZE);
+	EXPECT_FALSE(MemoryAllocator::useHugePages(2 * MemoryAllocator::HUGE_PAGE_SIZE));
+	EXPECT_TRUE(MemoryAllocator::useHugePages(3 * MemoryAllocator::HUGE_PAGE_SIZE));
+
+	MemoryAllocator::disableHugePages();
+	EXPECT_FALSE(MemoryAllocator::useHugePages(3 * MemoryAllocator::HUGE_PAGE_SIZE));
+}
+
+TEST(MemoryAllocatorTests, LargeBuffersAreAlignedToHugePage)
+{
+	MemoryAllocator::enableHugePages(MemoryAllocator::HUGE_PAGE_SIZE);
+	const auto before = MemoryAllocator::getStatistics();
+
+	// Slightly more than one huge page is rounded up to two
+	const auto count = static_cast<unsigned>(MemoryAllocator::HUGE_PAGE_SIZE / sizeof(float)) + 1;
+	auto buffer = MemoryAllocator::allocate<float>(count);
+	buffer.get()[count - 1] = 1.0f;
+
+	// Small buffers do not waste huge page
+	auto small = MemoryAllocator::allocate<float>(16);
+
+	const auto after = MemoryAllocator::getStatistics();
+	MemoryAllocator::disableHugePages();
+
+#ifdef __linux__
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buffer.get()) % MemoryAllocator::HUGE_PAGE_SIZE);
+#endif
+	EXPECT_EQ(before.hugePageAllocations + 1, after.hugePageAllocations);
+	EXPECT_EQ(before.hugePageBytes + 2 * MemoryAllocator::HUGE_PAGE_SIZE, after.hugePageBytes);
+}
+
+TEST(MemoryAllocatorTests, ImagesInHugePagesWorkLikeOrdinaryImages)
+{
+	MemoryAllocator::enableHugePages(MemoryAllocator::HUGE_PAGE_SIZE);
+	Image<float> large(Dimensions{ 512, 512, 3 });
+	MemoryAllocator::disableHugePages();
+	Image<float> ordinary(Dimensions{ 512, 512, 3 });
+
+#ifdef __linux__
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&large(0)) % MemoryAllocator::HUGE_PAGE_SIZE);
+#endif
+
+	for (auto i = 0u; i < large.getFlattenedSize(); i++)
+	{
+		large(i) = static_cast<float>(i % 251);
+		ordinary(i) = static_cast<float>(i % 251);
+	}
+	EXPECT_TRUE(large == ordinary);
+}
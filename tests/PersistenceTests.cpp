@@ -0,0 +1,73 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for saving and loading of networks
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/ConvolutionalLayer.h"
+#include "src/Layers/BatchNormalizationLayer.h"
+#include "src/Layers/ReluActivationLayer.h"
+#include "src/Layers/MaxPoolingLayer.h"
+#include "src/Layers/FullyConnectedLayer.h"
+#include "src/Layers/SoftmaxActivationLayer.h"
+#include "src/Utils/Persistence.h"
+
+#include <cstdlib>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+
+TEST(PersistenceTests, NetworkLoadedForInferenceOnlyHasNoTrainingState)
+{
+	srand(5);
+	ConvolutionalNeuralNetwork original;
+	original.addLayer(std::make_shared<ConvolutionalLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 1 }, 1, 2, 3, 1, true));
+	original.addLayer(std::make_shared<BatchNormalizationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }));
+	original.addLayer(std::make_shared<ReluActivationLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }));
+	original.addLayer(std::make_shared<MaxPoolingLayer<ForwardType, WeightType>>(Dimensions{ 8, 8, 2 }, 2, 2));
+	original.addLayer(std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 4, 4, 2 }, Dimensions{ 3, 1, 1 }));
+	original.addLayer(std::make_shared<SoftmaxActivationLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }));
+
+	// Weights are dumped next to network
+	const auto directory = "/tmp/typecnn_persistence_" + std::to_string(getpid());
+	const auto path = directory + "/network.xml";
+	ASSERT_EQ(0, mkdir(directory.c_str(), 0700));
+	Persistence().dumpNetwork(original, path);
+
+	auto trainable = Persistence().loadNetwork(path, true);
+	auto inference = Persistence().loadNetwork(path, true, true);
+	std::system(("rm -rf " + directory).c_str());
+
+	EXPECT_FALSE(trainable.isInferenceOnly());
+	for (auto & layer : trainable)
+	{
+		EXPECT_TRUE(layer->hasTrainingState());
+	}
+
+	EXPECT_TRUE(inference.isInferenceOnly());
+	for (auto & layer : inference)
+	{
+		EXPECT_FALSE(layer->hasTrainingState());
+	}
+
+	Image<ForwardType> input(Dimensions{ 8, 8, 1 });
+	for (auto i = 0u; i < input.getFlattenedSize(); i++)
+	{
+		input(i) = static_cast<ForwardType>(static_cast<float>(i % 11) / 5.0f - 1.0f);
+	}
+
+	// Batch normalization is folded into convolution of inference network
+	auto expected = trainable.run(input);
+	auto output = inference.run(input);
+	for (auto i = 0u; i < expected.getFlattenedSize(); i++)
+	{
+		EXPECT_NEAR(static_cast<float>(expected(i)), static_cast<float>(output(i)), 1e-5f);
+	}
+}
+#endif
@@ -9,6 +9,7 @@
 #include "src/Image.h"
 #include "src/Layers/MaxPoolingLayer.h"
 #include "src/Layers/AvgPoolingLayer.h"
+#include "src/Layers/GlobalAvgPoolingLayer.h"
 
 TEST(PoolingLayerTest, MaxWorksCorrectlyOnSimpleImage)
 {
@@ -92,6 +93,75 @@ TEST(PoolingLayerTest, BackpropagationOnMaxWorksCorrectlyOn3DImage)
 }
 
 
+TEST(PoolingLayerTest, BackpropagationOnMaxAssignsTiesOnlyOnce)
+{
+	std::vector<std::vector<std::vector<ForwardType>>> input =
+	{ { { 7, 2, 0, 0 },
+		{ 7, 7, 0, 0 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> error =
+	{ { { 3, 5 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> expectedError =
+	{ { { 3, 0, 5, 0 },
+		{ 0, 0, 0, 0 }
+	} };
+
+	auto in = Image<ForwardType>(input);
+	auto err = Image<BackwardType>(error);
+
+	MaxPoolingLayer<ForwardType, WeightType> poolingLayer(in.getDimensions(), 2, 2);
+	EXPECT_FALSE(poolingLayer.needsOutputForBackward());
+
+	poolingLayer.forwardPropagation(in, poolingLayer.getOutput());
+
+	// Output is not read during backward propagation anymore
+	Image<ForwardType> emptyOutput;
+	poolingLayer.backwardPropagation(in, emptyOutput, err, poolingLayer.getGradientOutput(), TrainingSettings{});
+
+	EXPECT_TRUE(Image<BackwardType>(expectedError) == poolingLayer.getGradientOutput());
+}
+
+TEST(PoolingLayerTest, InferenceDoesNotOverwritePositionsOfMaxima)
+{
+	std::vector<std::vector<std::vector<ForwardType>>> input =
+	{ { { 1, 9 },
+		{ 3, 4 }
+	} };
+
+	std::vector<std::vector<std::vector<ForwardType>>> otherInput =
+	{ { { 8, 2 },
+		{ 3, 4 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> error =
+	{ { { 5 }
+	} };
+
+	std::vector<std::vector<std::vector<BackwardType>>> expectedError =
+	{ { { 0, 5 },
+		{ 0, 0 }
+	} };
+
+	auto in = Image<ForwardType>(input);
+	auto err = Image<BackwardType>(error);
+
+	MaxPoolingLayer<ForwardType, WeightType> poolingLayer(in.getDimensions(), 2, 2);
+	poolingLayer.forwardPropagation(in, poolingLayer.getOutput());
+
+	// Inference writes only into given output, state used for back propagation is untouched
+	Image<ForwardType> inferenceOutput(poolingLayer.getOutputSize());
+	poolingLayer.inferencePropagation(Image<ForwardType>(otherInput), inferenceOutput);
+	EXPECT_EQ(static_cast<ForwardType>(8), inferenceOutput(0));
+	EXPECT_EQ(static_cast<ForwardType>(9), poolingLayer.getOutput()(0));
+
+	poolingLayer.backwardPropagation(in, poolingLayer.getOutput(), err, poolingLayer.getGradientOutput(), TrainingSettings{});
+
+	EXPECT_TRUE(Image<BackwardType>(expectedError) == poolingLayer.getGradientOutput());
+}
+
 TEST(PoolingLayerTest, AvgWorksCorrectlyOnSimpleImage)
 {
 	std::vector<std::vector<std::vector<ForwardType>>> input =
@@ -144,3 +214,217 @@ TEST(PoolingLayerTest, ThrowsWhenExtentCannotBeApplied)
 
 	EXPECT_THROW((AvgPoolingLayer<ForwardType, WeightType>(img.getDimensions(), 3, 6)), PoolingLayerException);
 }
+
+TEST(PoolingLayerTest, GlobalAvgAveragesEachChannel)
+{
+	std::vector<std::vector<std::vector<ForwardType>>> input =
+	{ { { 1, 2, 3 },
+		{ 4, 5, 6 },
+		{ 7, 8, 9 }
+	  },
+	  { { -4, 0, 2 },
+		{ 0, 1, 0 },
+		{ 8, -1, 3 }
+	} };
+
+	auto img = Image<ForwardType>(input);
+
+	GlobalAvgPoolingLayer<ForwardType, WeightType> poolingLayer(img.getDimensions());
+	poolingLayer.forwardPropagation(img, poolingLayer.getOutput());
+
+	EXPECT_EQ(1u, poolingLayer.getOutputSize().width);
+	EXPECT_EQ(1u, poolingLayer.getOutputSize().height);
+	EXPECT_EQ(2u, poolingLayer.getOutputSize().depth);
+	EXPECT_NEAR(5.0f, static_cast<float>(poolingLayer.getOutput()(0)), 1e-4f);
+	EXPECT_NEAR(1.0f, static_cast<float>(poolingLayer.getOutput()(1)), 1e-4f);
+}
+
+TEST(PoolingLayerTest, GlobalAvgSplitsGradientEvenly)
+{
+	GlobalAvgPoolingLayer<ForwardType, WeightType> poolingLayer(Dimensions{ 2, 2, 2 });
+
+	Image<ForwardType> img(Dimensions{ 2, 2, 2 });
+	Image<BackwardType> gradients(std::vector<BackwardType>{ 4.0f, -2.0f });
+	poolingLayer.backwardPropagation(img, poolingLayer.getOutput(), gradients, poolingLayer.getGradientOutput(), TrainingSettings());
+
+	for (auto i = 0u; i < 4; i++)
+	{
+		EXPECT_FLOAT_EQ(1.0f, static_cast<float>(poolingLayer.getGradientOutput()(i)));
+		EXPECT_FLOAT_EQ(-0.5f, static_cast<float>(poolingLayer.getGradientOutput()(i + 4)));
+	}
+}
+
+TEST(PoolingLayerTest, SeparableMaxMatchesWindowScan)
+{
+	Image<ForwardType> img(Dimensions{ 11, 11, 2 });
+	for (auto i = 0u; i < img.getFlattenedSize(); i++)
+	{
+		// Values repeat, so first maximum of window must be selected in case of ties
+		img(i) = static_cast<ForwardType>(static_cast<float>((i * 37) % 23));
+	}
+
+	for (auto parameters : std::vector<std::pair<unsigned, unsigned>>{ { 5, 1 }, { 5, 2 }, { 7, 4 } })
+	{
+		const auto extent = parameters.first;
+		const auto stride = parameters.second;
+		MaxPoolingLayer<ForwardType, WeightType> poolingLayer(img.getDimensions(), extent, stride);
+		poolingLayer.forwardPropagation(img, poolingLayer.getOutput());
+
+		const auto & output = poolingLayer.getOutput();
+		Image<BackwardType> gradients(poolingLayer.getOutputSize());
+		for (auto i = 0u; i < gradients.getFlattenedSize(); i++)
+		{
+			gradients(i) = static_cast<BackwardType>(static_cast<float>(i + 1));
+		}
+		poolingLayer.backwardPropagation(img, output, gradients, poolingLayer.getGradientOutput(), TrainingSettings());
+
+		Image<BackwardType> expectedGradients(img.getDimensions());
+		expectedGradients.clear();
+		for (auto z = 0u; z < output.getDepth(); z++)
+		{
+			for (auto y = 0u; y < output.getHeight(); y++)
+			{
+				for (auto x = 0u; x < output.getWidth(); x++)
+				{
+					auto maxX = x * stride;
+					auto maxY = y * stride;
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							if (img(x * stride + a, y * stride + b, z) > img(maxX, maxY, z))
+							{
+								maxX = x * stride + a;
+								maxY = y * stride + b;
+							}
+						}
+					}
+
+					EXPECT_EQ(static_cast<float>(img(maxX, maxY, z)), static_cast<float>(output(x, y, z)));
+					expectedGradients(maxX, maxY, z) += gradients(x, y, z);
+				}
+			}
+		}
+
+		for (auto i = 0u; i < expectedGradients.getFlattenedSize(); i++)
+		{
+			EXPECT_EQ(static_cast<float>(expectedGradients(i)), static_cast<float>(poolingLayer.getGradientOutput()(i)));
+		}
+	}
+}
+
+TEST(PoolingLayerTest, AvgMatchesWindowSumsForOverlappingAndSparseWindows)
+{
+	Image<ForwardType> img(Dimensions{ 9, 15, 2 });
+	for (auto i = 0u; i < img.getFlattenedSize(); i++)
+	{
+		img(i) = static_cast<ForwardType>(static_cast<float>((i * 37) % 23) / 4.0f);
+	}
+
+	// Stride larger than extent leaves cells outside of all windows
+	for (auto parameters : std::vector<std::pair<unsigned, unsigned>>{ { 5, 1 }, { 3, 2 }, { 1, 2 }, { 3, 3 } })
+	{
+		const auto extent = parameters.first;
+		const auto stride = parameters.second;
+		AvgPoolingLayer<ForwardType, WeightType> poolingLayer(img.getDimensions(), extent, stride);
+		poolingLayer.forwardPropagation(img, poolingLayer.getOutput());
+
+		const auto & output = poolingLayer.getOutput();
+		Image<BackwardType> gradients(poolingLayer.getOutputSize());
+		for (auto i = 0u; i < gradients.getFlattenedSize(); i++)
+		{
+			gradients(i) = static_cast<BackwardType>(static_cast<float>(i % 7) - 3.0f);
+		}
+		poolingLayer.backwardPropagation(img, output, gradients, poolingLayer.getGradientOutput(), TrainingSettings());
+
+		Image<BackwardType> expectedGradients(img.getDimensions());
+		expectedGradients.clear();
+		const auto windowSize = static_cast<float>(extent * extent);
+		for (auto z = 0u; z < output.getDepth(); z++)
+		{
+			for (auto y = 0u; y < output.getHeight(); y++)
+			{
+				for (auto x = 0u; x < output.getWidth(); x++)
+				{
+					auto sum = 0.0f;
+					for (auto b = 0u; b < extent; b++)
+					{
+						for (auto a = 0u; a < extent; a++)
+						{
+							sum += static_cast<float>(img(x * stride + a, y * stride + b, z));
+							expectedGradients(x * stride + a, y * stride + b, z) += gradients(x, y, z) / windowSize;
+						}
+					}
+
+					EXPECT_NEAR(sum / windowSize, static_cast<float>(output(x, y, z)), 1e-4f);
+				}
+			}
+		}
+
+		for (auto i = 0u; i < expectedGradients.getFlattenedSize(); i++)
+		{
+			EXPECT_NEAR(static_cast<float>(expectedGradients(i)), static_cast<float>(poolingLayer.getGradientOutput()(i)), 1e-5f);
+		}
+	}
+}
+
+TEST(PoolingLayerTest, HalvingKernelsMatchWindowScan)
+{
+	Image<ForwardType> img(Dimensions{ 8, 6, 3 });
+	for (auto i = 0u; i < img.getFlattenedSize(); i++)
+	{
+		img(i) = static_cast<ForwardType>(static_cast<float>((i * 37) % 7));
+	}
+
+	MaxPoolingLayer<ForwardType, WeightType> maxLayer(img.getDimensions(), 2, 2);
+	AvgPoolingLayer<ForwardType, WeightType> avgLayer(img.getDimensions(), 2, 2);
+	maxLayer.forwardPropagation(img, maxLayer.getOutput());
+	avgLayer.forwardPropagation(img, avgLayer.getOutput());
+
+	Image<BackwardType> gradients(maxLayer.getOutputSize());
+	for (auto i = 0u; i < gradients.getFlattenedSize(); i++)
+	{
+		gradients(i) = static_cast<BackwardType>(static_cast<float>(i + 1));
+	}
+	maxLayer.backwardPropagation(img, maxLayer.getOutput(), gradients, maxLayer.getGradientOutput(), TrainingSettings());
+	avgLayer.backwardPropagation(img, avgLayer.getOutput(), gradients, avgLayer.getGradientOutput(), TrainingSettings());
+
+	for (auto z = 0u; z < 3; z++)
+	{
+		for (auto y = 0u; y < 3; y++)
+		{
+			for (auto x = 0u; x < 4; x++)
+			{
+				// Ties are frequent, gradient belongs to first maximum in window
+				auto maxX = 2 * x;
+				auto maxY = 2 * y;
+				auto sum = 0.0f;
+				for (auto b = 0u; b < 2; b++)
+				{
+					for (auto a = 0u; a < 2; a++)
+					{
+						sum += static_cast<float>(img(2 * x + a, 2 * y + b, z));
+						if (img(2 * x + a, 2 * y + b, z) > img(maxX, maxY, z))
+						{
+							maxX = 2 * x + a;
+							maxY = 2 * y + b;
+						}
+
+						EXPECT_FLOAT_EQ(static_cast<float>(gradients(x, y, z)) / 4.0f, static_cast<float>(avgLayer.getGradientOutput()(2 * x + a, 2 * y + b, z)));
+					}
+				}
+
+				EXPECT_EQ(static_cast<float>(img(maxX, maxY, z)), static_cast<float>(maxLayer.getOutput()(x, y, z)));
+				EXPECT_NEAR(sum / 4.0f, static_cast<float>(avgLayer.getOutput()(x, y, z)), 1e-4f);
+				for (auto b = 0u; b < 2; b++)
+				{
+					for (auto a = 0u; a < 2; a++)
+					{
+						auto expected = (2 * x + a == maxX && 2 * y + b == maxY) ? static_cast<float>(gradients(x, y, z)) : 0.0f;
+						EXPECT_EQ(expected, static_cast<float>(maxLayer.getGradientOutput()(2 * x + a, 2 * y + b, z)));
+					}
+				}
+			}
+		}
+	}
+}
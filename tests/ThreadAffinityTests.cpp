@@ -0,0 +1,46 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for pinning of threads to cores
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Utils/ThreadAffinity.h"
+
+#include <vector>
+
+TEST(ThreadAffinityTests, ParsesCoresAndRanges)
+{
+	EXPECT_EQ(std::vector<unsigned>({ 3 }), ThreadAffinity::parseAffinityMap("3"));
+	EXPECT_EQ(std::vector<unsigned>({ 0, 2, 4, 5, 6, 7 }), ThreadAffinity::parseAffinityMap("0,2,4-7"));
+	EXPECT_EQ(std::vector<unsigned>({ 1, 1 }), ThreadAffinity::parseAffinityMap("1-1,1"));
+}
+
+TEST(ThreadAffinityTests, RejectsMalformedMaps)
+{
+	for (auto description : { "", "a", "1,,2", "1;2", "2x", "-1", "1-", "5-3", "1-2-3" })
+	{
+		EXPECT_THROW(ThreadAffinity::parseAffinityMap(description), InvalidAffinityMap) << description;
+	}
+}
+
+TEST(ThreadAffinityTests, RejectsCoresBeyondCpuSet)
+{
+	EXPECT_NO_THROW(ThreadAffinity::parseAffinityMap("1023"));
+	EXPECT_THROW(ThreadAffinity::parseAffinityMap("1024"), InvalidAffinityMap);
+	EXPECT_THROW(ThreadAffinity::parseAffinityMap("0-1024"), InvalidAffinityMap);
+	EXPECT_THROW(ThreadAffinity::parseAffinityMap("4294967296"), InvalidAffinityMap);
+	EXPECT_THROW(ThreadAffinity::parseAffinityMap("99999999999999999999999"), InvalidAffinityMap);
+}
+
+TEST(ThreadAffinityTests, ThreadsAreNotPinnedWithoutValidCore)
+{
+	ThreadAffinity::setAffinityMap({});
+	EXPECT_FALSE(ThreadAffinity::pinCurrentThread(0));
+
+	ThreadAffinity::setAffinityMap({ 1u << 20 });
+	EXPECT_FALSE(ThreadAffinity::pinCurrentThread(0));
+
+	ThreadAffinity::setAffinityMap({});
+}
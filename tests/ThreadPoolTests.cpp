@@ -0,0 +1,92 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for work-stealing thread pool
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Utils/ThreadPool.h"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTests, ParallelForVisitsEachIndexOnce)
+{
+	ThreadPool pool(4);
+	std::vector<std::atomic<int>> visits(1000);
+	for (auto & visit : visits)
+	{
+		visit = 0;
+	}
+
+	pool.parallelFor(0, visits.size(), 7, [&visits](size_t first, size_t last)
+	{
+		for (auto i = first; i < last; i++)
+		{
+			visits[i]++;
+		}
+	});
+
+	for (const auto & visit : visits)
+	{
+		EXPECT_EQ(1, visit);
+	}
+}
+
+TEST(ThreadPoolTests, NestedParallelForDoesNotDeadlock)
+{
+	ThreadPool pool(2);
+	std::atomic<size_t> sum(0);
+
+	pool.parallelFor(0, 16, 1, [&pool, &sum](size_t first, size_t last)
+	{
+		for (auto i = first; i < last; i++)
+		{
+			pool.parallelFor(0, 100, 1, [&sum](size_t innerFirst, size_t innerLast)
+			{
+				sum += innerLast - innerFirst;
+			});
+		}
+	});
+
+	EXPECT_EQ(1600u, sum);
+}
+
+TEST(ThreadPoolTests, TasksMayWaitForNestedParallelFor)
+{
+	ThreadPool pool(2);
+	std::vector<std::future<size_t>> results;
+
+	for (auto t = 0; t < 8; t++)
+	{
+		auto result = std::make_shared<std::promise<size_t>>();
+		results.push_back(result->get_future());
+		pool.enqueue([&pool, result]()
+		{
+			std::atomic<size_t> count(0);
+			pool.parallelFor(0, 64, 4, [&count](size_t first, size_t last) { count += last - first; });
+			result->set_value(count);
+		});
+	}
+
+	for (auto & result : results)
+	{
+		EXPECT_EQ(64u, result.get());
+	}
+}
+
+TEST(ThreadPoolTests, ParallelForRethrowsException)
+{
+	ThreadPool pool(3);
+
+	EXPECT_THROW(pool.parallelFor(0, 100, 1, [](size_t first, size_t last)
+	{
+		if (first <= 42 && 42 < last)
+		{
+			throw std::runtime_error("failed");
+		}
+	}), std::runtime_error);
+}
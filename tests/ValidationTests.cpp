@@ -0,0 +1,96 @@
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for validation of network
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Image.h"
+#include "src/ConvolutionalNeuralNetwork.h"
+#include "src/Layers/FullyConnectedLayer.h"
+
+#include <utility>
+#include <vector>
+
+class ValidationTests : public ::testing::Test
+{
+	public:
+
+		ValidationTests()
+			: classificationCnn(TaskType::Classification)
+			, regressionCnn(TaskType::Regression)
+		{
+			// Output equals input
+			Image<WeightType> identity({ {
+				{ 1.0f, 0.0f, 0.0f, 0.0f },
+				{ 0.0f, 1.0f, 0.0f, 0.0f },
+				{ 0.0f, 0.0f, 1.0f, 0.0f }
+				} });
+
+			auto classificationLayer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 3, 1, 1 }, true);
+			classificationLayer->setNeuronWeights(identity);
+			classificationCnn.addLayer(classificationLayer);
+
+			auto regressionLayer = std::make_shared<FullyConnectedLayer<ForwardType, WeightType>>(Dimensions{ 3, 1, 1 }, Dimensions{ 3, 1, 1 }, true);
+			regressionLayer->setNeuronWeights(identity);
+			regressionCnn.addLayer(regressionLayer);
+		}
+
+	protected:
+
+		static std::pair<Image<ForwardType>, Image<ForwardType>> sample(const std::vector<ForwardType> & input, const std::vector<ForwardType> & expected)
+		{
+			return std::make_pair(Image<ForwardType>(input), Image<ForwardType>(expected));
+		}
+
+	protected:
+
+		ConvolutionalNeuralNetwork classificationCnn;
+
+		ConvolutionalNeuralNetwork regressionCnn;
+};
+
+TEST_F(ValidationTests, ClassificationComputesTopKAndConfusionMatrix)
+{
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	for (auto i = 0; i < 100; i++)
+	{
+		data.push_back(sample({ 3.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f })); // predicted 0, expected 0
+		data.push_back(sample({ 1.0f, 3.0f, 2.0f }, { 0.0f, 0.0f, 1.0f })); // predicted 1, expected 2 (second)
+		data.push_back(sample({ 0.0f, 1.0f, 2.0f }, { 1.0f, 0.0f, 0.0f })); // predicted 2, expected 0 (third)
+		data.push_back(sample({ 2.0f, 2.0f, 1.0f }, { 0.0f, 1.0f, 0.0f })); // tie is predicted as 0, expected 1 (second)
+	}
+
+	classificationCnn.setValidationMetrics(2, true);
+	auto accuracy = classificationCnn.validate(data);
+	auto statistics = classificationCnn.getValidationStatistics();
+
+	EXPECT_FLOAT_EQ(25.0f, accuracy);
+	EXPECT_EQ(400u, statistics.sampleNum);
+	EXPECT_EQ(100u, statistics.correctNum);
+	EXPECT_EQ(2u, statistics.topK);
+	EXPECT_EQ(300u, statistics.topKCorrectNum);
+	EXPECT_EQ(3u, statistics.classNum);
+	EXPECT_EQ(std::vector<unsigned>({ 100, 0, 100, 100, 0, 0, 0, 100, 0 }), statistics.confusionMatrix);
+}
+
+TEST_F(ValidationTests, RegressionErrorIsSummedInOrderOfSamples)
+{
+	std::vector<std::pair<Image<ForwardType>, Image<ForwardType>>> data;
+	auto expectedError = 0.0f;
+	for (auto i = 0; i < 257; i++)
+	{
+		auto value = static_cast<float>(i % 13) + 1.0f;
+		data.push_back(sample({ value, 2.0f * value, 0.5f }, { value + 0.25f, value, 1.0f }));
+
+		// Relative errors of single sample summed the same way as in validation
+		auto sampleError = 0.0f;
+		sampleError += static_cast<float>(0.25f / (value + 0.25f));
+		sampleError += static_cast<float>(value / (2.0f * value));
+		sampleError += static_cast<float>(0.5f / 1.0f);
+		expectedError += sampleError / 3;
+	}
+
+	EXPECT_EQ(expectedError / data.size(), regressionCnn.validate(data));
+}
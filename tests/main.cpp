@@ -1,16 +1,22 @@
-/*
- * @author Petr Rek
- * @project CNN Library
- * @brief Unit tests for CNN Library project
- */
-
-#include <gtest/gtest.h>
-
-/*
- * @brief Unit tests for various part of library
- */
-int main(int argc, char **argv)
-{
-	::testing::InitGoogleTest(&argc, argv);
-	return RUN_ALL_TESTS();
+/*
+ * @author Petr Rek
+ * @project CNN Library
+ * @brief Unit tests for CNN Library project
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/Utils/ThreadPool.h"
+
+/*
+ * @brief Unit tests for various part of library
+ */
+int main(int argc, char **argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+
+	// Parallel parts of library are exercised even on machines with a single core
+	ThreadPool::setSharedThreadNum(4);
+
+	return RUN_ALL_TESTS();
 }
\ No newline at end of file